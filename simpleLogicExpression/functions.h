@@ -5,10 +5,28 @@
 
 #pragma once
 #include <string>
+#include <string_view>
 #include <vector>
 #include <set>
 #include "objects.h"
 
+/**
+ * @brief Разбирает аргументы командной строки.
+ *
+ * Заполняет параметры запуска программы по аргументам командной строки.
+ * Поддерживаемые формы: "<input file> <output file>", "--batch <input file> <output file>" и "--pipe".
+ * В пакетном режиме вместо имени файла можно указать "-" (стандартный ввод или вывод); "--pipe" равносилен "--batch - -".
+ * Ключ "--threads N" задает количество потоков пакетной обработки или преобразования одного выражения
+ * (0 — по числу аппаратных потоков). Ключ "--infix" включает разбор выражений в инфиксной записи.
+ * Ключ "--engine tree|flat|dag|edge" выбирает представление дерева для преобразований,
+ * ключ "--rewrite rounds|nnf|fused" — способ переноса отрицаний.
+ * @param [in] argc Количество аргументов командной строки.
+ * @param [in] argv Массив строк аргументов.
+ * @param [out] options Параметры запуска программы.
+ * @return true, если аргументы корректны, иначе false.
+ */
+bool parseArguments(int argc, char* argv[], ProgramOptions& options);
+
 /**
  * @brief Читает содержимое файла в строку.
  *
@@ -34,11 +52,30 @@ void writeFile(const std::string& filePath, const std::string& content);
  *
  * Преобразует входную строку с логическим выражением в постфиксной записи в вектор токенов.
  * Проверяет корректность токенов и добавляет ошибки в errorList при их обнаружении.
+ * Имена переменных интернируются в таблице символов: токены хранят только их идентификаторы.
+ * Границы токенов находятся по битовым маскам разделителей, которые строятся блоками по 64 байта
+ * ядром, выбранным selectScanKernel.
  * @param [in] expression Строка с логическим выражением в постфиксной записи.
  * @param [in,out] errorList Множество для хранения обнаруженных ошибок.
  * @return Вектор токенов, представляющих входное выражение.
  */
-std::vector<Token> tokenize(const std::string& expression, std::set<Error>& errorList);
+std::vector<Token> tokenize(std::string_view expression, std::set<Error>& errorList);
+
+/**
+ * @brief Выбирает ядро поиска разделителей для токенизатора.
+ *
+ * По умолчанию при запуске выбирается наиболее быстрое ядро, поддерживаемое процессором. Тот же набор
+ * инструкций используется для операций над битовыми векторами таблиц истинности и проверки равносильности.
+ * @param [in] kernel Требуемое ядро.
+ * @return true, если ядро поддерживается процессором и выбрано, иначе false.
+ */
+bool selectScanKernel(ScanKernel kernel);
+
+/**
+ * @brief Возвращает текущее ядро поиска разделителей.
+ * @return Ядро, используемое токенизатором.
+ */
+ScanKernel activeScanKernel();
 
 /**
  * @brief Строит дерево выражения из вектора токенов.
@@ -51,6 +88,84 @@ std::vector<Token> tokenize(const std::string& expression, std::set<Error>& erro
  */
 ExpressionNode* buildExpressionTree(const std::vector<Token>& tokens, std::set<Error>& errorList);
 
+/**
+ * @brief Строит дерево выражения из постфиксной записи без вектора токенов.
+ *
+ * Выделяет токены так же, как tokenize, и сразу строит дерево на стеке операндов, не создавая объектов Token.
+ * Сообщает те же ошибки с теми же позициями, что tokenize и последующий buildExpressionTree.
+ * @param [in] expression Строка с логическим выражением в постфиксной записи.
+ * @param [in,out] errorList Множество для хранения обнаруженных ошибок.
+ * @return Указатель на корень построенного дерева или nullptr при ошибке.
+ */
+ExpressionNode* parsePostfixExpression(std::string_view expression, std::set<Error>& errorList);
+
+/**
+ * @brief Строит плоское дерево выражения из постфиксной записи без вектора токенов.
+ * @param [in] expression Строка с логическим выражением в постфиксной записи.
+ * @param [in,out] errorList Множество для хранения обнаруженных ошибок.
+ * @param [in,out] tree Плоское дерево, в которое добавляются узлы.
+ * @return Индекс корня построенного дерева или nullNode при ошибке.
+ */
+NodeIndex parsePostfixExpression(std::string_view expression, std::set<Error>& errorList, FlatExpression& tree);
+
+/**
+ * @brief Строит граф выражения с общими подвыражениями из постфиксной записи без вектора токенов.
+ * @param [in] expression Строка с логическим выражением в постфиксной записи.
+ * @param [in,out] errorList Множество для хранения обнаруженных ошибок.
+ * @param [in,out] dag Граф, в который добавляются узлы.
+ * @return Индекс корня построенного графа или nullNode при ошибке.
+ */
+NodeIndex parsePostfixExpression(std::string_view expression, std::set<Error>& errorList, ExpressionDag& dag);
+
+/**
+ * @brief Строит выражение с отрицаниями на ребрах из постфиксной записи без вектора токенов.
+ * @param [in] expression Строка с логическим выражением в постфиксной записи.
+ * @param [in,out] errorList Множество для хранения обнаруженных ошибок.
+ * @param [in,out] graph Выражение, в которое добавляются узлы.
+ * @return Ребро к корню построенного выражения или nullEdge при ошибке.
+ */
+Edge parsePostfixExpression(std::string_view expression, std::set<Error>& errorList, EdgeExpression& graph);
+
+/**
+ * @brief Строит дерево выражения из инфиксной записи.
+ *
+ * Разбирает строку с операциями !, &, || (или |), -> (или >), ~ и скобками по приоритетам операций,
+ * в которых expressionTreeToInfix выводит результат; бинарные операции левоассоциативны. Дерево строится
+ * при чтении строки, без вектора токенов. Ошибки в именах и операциях совпадают с ошибками tokenize,
+ * позиция в ошибках — порядковый номер лексемы; непарная скобка сообщается ошибкой unbalancedBrackets.
+ * @param [in] expression Строка с логическим выражением в инфиксной записи.
+ * @param [in,out] errorList Множество для хранения обнаруженных ошибок.
+ * @return Указатель на корень построенного дерева или nullptr при ошибке.
+ */
+ExpressionNode* parseInfixExpression(std::string_view expression, std::set<Error>& errorList);
+
+/**
+ * @brief Строит плоское дерево выражения из инфиксной записи.
+ * @param [in] expression Строка с логическим выражением в инфиксной записи.
+ * @param [in,out] errorList Множество для хранения обнаруженных ошибок.
+ * @param [in,out] tree Плоское дерево, в которое добавляются узлы.
+ * @return Индекс корня построенного дерева или nullNode при ошибке.
+ */
+NodeIndex parseInfixExpression(std::string_view expression, std::set<Error>& errorList, FlatExpression& tree);
+
+/**
+ * @brief Строит граф выражения с общими подвыражениями из инфиксной записи.
+ * @param [in] expression Строка с логическим выражением в инфиксной записи.
+ * @param [in,out] errorList Множество для хранения обнаруженных ошибок.
+ * @param [in,out] dag Граф, в который добавляются узлы.
+ * @return Индекс корня построенного графа или nullNode при ошибке.
+ */
+NodeIndex parseInfixExpression(std::string_view expression, std::set<Error>& errorList, ExpressionDag& dag);
+
+/**
+ * @brief Строит выражение с отрицаниями на ребрах из инфиксной записи.
+ * @param [in] expression Строка с логическим выражением в инфиксной записи.
+ * @param [in,out] errorList Множество для хранения обнаруженных ошибок.
+ * @param [in,out] graph Выражение, в которое добавляются узлы.
+ * @return Ребро к корню построенного выражения или nullEdge при ошибке.
+ */
+Edge parseInfixExpression(std::string_view expression, std::set<Error>& errorList, EdgeExpression& graph);
+
 /**
  * @brief Создает глубокую копию узла дерева.
  *
@@ -60,6 +175,15 @@ ExpressionNode* buildExpressionTree(const std::vector<Token>& tokens, std::set<E
  */
 ExpressionNode* copyNode(ExpressionNode* node);
 
+/**
+ * @brief Освобождает дерево выражения.
+ *
+ * Узлы, размещенные в активном пуле, не удаляются по одному: они освобождаются вместе
+ * при сбросе пула его владельцем. Остальные деревья удаляются обычным образом.
+ * @param [in] node Указатель на корень дерева.
+ */
+void releaseExpressionTree(ExpressionNode* node);
+
 /**
  * @brief Преобразует операции импликации и эквивалентности.
  *
@@ -73,7 +197,8 @@ void transformImplicationAndEquivalence(ExpressionNode* node);
  * @brief Применяет законы де Моргана.
  *
  * Преобразует выражения вида !(A & B) в !A | !B и !(A | B) в !A & !B.
- * Рекурсивно обрабатывает поддеревья.
+ * Рекурсивно обрабатывает поддеревья. Узел операции используется как одно из новых
+ * отрицаний, второе берется из запаса потока (см. spareNodeCount) или выделяется.
  * @param [in,out] node Указатель на корень дерева для упрощения.
  * @return true, если были внесены изменения, иначе false.
  */
@@ -83,16 +208,447 @@ bool simplifyExpression(ExpressionNode* node, bool& changed);
  * @brief Удаляет двойные отрицания.
  *
  * Преобразует выражения вида !!A в A, рекурсивно обрабатывая поддеревья.
+ * Удаленные узлы отрицания не освобождаются, а сохраняются в запасе потока.
  * @param [in,out] node Указатель на корень дерева для преобразования.
  */
 void removeDoubleNot(ExpressionNode* node);
 
+/**
+ * @brief Возвращает число узлов в запасе текущего потока.
+ *
+ * Узлы, удаленные из дерева вне пула, сохраняются в запасе и используются законами
+ * де Моргана вместо выделения памяти.
+ * @return Число узлов, доступных для повторного использования.
+ */
+size_t spareNodeCount();
+
+/**
+ * @brief Освобождает запас узлов текущего потока.
+ */
+void releaseSpareNodes();
+
+/**
+ * @brief Создает глубокую копию узла дерева в нескольких потоках.
+ *
+ * Результат совпадает с copyNode(node). Поддеревья меньше порогового размера копируются последовательно.
+ * Если в текущем потоке активен пул узлов, копирование выполняется последовательно.
+ * @param [in] node Указатель на узел для копирования.
+ * @param [in] pool Пул потоков.
+ * @return Указатель на новый узел или nullptr, если входной узел равен nullptr.
+ */
+ExpressionNode* copyNode(ExpressionNode* node, ForkJoinPool& pool);
+
+/**
+ * @brief Преобразует операции импликации и эквивалентности в нескольких потоках.
+ *
+ * Результат совпадает с transformImplicationAndEquivalence(node). Если в текущем потоке активен пул узлов,
+ * преобразование выполняется последовательно.
+ * @param [in,out] node Указатель на корень дерева для преобразования.
+ * @param [in] pool Пул потоков.
+ */
+void transformImplicationAndEquivalence(ExpressionNode* node, ForkJoinPool& pool);
+
+/**
+ * @brief Применяет законы де Моргана в нескольких потоках.
+ *
+ * Результат совпадает с simplifyExpression(node, changed). Если в текущем потоке активен пул узлов,
+ * упрощение выполняется последовательно.
+ * @param [in,out] node Указатель на корень дерева для упрощения.
+ * @param [in,out] changed Устанавливается в true, если были внесены изменения.
+ * @param [in] pool Пул потоков.
+ * @return true, если были внесены изменения, иначе false.
+ */
+bool simplifyExpression(ExpressionNode* node, bool& changed, ForkJoinPool& pool);
+
 /**
  * @brief Преобразует дерево выражения в инфиксную строку.
  *
  * Формирует строковое представление логического выражения в инфиксной нотации,
- * добавляя скобки с учетом приоритетов операций.
+ * добавляя скобки с учетом приоритетов операций. Выполняет один нерекурсивный обход,
+ * дописывая фрагменты в одну строку.
  * @param [in] node Указатель на корень дерева.
  * @return Строковое представление выражения в инфиксной форме.
  */
-std::string expressionTreeToInfix(ExpressionNode* node);
\ No newline at end of file
+std::string expressionTreeToInfix(ExpressionNode* node);
+
+/**
+ * @brief Обрабатывает одно логическое выражение.
+ *
+ * Выполняет полный цикл преобразования выражения в постфиксной или инфиксной записи: разбор, построение дерева,
+ * преобразование импликации и эквивалентности, применение законов де Моргана и удаление двойных отрицаний.
+ * @param [in] expression Строка с логическим выражением в форме записи options.syntax.
+ * @param [out] inputStr Исходное выражение в инфиксной форме.
+ * @param [out] result Преобразованное выражение в инфиксной форме.
+ * @param [in,out] errorList Множество для хранения обнаруженных ошибок.
+ * @param [in] options Параметры обработки: представление дерева (engine), способ переноса отрицаний (rewrite),
+ * форма записи (syntax) и проверка равносильности результата исходному выражению (verify);
+ * при различии добавляется ошибка verificationFailed, если равносильность не доказана — verificationUnproven.
+ * @param [in] pool Пул потоков для преобразований одного дерева (nullptr — в текущем потоке).
+ * @return true, если выражение обработано без ошибок, иначе false.
+ */
+bool processExpression(std::string_view expression, std::string& inputStr, std::string& result, std::set<Error>& errorList, const ProgramOptions& options = ProgramOptions(), ForkJoinPool* pool = nullptr);
+
+/**
+ * @brief Обрабатывает одно логическое выражение с выводом результата прямо в файл.
+ *
+ * Выполняет те же преобразования, что и processExpression со строковым результатом, но выводит выражения
+ * при обходе дерева в буфер выходного файла, не формируя строку результата. При ошибках в файл ничего не выводится.
+ * @param [in] expression Строка с логическим выражением в форме записи options.syntax.
+ * @param [in,out] output Выходной файл.
+ * @param [in] echoInput Выводить перед результатом исходное выражение в инфиксной форме и перевод строки.
+ * @param [in,out] errorList Множество для хранения обнаруженных ошибок.
+ * @param [in] options Параметры обработки: представление дерева (engine), способ переноса отрицаний (rewrite),
+ * форма записи (syntax) и проверка равносильности результата исходному выражению (verify);
+ * при различии добавляется ошибка verificationFailed, если равносильность не доказана — verificationUnproven.
+ * @param [in] pool Пул потоков для преобразований одного дерева (nullptr — в текущем потоке).
+ * @return true, если выражение обработано без ошибок, иначе false.
+ * @throw Error с типом outputFile, если запись в файл не удалась.
+ */
+bool processExpression(std::string_view expression, OutputWriter& output, bool echoInput, std::set<Error>& errorList, const ProgramOptions& options = ProgramOptions(), ForkJoinPool* pool = nullptr);
+
+/**
+ * @brief Обрабатывает все выражения входного файла в пакетном режиме.
+ *
+ * Входной файл отображается в память, и каждая его строка обрабатывается как отдельное выражение
+ * без копирования. В выходной файл для каждой строки
+ * записывается одна строка: преобразованное выражение или описание ошибок этой строки.
+ * Ошибки дополнительно выводятся в консоль с указанием номера строки.
+ * @param [in] options Параметры запуска программы (пути к файлам и представление дерева).
+ * @return true, если все строки обработаны без ошибок, иначе false.
+ * @throw Error с типом inputFile или outputFile, если файл не удалось открыть.
+ */
+bool processBatch(const ProgramOptions& options);
+
+/**
+ * @brief Строит плоское дерево выражения из вектора токенов.
+ *
+ * Работает так же, как buildExpressionTree для узлов ExpressionNode, и сообщает о тех же ошибках.
+ * @param [in] tokens Вектор токенов в постфиксной записи.
+ * @param [in,out] errorList Множество для хранения обнаруженных ошибок.
+ * @param [in,out] tree Плоское дерево, в которое добавляются узлы.
+ * @return Индекс корня построенного дерева или nullNode при ошибке.
+ */
+NodeIndex buildExpressionTree(const std::vector<Token>& tokens, std::set<Error>& errorList, FlatExpression& tree);
+
+/**
+ * @brief Преобразует дерево из узлов ExpressionNode в плоское дерево.
+ * @param [in] node Указатель на корень исходного дерева.
+ * @param [in,out] tree Плоское дерево, в которое добавляются узлы.
+ * @return Индекс корня в плоском дереве или nullNode для пустого дерева.
+ */
+NodeIndex toFlatExpression(const ExpressionNode* node, FlatExpression& tree);
+
+/**
+ * @brief Преобразует плоское дерево в дерево из узлов ExpressionNode.
+ * @param [in] tree Плоское дерево.
+ * @param [in] root Индекс корня.
+ * @return Указатель на корень нового дерева или nullptr для пустого дерева.
+ */
+ExpressionNode* fromFlatExpression(const FlatExpression& tree, NodeIndex root);
+
+/**
+ * @brief Создает глубокую копию поддерева плоского дерева.
+ *
+ * Копия добавляется в конец массивов того же дерева.
+ * @param [in,out] tree Плоское дерево.
+ * @param [in] node Индекс корня копируемого поддерева.
+ * @return Индекс корня копии или nullNode, если входной индекс равен nullNode.
+ */
+NodeIndex copyNode(FlatExpression& tree, NodeIndex node);
+
+/**
+ * @brief Преобразует операции импликации и эквивалентности в плоском дереве.
+ *
+ * Преобразует импликацию (A > B) в (!A | B) и эквивалентность (A ~ B) в ((A & B) | (!A & !B)).
+ * @param [in,out] tree Плоское дерево.
+ * @param [in] root Индекс корня.
+ */
+void transformImplicationAndEquivalence(FlatExpression& tree, NodeIndex root);
+
+/**
+ * @brief Применяет законы де Моргана к плоскому дереву.
+ *
+ * Выполняет один проход, как simplifyExpression для узлов ExpressionNode.
+ * @param [in,out] tree Плоское дерево.
+ * @param [in] root Индекс корня.
+ * @param [in,out] changed Устанавливается в true, если были внесены изменения.
+ * @return true, если были внесены изменения, иначе false.
+ */
+bool simplifyExpression(FlatExpression& tree, NodeIndex root, bool& changed);
+
+/**
+ * @brief Удаляет двойные отрицания в плоском дереве.
+ * @param [in,out] tree Плоское дерево.
+ * @param [in] root Индекс корня.
+ */
+void removeDoubleNot(FlatExpression& tree, NodeIndex root);
+
+/**
+ * @brief Преобразует плоское дерево в инфиксную строку.
+ *
+ * Расставляет скобки по тем же правилам, что и expressionTreeToInfix для узлов ExpressionNode.
+ * @param [in] tree Плоское дерево.
+ * @param [in] root Индекс корня.
+ * @return Строковое представление выражения в инфиксной форме.
+ */
+std::string expressionTreeToInfix(const FlatExpression& tree, NodeIndex root);
+
+/**
+ * @brief Строит граф выражения с общими подвыражениями из вектора токенов.
+ *
+ * Работает так же, как buildExpressionTree для узлов ExpressionNode, и сообщает о тех же ошибках.
+ * @param [in] tokens Вектор токенов в постфиксной записи.
+ * @param [in,out] errorList Множество для хранения обнаруженных ошибок.
+ * @param [in,out] dag Граф, в который добавляются узлы.
+ * @return Индекс корня построенного графа или nullNode при ошибке.
+ */
+NodeIndex buildExpressionTree(const std::vector<Token>& tokens, std::set<Error>& errorList, ExpressionDag& dag);
+
+/**
+ * @brief Преобразует операции импликации и эквивалентности в графе.
+ *
+ * Преобразует импликацию (A > B) в (!A | B) и эквивалентность (A ~ B) в ((A & B) | (!A & !B)).
+ * Операнды эквивалентности не копируются: оба вхождения ссылаются на один узел.
+ * @param [in,out] dag Граф выражения.
+ * @param [in] root Индекс корня.
+ * @return Индекс корня преобразованного выражения.
+ */
+NodeIndex transformImplicationAndEquivalence(ExpressionDag& dag, NodeIndex root);
+
+/**
+ * @brief Применяет законы де Моргана к графу.
+ *
+ * Переносит каждое отрицание сразу до переменных, поэтому следующий вызов уже не вносит изменений.
+ * @param [in,out] dag Граф выражения.
+ * @param [in] root Индекс корня.
+ * @param [in,out] changed Устанавливается в true, если были внесены изменения.
+ * @return Индекс корня преобразованного выражения.
+ */
+NodeIndex simplifyExpression(ExpressionDag& dag, NodeIndex root, bool& changed);
+
+/**
+ * @brief Удаляет двойные отрицания в графе.
+ * @param [in,out] dag Граф выражения.
+ * @param [in] root Индекс корня.
+ * @return Индекс корня преобразованного выражения.
+ */
+NodeIndex removeDoubleNot(ExpressionDag& dag, NodeIndex root);
+
+/**
+ * @brief Строит выражение с отрицаниями на ребрах из вектора токенов.
+ *
+ * Работает так же, как buildExpressionTree для узлов ExpressionNode, и сообщает о тех же ошибках.
+ * Отрицание не создает узла, а инвертирует бит ребра к операнду, поэтому двойные отрицания исчезают при построении.
+ * @param [in] tokens Вектор токенов в постфиксной записи.
+ * @param [in,out] errorList Множество для хранения обнаруженных ошибок.
+ * @param [in,out] graph Выражение, в которое добавляются узлы.
+ * @return Ребро к корню построенного выражения или nullEdge при ошибке.
+ */
+Edge buildExpressionTree(const std::vector<Token>& tokens, std::set<Error>& errorList, EdgeExpression& graph);
+
+/**
+ * @brief Преобразует операции импликации и эквивалентности в выражении с отрицаниями на ребрах.
+ *
+ * Преобразует импликацию (A > B) в (!A | B) и эквивалентность (A ~ B) в ((A & B) | (!A & !B)).
+ * Операнды эквивалентности не копируются: оба вхождения ссылаются на один узел.
+ * @param [in,out] graph Выражение с отрицаниями на ребрах.
+ */
+void transformImplicationAndEquivalence(EdgeExpression& graph);
+
+/**
+ * @brief Преобразует выражение с отрицаниями на ребрах в инфиксную строку.
+ *
+ * Выражение выводится в отрицательной нормальной форме: законы де Моргана и удаление двойных отрицаний
+ * применяются при чтении, поэтому результат совпадает с результатом повторных вызовов simplifyExpression
+ * и последующего removeDoubleNot для дерева после transformImplicationAndEquivalence.
+ * @param [in] graph Выражение с отрицаниями на ребрах.
+ * @param [in] root Ребро к корню.
+ * @return Строковое представление выражения в инфиксной форме.
+ */
+std::string expressionTreeToInfix(const EdgeExpression& graph, Edge root);
+
+/**
+ * @brief Строит отрицательную нормальную форму дерева за один проход.
+ *
+ * Переносит отрицания к переменным и удаляет двойные отрицания одним обходом сверху вниз с учетом полярности.
+ * Результат совпадает с результатом повторных вызовов simplifyExpression и последующего removeDoubleNot.
+ * @param [in] node Указатель на корень дерева после transformImplicationAndEquivalence.
+ * @return Указатель на корень нового дерева; исходное дерево не изменяется.
+ */
+ExpressionNode* negationNormalForm(const ExpressionNode* node);
+
+/**
+ * @brief Строит отрицательную нормальную форму плоского дерева за один проход.
+ *
+ * Узлы результата добавляются в конец массивов того же дерева, исходные узлы не изменяются.
+ * @param [in,out] tree Плоское дерево после transformImplicationAndEquivalence.
+ * @param [in] root Индекс корня.
+ * @return Индекс корня результата.
+ */
+NodeIndex negationNormalForm(FlatExpression& tree, NodeIndex root);
+
+/**
+ * @brief Выполняет все преобразования выражения за один проход по исходному дереву.
+ *
+ * Раскрывает импликацию и эквивалентность, переносит отрицания к переменным и удаляет двойные отрицания
+ * одним обходом сверху вниз с учетом полярности. Результат совпадает с результатом transformImplicationAndEquivalence,
+ * повторных вызовов simplifyExpression и removeDoubleNot.
+ * @param [in] node Указатель на корень исходного дерева.
+ * @return Указатель на корень нового дерева; исходное дерево не изменяется.
+ */
+ExpressionNode* fusedNormalForm(const ExpressionNode* node);
+
+/**
+ * @brief Выполняет все преобразования плоского дерева за один проход.
+ *
+ * Узлы результата добавляются в конец массивов того же дерева, исходные узлы не изменяются.
+ * @param [in,out] tree Плоское дерево.
+ * @param [in] root Индекс корня исходного выражения.
+ * @return Индекс корня результата.
+ */
+NodeIndex fusedNormalForm(FlatExpression& tree, NodeIndex root);
+
+/**
+ * @brief Строит диаграмму двоичных решений по дереву выражения.
+ *
+ * Дерево обходится без рекурсии; переменные, которых еще нет в менеджере, добавляются на нижние уровни
+ * в порядке первого вхождения слева направо.
+ * @param [in,out] manager Менеджер диаграмм.
+ * @param [in] root Указатель на корень дерева.
+ * @return Ссылка на корень диаграммы (не защищена от сборки мусора) или nullBdd для пустого дерева.
+ */
+BddRef buildBdd(BddManager& manager, const ExpressionNode* root);
+
+/**
+ * @brief Преобразует диаграмму двоичных решений в дерево выражения по разложению Шеннона.
+ *
+ * Узел с переменной x и ветвями L, H становится выражением x & H | !x & L с сокращением ветвей-констант.
+ * @param [in] manager Менеджер диаграмм.
+ * @param [in] f Ссылка на корень диаграммы.
+ * @return Указатель на корень нового дерева; константы выражаются через переменную верхнего уровня как
+ * (x & !x) и (x || !x), для константы в менеджере без переменных возвращается nullptr.
+ */
+ExpressionNode* bddToExpression(const BddManager& manager, BddRef f);
+
+/**
+ * @brief Вычисляет статический порядок переменных для диаграмм двоичных решений по структуре дерева.
+ *
+ * Использует эвристику FORCE: переменные небольших поддеревьев притягиваются друг к другу, начиная с порядка
+ * первого вхождения. Чтобы построить диаграмму в этом порядке, переменные передаются в BddManager::variableIndex
+ * до вызова buildBdd.
+ * @param [in] root Указатель на корень дерева.
+ * @return Имена переменных в порядке от верхнего уровня к нижнему.
+ */
+std::vector<Symbol> staticVariableOrder(const ExpressionNode* root);
+
+/**
+ * @brief Компилирует дерево в программу над битовыми векторами.
+ *
+ * Операнд, которому нужен более глубокий стек, вычисляется первым, поэтому глубина стека программы
+ * растет как логарифм размера дерева.
+ * @param [in] root Указатель на корень дерева.
+ * @param [in,out] variables Нумерация переменных, общая для сравниваемых программ.
+ * @param [out] program Программа.
+ */
+void compileBitProgram(const ExpressionNode* root, BitVariables& variables, BitProgram& program);
+
+/**
+ * @brief Доказывает равносильность двух программ с общей нумерацией переменных.
+ *
+ * Сначала программы сравниваются на случайных наборах (64 набора в машинном слове), затем строятся
+ * в общем графе конъюнкций с инверсиями: совпадение корней доказывает равносильность. Иначе равносильность
+ * доказывается полной таблицей истинности (до 24 переменных) или диаграммами двоичных решений с ограниченным
+ * числом узлов.
+ * @param [in] variables Нумерация переменных.
+ * @param [in] first Первая программа.
+ * @param [in] second Вторая программа.
+ * @param [out] counterexample Значения переменных по номерам, на которых программы различаются (при различии).
+ * @return true, если программы равносильны.
+ * @throw Error с типом bddNodeLimit, если равносильность не удалось ни доказать, ни опровергнуть в пределах числа узлов.
+ */
+bool verifyEquivalence(const BitVariables& variables, const BitProgram& first, const BitProgram& second, std::vector<bool>& counterexample);
+
+/**
+ * @brief Доказывает равносильность двух деревьев.
+ * @param [in] first Указатель на корень первого дерева.
+ * @param [in] second Указатель на корень второго дерева.
+ * @param [out] counterexample Значения переменных, на которых деревья различаются (при различии).
+ * @return true, если деревья равносильны.
+ * @throw Error с типом bddNodeLimit, если равносильность не удалось ни доказать, ни опровергнуть в пределах числа узлов.
+ */
+bool verifyEquivalence(const ExpressionNode* first, const ExpressionNode* second, std::vector<std::pair<Symbol, bool>>& counterexample);
+
+/**
+ * @brief Строит таблицу истинности выражения.
+ *
+ * Выражение компилируется в программу над битовыми векторами, которая выполняется фрагментами таблицы,
+ * помещающимися в кэш второго уровня, операциями AVX2 (или над 64-битными словами). Количество выполняющих
+ * наборов считается подсчетом единичных битов фрагментов.
+ * @param [in] root Указатель на корень дерева.
+ * @param [out] table Таблица истинности; при превышении TruthTable::maxVariables заполняются только переменные.
+ * @return true, если таблица построена.
+ */
+bool buildTruthTable(const ExpressionNode* root, TruthTable& table);
+
+/**
+ * @brief Строит таблицу истинности выражения, заданного строкой.
+ * @param [in] expression Строка с логическим выражением.
+ * @param [out] table Таблица истинности.
+ * @param [in,out] errorList Множество для хранения обнаруженных ошибок (tooManyVariables при превышении TruthTable::maxVariables).
+ * @param [in] syntax Форма записи выражения.
+ * @return true, если выражение разобрано без ошибок и таблица построена.
+ */
+bool processTruthTable(std::string_view expression, TruthTable& table, std::set<Error>& errorList, InputSyntax syntax = syntaxPostfix);
+
+/**
+ * @brief Строит таблицу истинности выражения и выводит ее в файл одной строкой.
+ *
+ * Строка содержит имена переменных через пробел, двоеточие, значения выражения шестнадцатеричным числом,
+ * бит index которого — значение на наборе index, и количество выполняющих наборов в скобках.
+ * @param [in] expression Строка с логическим выражением.
+ * @param [in,out] output Выходной файл.
+ * @param [in,out] errorList Множество для хранения обнаруженных ошибок.
+ * @param [in] syntax Форма записи выражения.
+ * @return true, если таблица построена и выведена; при ошибках в файл ничего не выводится.
+ * @throw Error с типом outputFile, если запись в файл не удалась.
+ */
+bool processTruthTable(std::string_view expression, OutputWriter& output, std::set<Error>& errorList, InputSyntax syntax = syntaxPostfix);
+
+/**
+ * @brief Подсчитывает выполняющие наборы выражения перебором всех наборов без хранения таблицы истинности.
+ *
+ * Наборы делятся на блоки фиксацией значений старших переменных; блоки распределяются между потоками пула
+ * и вычисляются фрагментами, помещающимися в кэш. От каждого блока сохраняются только количество
+ * выполняющих наборов и первые выполняющий и опровергающий наборы, поэтому память потока постоянна.
+ * @param [in] root Указатель на корень дерева.
+ * @param [out] result Итоги перебора; при превышении ModelCount::maxVariables заполняются только переменные.
+ * @param [in] pool Пул потоков (nullptr — в текущем потоке).
+ * @return true, если перебор выполнен.
+ */
+bool countModels(const ExpressionNode* root, ModelCount& result, ForkJoinPool* pool = nullptr);
+
+/**
+ * @brief Подсчитывает выполняющие наборы выражения, заданного строкой.
+ * @param [in] expression Строка с логическим выражением.
+ * @param [out] result Итоги перебора.
+ * @param [in,out] errorList Множество для хранения обнаруженных ошибок (tooManyVariables при превышении ModelCount::maxVariables).
+ * @param [in] syntax Форма записи выражения.
+ * @param [in] pool Пул потоков (nullptr — в текущем потоке).
+ * @return true, если выражение разобрано без ошибок и перебор выполнен.
+ */
+bool processModelCount(std::string_view expression, ModelCount& result, std::set<Error>& errorList, InputSyntax syntax = syntaxPostfix, ForkJoinPool* pool = nullptr);
+
+/**
+ * @brief Подсчитывает выполняющие наборы выражения и выводит итоги в файл одной строкой.
+ *
+ * Строка содержит имена переменных через пробел, двоеточие, количество выполняющих наборов из общего числа
+ * и первые выполняющий и опровергающий наборы, если они есть.
+ * @param [in] expression Строка с логическим выражением.
+ * @param [in,out] output Выходной файл.
+ * @param [in,out] errorList Множество для хранения обнаруженных ошибок.
+ * @param [in] syntax Форма записи выражения.
+ * @param [in] pool Пул потоков (nullptr — в текущем потоке).
+ * @return true, если перебор выполнен и итоги выведены; при ошибках в файл ничего не выводится.
+ * @throw Error с типом outputFile, если запись в файл не удалась.
+ */
+bool processModelCount(std::string_view expression, OutputWriter& output, std::set<Error>& errorList, InputSyntax syntax = syntaxPostfix, ForkJoinPool* pool = nullptr);
\ No newline at end of file
@@ -9,10 +9,41 @@
  * Программа предназначена для раскрытия скобок в логическом выражении по законам де Моргана и удаления двойного отрицания
  * Программа разработана на языке C++ с использованием стандартных библиотек C++
  * Программа должна получать два аргумента командной строки: имя входного файла и имя выходного файла в формате ".txt".
+ * С ключом --batch обрабатывается каждая строка входного файла, а результат для каждой строки записывается
+ * отдельной строкой выходного файла.
+ * Ключ --engine выбирает представление выражения: tree (дерево узлов, по умолчанию), flat (плоское дерево)
+ * или dag (граф с общими подвыражениями, не растущий экспоненциально при раскрытии вложенных эквивалентностей),
+ * или edge (отрицания хранятся битом на ссылках между узлами, отрицательная нормальная форма строится при выводе).
+ * Ключ --rewrite nnf заменяет повторные проходы законов де Моргана одним проходом с учетом полярности,
+ * ключ --rewrite fused выполняет все преобразования одним проходом по исходному дереву.
+ * Ключ --threads N распределяет строки пакетного режима между N потоками (0 — по числу ядер),
+ * результаты записываются в порядке входных строк. Без --batch тот же ключ включает обработку одного
+ * большого выражения по схеме fork-join с перехватом задач: большие поддеревья преобразуются параллельно
+ * (представление tree, способ rounds).
+ * С ключом --infix выражения читаются в инфиксной записи с операциями !, &, || (или |), -> (или >), ~
+ * и скобками, то есть в той же форме, в которой выводится результат.
+ * С ключом --verify результат выводится только после доказательства его равносильности исходному выражению:
+ * сначала выражения сравниваются на случайных наборах (64 набора в машинном слове), затем полной таблицей истинности
+ * (до 24 переменных) или диаграммами двоичных решений. При различии вместо результата выводится ошибка
+ * с набором значений переменных, на котором выражения различаются.
+ * С ключом --truth-table вместо преобразованного выражения выводится таблица истинности (до 32 переменных):
+ * имена переменных, значения выражения на всех наборах шестнадцатеричным числом и количество выполняющих наборов.
+ * Таблица вычисляется фрагментами, помещающимися в кэш, операциями AVX2 над словами по 256 бит.
+ * С ключом --count таблица не хранится (до 40 переменных): наборы делятся на блоки фиксацией старших переменных,
+ * блоки вычисляются параллельно (--threads N без --batch), и выводятся только количество выполняющих наборов
+ * и первые выполняющий и опровергающий наборы.
+ * С ключом --pipe программа работает фильтром: читает выражения построчно со стандартного ввода
+ * и выводит результаты в стандартный вывод, сообщения об ошибках — в поток ошибок.
  *
  * Пример команды запуска программы:
  * \code
  * ./simpleLogicExpression.exe ./input.txt ./output.txt
+ * ./simpleLogicExpression.exe --batch ./input.txt ./output.txt
+ * ./simpleLogicExpression.exe --batch --engine dag ./input.txt ./output.txt
+ * ./simpleLogicExpression.exe --batch --threads 8 ./input.txt ./output.txt
+ * ./simpleLogicExpression.exe --batch --truth-table ./input.txt ./output.txt
+ * ./simpleLogicExpression.exe --count --threads 0 ./input.txt ./output.txt
+ * cat ./input.txt | ./simpleLogicExpression.exe --pipe > ./output.txt
  * \endcode
  *
  * \author Pavel Andreyaschenko
@@ -21,31 +52,601 @@
  */
 
 #include <functional>
+#include <deque>
+#include <memory>
 #include <unordered_set>
 #include <stack>
 #include <iostream>
 #include <fstream>
-#include <sstream>
 #include <string>
-#include <map>
 #include <algorithm>
+#include <iterator>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <cassert>
+#include <cmath>
 #include <locale>
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#include <io.h>
+#include <climits>
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define SIMD_X86
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#define TARGET_SSE2
+#define TARGET_AVX2
+#else
+#define TARGET_SSE2 __attribute__((target("sse2")))
+#define TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#endif
 #include "objects.h"
 #include "functions.h"
 
 /**
- * @brief Соответствие между строкой и типом операции.
+ * @brief Классы символов для лексического анализа.
  *
- * Карта, связывающая строковые представления логических операций с их типами в перечислении TokenType.
+ * Битовые флаги, которыми помечается каждый байт входной строки в таблице charClassTable.
  */
-const std::map<std::string, TokenType> stringToTokenType = {
-    {"!", TokenType::Not},
-    {"&", TokenType::And},
-    {"|", TokenType::Or},
-    {">", TokenType::Implication},
-    {"~", TokenType::Equivalence}
+enum CharClass : unsigned char {
+    charSeparator = 1, ///< Разделитель токенов (пробельный символ).
+    charLetter = 2,    ///< Символ латинского алфавита.
+    charDigit = 4,     ///< Цифра.
+    charOperation = 8  ///< Символ логической операции.
 };
 
+/**
+ * @brief Формирует таблицу классов символов.
+ *
+ * Для каждого из 256 значений байта вычисляет набор флагов CharClass на этапе компиляции.
+ * Классификация не зависит от текущей локали.
+ * @return Таблица классов символов.
+ */
+constexpr std::array<unsigned char, 256> makeCharClassTable() {
+    std::array<unsigned char, 256> table{};
+
+    for (int c = 'a'; c <= 'z'; c++) table[c] = charLetter;
+    for (int c = 'A'; c <= 'Z'; c++) table[c] = charLetter;
+    for (int c = '0'; c <= '9'; c++) table[c] = charDigit;
+
+    for (unsigned char c : { ' ', '\t', '\n', '\v', '\f', '\r' }) table[c] = charSeparator;
+    for (unsigned char c : { '!', '&', '|', '>', '~' }) table[c] = charOperation;
+
+    return table;
+}
+
+/**
+ * @brief Таблица классов символов, индексируемая значением байта.
+ */
+constexpr std::array<unsigned char, 256> charClassTable = makeCharClassTable();
+
+/**
+ * @brief Соответствие между символом и типом операции.
+ *
+ * Связывает символ логической операции с его типом в перечислении TokenType.
+ * @param c Символ операции.
+ * @return Тип операции или TokenType::Any, если символ не является операцией.
+ */
+constexpr TokenType operationType(char c) {
+    switch (c) {
+    case '!': return TokenType::Not;
+    case '&': return TokenType::And;
+    case '|': return TokenType::Or;
+    case '>': return TokenType::Implication;
+    case '~': return TokenType::Equivalence;
+    default: return TokenType::Any;
+    }
+}
+
+/**
+ * @brief Таблица приоритетов операций при выводе в инфиксной форме, индексируемая типом узла.
+ *
+ * Чем больше значение, тем сильнее связывает операция. Переменные и служебный тип имеют приоритет 0
+ * и никогда не заключаются в скобки.
+ */
+constexpr std::array<int, TokenType::Any + 1> operationPriorities = {
+    0, // Variable
+    5, // Not
+    4, // And
+    3, // Or
+    2, // Implication
+    1, // Equivalence
+    0  // Any
+};
+
+static_assert(operationPriorities[TokenType::Equivalence] < operationPriorities[TokenType::Implication] &&
+    operationPriorities[TokenType::Implication] < operationPriorities[TokenType::Or] &&
+    operationPriorities[TokenType::Or] < operationPriorities[TokenType::And] &&
+    operationPriorities[TokenType::And] < operationPriorities[TokenType::Not], "Нарушен порядок приоритетов операций");
+
+/**
+ * @brief Таблица обозначений бинарных операций при выводе в инфиксной форме, индексируемая типом узла.
+ */
+constexpr std::array<const char*, TokenType::Any + 1> operationTexts = {
+    "",     // Variable
+    "!",    // Not
+    " & ",  // And
+    " || ", // Or
+    " -> ", // Implication
+    " ~ ",  // Equivalence
+    ""      // Any
+};
+
+/**
+ * @brief Приоритет операции при выводе в инфиксной форме.
+ * @param type Тип узла.
+ * @return Приоритет операции.
+ */
+constexpr int operationPriority(TokenType type) {
+    return operationPriorities[type];
+}
+
+/**
+ * @brief Битовые маски классов символов блока из 64 байт.
+ *
+ * Бит i каждой маски соответствует байту i блока.
+ */
+struct BlockMasks {
+    uint64_t separators;   ///< Разделители токенов.
+    uint64_t alphanumeric; ///< Буквы латинского алфавита и цифры.
+};
+
+/**
+ * @brief Указатель на функцию классификации блока из 64 байт.
+ */
+using ScanBlockFunction = BlockMasks(*)(const char* block);
+
+/**
+ * @brief Классифицирует блок из 64 байт по таблице charClassTable.
+ * @param block Указатель на блок.
+ * @return Битовые маски блока.
+ */
+static BlockMasks scanBlockScalar(const char* block) {
+    BlockMasks masks = { 0, 0 };
+
+    for (int i = 0; i < 64; i++) {
+        unsigned char cls = charClassTable[static_cast<unsigned char>(block[i])];
+        masks.separators |= static_cast<uint64_t>((cls & charSeparator) != 0) << i;
+        masks.alphanumeric |= static_cast<uint64_t>((cls & (charLetter | charDigit)) != 0) << i;
+    }
+
+    return masks;
+}
+
+#ifdef SIMD_X86
+/**
+ * @brief Классифицирует блок из 64 байт инструкциями SSE2.
+ *
+ * Диапазоны символов проверяются беззнаковым сравнением через минимум: x - lo <= hi - lo.
+ * @param block Указатель на блок.
+ * @return Битовые маски блока.
+ */
+TARGET_SSE2 static BlockMasks scanBlockSse2(const char* block) {
+    BlockMasks masks = { 0, 0 };
+
+    for (int part = 0; part < 4; part++) {
+        __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(block + part * 16));
+
+        // Пробел и управляющие символы \t, \n, \v, \f, \r (коды 9..13)
+        __m128i space = _mm_cmpeq_epi8(bytes, _mm_set1_epi8(' '));
+        __m128i control = _mm_sub_epi8(bytes, _mm_set1_epi8(9));
+        control = _mm_cmpeq_epi8(_mm_min_epu8(control, _mm_set1_epi8(4)), control);
+
+        // Буквы латинского алфавита (без учета регистра) и цифры
+        __m128i letter = _mm_sub_epi8(_mm_or_si128(bytes, _mm_set1_epi8(0x20)), _mm_set1_epi8('a'));
+        letter = _mm_cmpeq_epi8(_mm_min_epu8(letter, _mm_set1_epi8(25)), letter);
+        __m128i digit = _mm_sub_epi8(bytes, _mm_set1_epi8('0'));
+        digit = _mm_cmpeq_epi8(_mm_min_epu8(digit, _mm_set1_epi8(9)), digit);
+
+        uint64_t separators = static_cast<uint32_t>(_mm_movemask_epi8(_mm_or_si128(space, control)));
+        uint64_t alphanumeric = static_cast<uint32_t>(_mm_movemask_epi8(_mm_or_si128(letter, digit)));
+        masks.separators |= separators << (part * 16);
+        masks.alphanumeric |= alphanumeric << (part * 16);
+    }
+
+    return masks;
+}
+
+/**
+ * @brief Классифицирует блок из 64 байт инструкциями AVX2.
+ * @param block Указатель на блок.
+ * @return Битовые маски блока.
+ */
+TARGET_AVX2 static BlockMasks scanBlockAvx2(const char* block) {
+    BlockMasks masks = { 0, 0 };
+
+    for (int part = 0; part < 2; part++) {
+        __m256i bytes = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block + part * 32));
+
+        __m256i space = _mm256_cmpeq_epi8(bytes, _mm256_set1_epi8(' '));
+        __m256i control = _mm256_sub_epi8(bytes, _mm256_set1_epi8(9));
+        control = _mm256_cmpeq_epi8(_mm256_min_epu8(control, _mm256_set1_epi8(4)), control);
+
+        __m256i letter = _mm256_sub_epi8(_mm256_or_si256(bytes, _mm256_set1_epi8(0x20)), _mm256_set1_epi8('a'));
+        letter = _mm256_cmpeq_epi8(_mm256_min_epu8(letter, _mm256_set1_epi8(25)), letter);
+        __m256i digit = _mm256_sub_epi8(bytes, _mm256_set1_epi8('0'));
+        digit = _mm256_cmpeq_epi8(_mm256_min_epu8(digit, _mm256_set1_epi8(9)), digit);
+
+        uint64_t separators = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_or_si256(space, control)));
+        uint64_t alphanumeric = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_or_si256(letter, digit)));
+        masks.separators |= separators << (part * 32);
+        masks.alphanumeric |= alphanumeric << (part * 32);
+    }
+
+    return masks;
+}
+#endif
+
+/**
+ * @brief Проверяет, поддерживает ли процессор указанное ядро поиска разделителей.
+ * @param kernel Ядро поиска разделителей.
+ * @return true, если ядро может быть использовано.
+ */
+static bool isScanKernelSupported(ScanKernel kernel) {
+    switch (kernel) {
+    case scanScalar:
+        return true;
+#ifdef SIMD_X86
+#ifdef _MSC_VER
+    case scanSse2: {
+        int info[4];
+        __cpuid(info, 1);
+        return (info[3] & (1 << 26)) != 0;
+    }
+    case scanAvx2: {
+        int info[4];
+        __cpuid(info, 0);
+        if (info[0] < 7) return false;
+
+        // AVX2 требует поддержки OSXSAVE и сохранения регистров YMM операционной системой
+        __cpuid(info, 1);
+        bool osxsave = (info[2] & (1 << 27)) != 0 && (info[2] & (1 << 28)) != 0;
+        if (!osxsave || (_xgetbv(0) & 6) != 6) return false;
+
+        __cpuidex(info, 7, 0);
+        return (info[1] & (1 << 5)) != 0;
+    }
+#else
+    case scanSse2:
+        return __builtin_cpu_supports("sse2");
+    case scanAvx2:
+        return __builtin_cpu_supports("avx2");
+#endif
+#endif
+    default:
+        return false;
+    }
+}
+
+/**
+ * @brief Возвращает функцию классификации блока для указанного ядра.
+ * @param kernel Ядро поиска разделителей.
+ * @return Указатель на функцию классификации блока.
+ */
+static ScanBlockFunction scanBlockFunction(ScanKernel kernel) {
+    switch (kernel) {
+#ifdef SIMD_X86
+    case scanSse2: return scanBlockSse2;
+    case scanAvx2: return scanBlockAvx2;
+#endif
+    default: return scanBlockScalar;
+    }
+}
+
+/**
+ * @brief Определяет наиболее быстрое ядро, поддерживаемое процессором.
+ * @return Ядро поиска разделителей.
+ */
+static ScanKernel detectScanKernel() {
+    if (isScanKernelSupported(scanAvx2)) return scanAvx2;
+    if (isScanKernelSupported(scanSse2)) return scanSse2;
+    return scanScalar;
+}
+
+/**
+ * @brief Текущее ядро поиска разделителей и соответствующая функция классификации блока.
+ */
+static ScanKernel currentScanKernel = detectScanKernel();
+static ScanBlockFunction scanBlock = scanBlockFunction(currentScanKernel);
+
+/**
+ * @brief Возвращает индекс младшего установленного бита.
+ * @param mask Ненулевая битовая маска.
+ * @return Индекс младшего установленного бита.
+ */
+static inline unsigned countTrailingZeros(uint64_t mask) {
+#if defined(_MSC_VER) && defined(_M_X64)
+    unsigned long index;
+    _BitScanForward64(&index, mask);
+    return static_cast<unsigned>(index);
+#elif defined(_MSC_VER)
+    unsigned long index;
+    if (_BitScanForward(&index, static_cast<unsigned long>(mask))) return static_cast<unsigned>(index);
+    _BitScanForward(&index, static_cast<unsigned long>(mask >> 32));
+    return static_cast<unsigned>(index) + 32;
+#else
+    return static_cast<unsigned>(__builtin_ctzll(mask));
+#endif
+}
+
+/**
+ * @brief Возвращает маску битов с индексами из полуинтервала [from, to).
+ * @param from Первый бит диапазона.
+ * @param to Бит, следующий за последним битом диапазона (не больше 64).
+ * @return Битовая маска диапазона.
+ */
+static inline uint64_t bitRange(unsigned from, unsigned to) {
+    uint64_t upper = to >= 64 ? ~0ULL : (1ULL << to) - 1;
+    return upper & ~((1ULL << from) - 1);
+}
+
+/**
+ * @brief Возвращает количество установленных битов.
+ * @param word Слово.
+ * @return Количество единичных битов.
+ */
+static inline unsigned countOnes(uint64_t word) {
+#if defined(__GNUC__) || defined(__clang__)
+    return static_cast<unsigned>(__builtin_popcountll(word));
+#else
+    word = word - ((word >> 1) & 0x5555555555555555ull);
+    word = (word & 0x3333333333333333ull) + ((word >> 2) & 0x3333333333333333ull);
+    word = (word + (word >> 4)) & 0x0F0F0F0F0F0F0F0Full;
+    return static_cast<unsigned>((word * 0x0101010101010101ull) >> 56);
+#endif
+}
+
+/**
+ * @brief Набор операций над битовыми векторами для программ BitProgram.
+ *
+ * Бинарная операция записывает результат на место первого операнда a.
+ */
+struct BitKernel {
+    void (*notWords)(uint64_t* a, size_t words);                              ///< a = !a.
+    void (*andWords)(uint64_t* a, const uint64_t* b, size_t words);           ///< a = a & b.
+    void (*orWords)(uint64_t* a, const uint64_t* b, size_t words);            ///< a = a | b.
+    void (*implicationWords)(uint64_t* a, const uint64_t* b, size_t words);   ///< a = a -> b.
+    void (*converseWords)(uint64_t* a, const uint64_t* b, size_t words);      ///< a = b -> a.
+    void (*equivalenceWords)(uint64_t* a, const uint64_t* b, size_t words);   ///< a = a ~ b.
+    uint64_t (*countWords)(const uint64_t* a, size_t words);                  ///< Количество единичных битов.
+};
+
+/**
+ * @brief Операции BitKernel над 64-битными словами.
+ */
+static void notWordsScalar(uint64_t* a, size_t words) {
+    for (size_t k = 0; k < words; k++) a[k] = ~a[k];
+}
+
+static void andWordsScalar(uint64_t* a, const uint64_t* b, size_t words) {
+    for (size_t k = 0; k < words; k++) a[k] &= b[k];
+}
+
+static void orWordsScalar(uint64_t* a, const uint64_t* b, size_t words) {
+    for (size_t k = 0; k < words; k++) a[k] |= b[k];
+}
+
+static void implicationWordsScalar(uint64_t* a, const uint64_t* b, size_t words) {
+    for (size_t k = 0; k < words; k++) a[k] = ~a[k] | b[k];
+}
+
+static void converseWordsScalar(uint64_t* a, const uint64_t* b, size_t words) {
+    for (size_t k = 0; k < words; k++) a[k] |= ~b[k];
+}
+
+static void equivalenceWordsScalar(uint64_t* a, const uint64_t* b, size_t words) {
+    for (size_t k = 0; k < words; k++) a[k] = ~(a[k] ^ b[k]);
+}
+
+static uint64_t countWordsScalar(const uint64_t* a, size_t words) {
+    uint64_t count = 0;
+    for (size_t k = 0; k < words; k++) count += countOnes(a[k]);
+    return count;
+}
+
+/**
+ * @brief Операции над 64-битными словами (доступны всегда).
+ */
+static const BitKernel bitKernelScalar = {
+    notWordsScalar, andWordsScalar, orWordsScalar, implicationWordsScalar,
+    converseWordsScalar, equivalenceWordsScalar, countWordsScalar
+};
+
+#ifdef SIMD_X86
+/**
+ * @brief Операции BitKernel инструкциями AVX2: по 4 слова за итерацию, остаток — по одному слову.
+ */
+TARGET_AVX2 static void notWordsAvx2(uint64_t* a, size_t words) {
+    const __m256i ones = _mm256_set1_epi64x(-1);
+    size_t k = 0;
+    for (; k + 4 <= words; k += 4) {
+        __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + k));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(a + k), _mm256_xor_si256(x, ones));
+    }
+    for (; k < words; k++) a[k] = ~a[k];
+}
+
+TARGET_AVX2 static void andWordsAvx2(uint64_t* a, const uint64_t* b, size_t words) {
+    size_t k = 0;
+    for (; k + 4 <= words; k += 4) {
+        __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + k));
+        __m256i y = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + k));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(a + k), _mm256_and_si256(x, y));
+    }
+    for (; k < words; k++) a[k] &= b[k];
+}
+
+TARGET_AVX2 static void orWordsAvx2(uint64_t* a, const uint64_t* b, size_t words) {
+    size_t k = 0;
+    for (; k + 4 <= words; k += 4) {
+        __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + k));
+        __m256i y = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + k));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(a + k), _mm256_or_si256(x, y));
+    }
+    for (; k < words; k++) a[k] |= b[k];
+}
+
+TARGET_AVX2 static void implicationWordsAvx2(uint64_t* a, const uint64_t* b, size_t words) {
+    // ~x | y = ~(x & ~y), где andnot(y, x) = ~y & x
+    const __m256i ones = _mm256_set1_epi64x(-1);
+    size_t k = 0;
+    for (; k + 4 <= words; k += 4) {
+        __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + k));
+        __m256i y = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + k));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(a + k), _mm256_xor_si256(_mm256_andnot_si256(y, x), ones));
+    }
+    for (; k < words; k++) a[k] = ~a[k] | b[k];
+}
+
+TARGET_AVX2 static void converseWordsAvx2(uint64_t* a, const uint64_t* b, size_t words) {
+    const __m256i ones = _mm256_set1_epi64x(-1);
+    size_t k = 0;
+    for (; k + 4 <= words; k += 4) {
+        __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + k));
+        __m256i y = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + k));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(a + k), _mm256_xor_si256(_mm256_andnot_si256(x, y), ones));
+    }
+    for (; k < words; k++) a[k] |= ~b[k];
+}
+
+TARGET_AVX2 static void equivalenceWordsAvx2(uint64_t* a, const uint64_t* b, size_t words) {
+    const __m256i ones = _mm256_set1_epi64x(-1);
+    size_t k = 0;
+    for (; k + 4 <= words; k += 4) {
+        __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + k));
+        __m256i y = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + k));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(a + k), _mm256_xor_si256(_mm256_xor_si256(x, y), ones));
+    }
+    for (; k < words; k++) a[k] = ~(a[k] ^ b[k]);
+}
+
+/**
+ * @brief Считает единичные биты инструкциями AVX2.
+ *
+ * Количество единиц в каждой тетраде находится выборкой из таблицы (vpshufb) и накапливается в байтах;
+ * до переполнения байтов (не больше 31 итерации) суммы переносятся в 64-битные счетчики через vpsadbw.
+ * @param a Вектор.
+ * @param words Длина вектора в словах.
+ * @return Количество единичных битов.
+ */
+TARGET_AVX2 static uint64_t countWordsAvx2(const uint64_t* a, size_t words) {
+    const __m256i lookup = _mm256_setr_epi8(
+        0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+        0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+    const __m256i lowNibble = _mm256_set1_epi8(0x0F);
+    const __m256i zero = _mm256_setzero_si256();
+    __m256i total = zero;
+
+    size_t k = 0;
+    while (k + 4 <= words) {
+        size_t end = std::min(words & ~static_cast<size_t>(3), k + 4 * 31);
+        __m256i bytes = zero;
+        for (; k < end; k += 4) {
+            __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + k));
+            __m256i low = _mm256_shuffle_epi8(lookup, _mm256_and_si256(x, lowNibble));
+            __m256i high = _mm256_shuffle_epi8(lookup, _mm256_and_si256(_mm256_srli_epi16(x, 4), lowNibble));
+            bytes = _mm256_add_epi8(bytes, _mm256_add_epi8(low, high));
+        }
+        total = _mm256_add_epi64(total, _mm256_sad_epu8(bytes, zero));
+    }
+
+    alignas(32) uint64_t lanes[4];
+    _mm256_store_si256(reinterpret_cast<__m256i*>(lanes), total);
+    uint64_t count = lanes[0] + lanes[1] + lanes[2] + lanes[3];
+    for (; k < words; k++) count += countOnes(a[k]);
+    return count;
+}
+
+/**
+ * @brief Операции над векторами по 256 бит инструкциями AVX2.
+ */
+static const BitKernel bitKernelAvx2 = {
+    notWordsAvx2, andWordsAvx2, orWordsAvx2, implicationWordsAvx2,
+    converseWordsAvx2, equivalenceWordsAvx2, countWordsAvx2
+};
+#endif
+
+/**
+ * @brief Возвращает операции над битовыми векторами для указанного ядра.
+ * @param kernel Ядро поиска разделителей.
+ * @return Набор операций.
+ */
+static const BitKernel* bitKernelFunction(ScanKernel kernel) {
+#ifdef SIMD_X86
+    if (kernel == scanAvx2) return &bitKernelAvx2;
+#endif
+    return &bitKernelScalar;
+}
+
+/**
+ * @brief Текущие операции над битовыми векторами.
+ */
+static const BitKernel* bitKernel = bitKernelFunction(currentScanKernel);
+
+/**
+ * @brief Определяет тип выделенного токена.
+ * @param tokenStr Строковое значение токена.
+ * @param alphanumeric true, если токен состоит только из букв и цифр.
+ * @param position Позиция токена в строке.
+ * @param errorList Множество для хранения обнаруженных ошибок.
+ * @return Тип токена или TokenType::Any, если токен некорректен (ошибка добавлена в errorList).
+ */
+static TokenType classifyToken(std::string_view tokenStr, bool alphanumeric, int position, std::set<Error>& errorList) {
+    unsigned char first = charClassTable[static_cast<unsigned char>(tokenStr[0])];
+
+    // Проверка на операцию
+    if ((first & charOperation) && tokenStr.size() == 1) {
+        return operationType(tokenStr[0]);
+    }
+
+    // Проверка на переменную
+    if (first & charLetter) {
+        if (!alphanumeric) {
+            errorList.insert(Error(Error::ErrorType::invalidVariableChar, position));
+            return TokenType::Any;
+        }
+
+        return TokenType::Variable;
+    }
+
+    // Проверка на начало с цифры
+    if (first & charDigit) {
+        errorList.insert(Error(Error::ErrorType::invalidVariableName, position));
+        return TokenType::Any;
+    }
+
+    // Все остальные случаи — неподдерживаемая операция
+    errorList.insert(Error(Error::ErrorType::unsupportedOperation, position));
+    return TokenType::Any;
+}
+
+/**
+ * @brief Классифицирует выделенный токен и добавляет его в вектор токенов или ошибку в errorList.
+ * @param tokenStr Строковое значение токена.
+ * @param alphanumeric true, если токен состоит только из букв и цифр.
+ * @param position Позиция токена в строке.
+ * @param tokens Вектор токенов.
+ * @param errorList Множество для хранения обнаруженных ошибок.
+ */
+static void appendToken(std::string_view tokenStr, bool alphanumeric, int position, std::vector<Token>& tokens, std::set<Error>& errorList) {
+    TokenType type = classifyToken(tokenStr, alphanumeric, position, errorList);
+    if (type != TokenType::Any) {
+        tokens.emplace_back(type, tokenStr, position);
+    }
+}
+
 /**
  * @brief Главная функция программы.
  *
@@ -60,464 +661,5055 @@ int main(int argc, char* argv[]) {
     std::wcout.imbue(std::locale(""));
     setlocale(LC_ALL, ".UTF8");
 
-    // Проверяем количество аргументов командной строки
-    if (argc != 3) {
-        std::wcerr << L"Ошибка входных параметров, использование: " << argv[0] << " <input file> <output file>" << std::endl;
+    // Проверяем аргументы командной строки
+    ProgramOptions options;
+    if (!parseArguments(argc, argv, options)) {
+        std::wcerr << L"Ошибка входных параметров, использование: " << argv[0] << " [--batch] [--infix] [--verify | --truth-table | --count] [--engine tree|flat|dag|edge] [--rewrite rounds|nnf|fused] [--threads N] <input file> <output file>" << std::endl;
+        std::wcerr << L"       " << argv[0] << " --pipe [--infix] [--verify | --truth-table | --count] [--engine tree|flat|dag|edge] [--rewrite rounds|nnf|fused] [--threads N]" << std::endl;
         return 1;
     }
 
+    // Пакетный режим: каждая строка входного файла обрабатывается отдельно
+    if (options.batch) {
+        try {
+            return processBatch(options) ? 0 : 1;
+        }
+        catch (const Error& e) {
+            e.message();
+            return 1;
+        }
+    }
+
     std::set<Error> errorList;
-    std::string inputFile = argv[1];
-    std::string outputFile = argv[2];
     std::string content;
 
     // Чтение входного файла
     try {
-        content = readFile(inputFile);
+        content = readFile(options.inputFile);
     }
     catch (const Error& e) {
         e.message();
         return 1;
     }
 
-    // Токенизация входной строки
-    std::vector<Token> tokens = tokenize(content, errorList);
-
-    // Проверка на ошибки токенизации
-    if (!errorList.empty()) {
-        for (const auto& error : errorList) {
-            error.message();
-        }
-        return 1;
+    // Преобразование выражения, узлы дерева размещаются в пуле.
+    // При нескольких потоках дерево обрабатывается по схеме fork-join, а узлы выделяются в общей куче
+    NodeArena arena;
+    std::unique_ptr<ArenaScope> scope;
+    std::unique_ptr<ForkJoinPool> pool;
+    if (options.threads > 1) {
+        pool.reset(new ForkJoinPool(options.threads));
     }
-
-    // Построение дерева выражения
-    ExpressionNode* exprTree = buildExpressionTree(tokens, errorList);
-
-    // Проверка на ошибки построения дерева
-    if (!errorList.empty()) {
-        for (const auto& error : errorList) {
-            error.message();
-        }
-        delete exprTree; // Освобождаем память
-        return 1;
+    else {
+        scope.reset(new ArenaScope(arena));
     }
 
-    // Сохранение первоначального выражения
-    std::string inputStr = expressionTreeToInfix(exprTree);
-
-    // Преобразование импликации и эквивалентности
-    transformImplicationAndEquivalence(exprTree);
-
-    // Применение законов де Моргана до тех пор, пока есть изменения
-    bool changed;
-    do {
-        changed = false;
-        simplifyExpression(exprTree, changed);
-    } while (changed);
-
-    // Удаление двойных отрицаний
-    removeDoubleNot(exprTree);
-
-    // Формирование выходной строки
-    std::string result = expressionTreeToInfix(exprTree);
-
-    // Запись результата в выходной файл
+    // Результат выводится в файл при обходе дерева; файл создается только при успешной обработке
     try {
-        writeFile(outputFile, inputStr + '\n' + result);
+        OutputWriter output(options.outputFile, false);
+        bool processed;
+        if (options.truthTable) {
+            processed = processTruthTable(content, output, errorList, options.syntax);
+        }
+        else if (options.countModels) {
+            processed = processModelCount(content, output, errorList, options.syntax, pool.get());
+        }
+        else {
+            processed = processExpression(content, output, true, errorList, options, pool.get());
+        }
+        if (!processed) {
+            for (const auto& error : errorList) {
+                error.message();
+            }
+            return 1;
+        }
+        output.close();
     }
     catch (const Error& e) {
         e.message();
-        delete exprTree; // Освобождаем память
         return 1;
     }
 
-    // Освобождение памяти
-    delete exprTree;
-
     return 0;
 }
 
 /**
- * @brief Читает содержимое файла в строку.
+ * @brief Разбирает аргументы командной строки.
  *
- * Открывает файл по указанному пути и считывает его содержимое в строку.
- * @param [in] filePath Путь к входному файлу.
- * @return Содержимое файла в виде строки.
- * @throw Error с типом inputFile, если файл не удалось открыть.
+ * Заполняет параметры запуска программы по аргументам командной строки.
+ * Поддерживаемые формы: "<input file> <output file>", "--batch <input file> <output file>" и "--pipe".
+ * В пакетном режиме вместо имени файла можно указать "-" (стандартный ввод или вывод); "--pipe" равносилен "--batch - -".
+ * Ключ "--threads N" задает количество потоков пакетной обработки или преобразования одного выражения
+ * (0 — по числу аппаратных потоков). Ключ "--infix" включает разбор выражений в инфиксной записи,
+ * ключ "--verify" — проверку равносильности результата исходному выражению, ключ "--truth-table" — вывод
+ * таблицы истинности и количества выполняющих наборов вместо преобразованного выражения, ключ "--count" —
+ * только количества выполняющих наборов и первых выполняющего и опровергающего наборов (до 40 переменных).
+ * Ключи "--verify", "--truth-table" и "--count" взаимоисключающие.
+ * Ключ "--engine tree|flat|dag|edge" выбирает представление дерева для преобразований,
+ * ключ "--rewrite rounds|nnf|fused" — способ переноса отрицаний.
+ * @param [in] argc Количество аргументов командной строки.
+ * @param [in] argv Массив строк аргументов.
+ * @param [out] options Параметры запуска программы.
+ * @return true, если аргументы корректны, иначе false.
  */
-std::string readFile(const std::string& filePath) {
-    std::ifstream file(filePath); // Создаем поток для чтения из файла
+bool parseArguments(int argc, char* argv[], ProgramOptions& options) {
+    std::vector<std::string> files;
+    bool pipe = false;
 
-    // Выброс исключения, если файл не открылся
-    if (!file.is_open()) {
-        throw Error(Error::inputFile);
-    }
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
 
-    std::string content;           // Считываемая строка из файла
-    std::getline(file, content);   // Считывание строки
-    file.close();                  // Закрытие файла
+        if (arg == "--batch") {
+            options.batch = true;
+            continue;
+        }
 
-    return content;
-}
+        if (arg == "--pipe") {
+            pipe = true;
+            continue;
+        }
 
-/**
- * @brief Записывает строку в файл.
- *
- * Открывает файл по указанному пути и записывает в него переданную строку.
- * @param [in] filePath Путь к выходному файлу.
- * @param [in] content Строка для записи в файл.
- * @throw Error с типом outputFile, если файл не удалось открыть.
- */
-void writeFile(const std::string& filePath, const std::string& content) {
-    std::ofstream file(filePath);  // Создаем поток для записи в файл
+        if (arg == "--infix") {
+            options.syntax = syntaxInfix;
+            continue;
+        }
 
-    // Выброс исключения, если файл не открылся
-    if (!file.is_open()) {
-        throw Error(Error::outputFile);
-    }
+        if (arg == "--verify") {
+            options.verify = true;
+            continue;
+        }
+
+        if (arg == "--truth-table") {
+            options.truthTable = true;
+            continue;
+        }
+
+        if (arg == "--count") {
+            options.countModels = true;
+            continue;
+        }
+
+        if (arg == "--threads") {
+            if (i + 1 >= argc) return false;
+
+            std::string count = argv[++i];
+            if (count.empty() || count.size() > 4 || !std::all_of(count.begin(), count.end(), [](char c) { return isdigit(static_cast<unsigned char>(c)); })) {
+                return false;
+            }
+
+            // 0 — по числу аппаратных потоков
+            options.threads = static_cast<unsigned>(std::stoi(count));
+            if (options.threads == 0) {
+                options.threads = std::max(1u, std::thread::hardware_concurrency());
+            }
+            continue;
+        }
+
+        if (arg == "--engine") {
+            if (i + 1 >= argc) return false;
+
+            std::string engine = argv[++i];
+            if (engine == "tree") options.engine = engineTree;
+            else if (engine == "flat") options.engine = engineFlat;
+            else if (engine == "dag") options.engine = engineDag;
+            else if (engine == "edge") options.engine = engineEdge;
+            else return false;
+            continue;
+        }
+
+        if (arg == "--rewrite") {
+            if (i + 1 >= argc) return false;
+
+            std::string rewrite = argv[++i];
+            if (rewrite == "rounds") options.rewrite = rewriteRounds;
+            else if (rewrite == "nnf") options.rewrite = rewriteNnf;
+            else if (rewrite == "fused") options.rewrite = rewriteFused;
+            else return false;
+            continue;
+        }
+
+        files.push_back(arg);
+    }
+
+    // Проверка, таблица истинности и подсчет наборов — взаимоисключающие режимы
+    if (options.verify + options.truthTable + options.countModels > 1) {
+        return false;
+    }
+
+    // Режим фильтра: пакетная обработка стандартного ввода в стандартный вывод
+    if (pipe) {
+        if (!files.empty()) return false;
+
+        options.batch = true;
+        options.inputFile = "-";
+        options.outputFile = "-";
+        return true;
+    }
+
+    // Должны быть указаны ровно два файла: входной и выходной
+    if (files.size() != 2) {
+        return false;
+    }
+
+    // Стандартный ввод читается только построчно, в пакетном режиме
+    if (files[0] == "-" && !options.batch) {
+        return false;
+    }
+
+    options.inputFile = files[0];
+    options.outputFile = files[1];
+    return true;
+}
+
+/**
+ * @brief Читает содержимое файла в строку.
+ *
+ * Открывает файл по указанному пути и считывает его содержимое в строку.
+ * @param [in] filePath Путь к входному файлу.
+ * @return Содержимое файла в виде строки.
+ * @throw Error с типом inputFile, если файл не удалось открыть.
+ */
+std::string readFile(const std::string& filePath) {
+    std::ifstream file(filePath); // Создаем поток для чтения из файла
+
+    // Выброс исключения, если файл не открылся
+    if (!file.is_open()) {
+        throw Error(Error::inputFile);
+    }
+
+    std::string content;           // Считываемая строка из файла
+    std::getline(file, content);   // Считывание строки
+    file.close();                  // Закрытие файла
+
+    return content;
+}
+
+/**
+ * @brief Записывает строку в файл.
+ *
+ * Открывает файл по указанному пути и записывает в него переданную строку.
+ * @param [in] filePath Путь к выходному файлу.
+ * @param [in] content Строка для записи в файл.
+ * @throw Error с типом outputFile, если файл не удалось открыть.
+ */
+void writeFile(const std::string& filePath, const std::string& content) {
+    std::ofstream file(filePath);  // Создаем поток для записи в файл
+
+    // Выброс исключения, если файл не открылся
+    if (!file.is_open()) {
+        throw Error(Error::outputFile);
+    }
 
     file << content;               // Запись в файл
     file.close();                  // Закрытие файла
 }
 
+/**
+ * @brief Выделяет токены входной строки.
+ *
+ * Границы токенов находятся по битовым маскам разделителей, которые строятся блоками по 64 байта
+ * ядром, выбранным selectScanKernel. Для каждого токена вызывается onToken(текст, признак того,
+ * что токен состоит только из букв и цифр, порядковый номер токена начиная с 1).
+ * @param expression Строка с логическим выражением.
+ * @param onToken Обработчик токена.
+ */
+template <typename OnToken>
+static void scanTokens(std::string_view expression, OnToken onToken) {
+    const char* data = expression.data();
+    const size_t size = expression.size();
+    int position = 0;
+
+    size_t tokenStart = 0;          // Начало текущего токена
+    bool inToken = false;           // Находится ли просмотр внутри токена
+    bool alphanumeric = true;       // Состоит ли текущий токен только из букв и цифр
+    uint64_t previousSeparator = 1; // Является ли разделителем байт перед блоком
+    char tail[64];                  // Последний неполный блок, дополненный разделителями
+
+    for (size_t base = 0; base < size; base += 64) {
+        const char* block = data + base;
+        if (size - base < 64) {
+            memset(tail, ' ', sizeof(tail));
+            memcpy(tail, block, size - base);
+            block = tail;
+        }
+
+        // Границы токенов — позиции, где признак разделителя меняется относительно предыдущего байта
+        BlockMasks masks = scanBlock(block);
+        uint64_t shifted = (masks.separators << 1) | previousSeparator;
+        uint64_t boundaries = masks.separators ^ shifted;
+        previousSeparator = masks.separators >> 63;
+
+        unsigned segmentStart = 0; // Начало части текущего токена внутри блока
+        while (boundaries) {
+            unsigned bit = countTrailingZeros(boundaries);
+            boundaries &= boundaries - 1;
+
+            // Начало токена
+            if (!inToken) {
+                inToken = true;
+                tokenStart = base + bit;
+                segmentStart = bit;
+                alphanumeric = true;
+                continue;
+            }
+
+            // Конец токена
+            alphanumeric &= (~masks.alphanumeric & bitRange(segmentStart, bit)) == 0;
+            onToken(std::string_view(data + tokenStart, base + bit - tokenStart), alphanumeric, ++position);
+            inToken = false;
+        }
+
+        // Токен продолжается в следующем блоке
+        if (inToken) {
+            alphanumeric &= (~masks.alphanumeric & bitRange(segmentStart, 64)) == 0;
+        }
+    }
+
+    // Токен, заканчивающийся на границе последнего полного блока
+    if (inToken) {
+        onToken(std::string_view(data + tokenStart, size - tokenStart), alphanumeric, ++position);
+    }
+}
+
 /**
  * @brief Разбивает строку на токены.
  *
  * Преобразует входную строку с логическим выражением в постфиксной записи в вектор токенов.
  * Проверяет корректность токенов и добавляет ошибки в errorList при их обнаружении.
+ * Строка просматривается за один проход блоками по 64 байта: ядро, выбранное selectScanKernel,
+ * строит битовые маски разделителей и алфавитно-цифровых символов блока, а границы токенов
+ * извлекаются из масок без побайтового цикла.
  * @param [in] expression Строка с логическим выражением в постфиксной записи.
  * @param [in,out] errorList Множество для хранения обнаруженных ошибок.
  * @return Вектор токенов, представляющих входное выражение.
  */
-std::vector<Token> tokenize(const std::string& expression, std::set<Error>& errorList) {
+std::vector<Token> tokenize(std::string_view expression, std::set<Error>& errorList) {
     std::vector<Token> tokens;
-    std::istringstream iss(expression);
-    std::string tokenStr;
+    scanTokens(expression, [&](std::string_view tokenStr, bool alphanumeric, int position) {
+        appendToken(tokenStr, alphanumeric, position, tokens, errorList);
+    });
+
+    // Проверка на отсутствие токенов
+    if (tokens.empty() && errorList.empty()) {
+        errorList.insert(Error(Error::ErrorType::emptyFile));
+    }
+
+    return tokens;
+}
+
+/**
+ * @brief Строит дерево выражения из вектора токенов.
+ *
+ * Создает бинарное дерево логического выражения на основе токенов в постфиксной записи.
+ * При обнаружении ошибок (например, недостаток операндов) добавляет их в errorList.
+ * @param [in] tokens Вектор токенов в постфиксной записи.
+ * @param [in,out] errorList Множество для хранения обнаруженных ошибок.
+ * @return Указатель на корень построенного дерева или nullptr при ошибке.
+ */
+ExpressionNode* buildExpressionTree(const std::vector<Token>& tokens, std::set<Error>& errorList) {
+    std::vector<ExpressionNode*> stack;
+    int lastOperandPosition = 0; // Для отслеживания позиции последнего операнда
+
+    for (const auto& token : tokens) {
+        if (token.type == TokenType::Variable) {
+            stack.push_back(new ExpressionNode(token.type, token.value));
+            lastOperandPosition = token.position; // Обновляем позицию последнего операнда
+            continue;
+        }
+
+        if (token.type == TokenType::Not) {
+            if (stack.empty()) {
+                errorList.insert(Error(Error::ErrorType::insufficientOperands, token.position));
+                continue;
+            }
+
+            ExpressionNode* operand = stack.back();
+            stack.pop_back();
+            stack.push_back(new ExpressionNode(token.type, nullptr, operand));
+            continue;
+        }
+
+        // Бинарные операции
+        if (stack.size() < 2) {
+            errorList.insert(Error(Error::ErrorType::insufficientOperands, token.position));
+            continue;
+        }
+
+        ExpressionNode* right = stack.back();
+        stack.pop_back();
+        ExpressionNode* left = stack.back();
+        stack.pop_back();
+        stack.push_back(new ExpressionNode(token.type, left, right));
+    }
+
+    if (stack.size() != 1) {
+        // Если стек содержит больше одного элемента, указываем позицию после последнего операнда
+        int errorPosition = lastOperandPosition;
+        if (stack.empty()) {
+            errorPosition = tokens.empty() ? 0 : tokens.back().position;
+        }
+        errorList.insert(Error(Error::ErrorType::missingOperation, errorPosition));
+        return nullptr;
+    }
+
+    return stack.back();
+}
+
+/**
+ * @brief Построитель дерева из узлов ExpressionNode для разбора инфиксной записи.
+ */
+struct PointerTreeBuilder {
+    using Ref = ExpressionNode*; ///< Ссылка на узел.
+    static constexpr Ref null = nullptr;
+
+    Ref variable(Symbol name) { return new ExpressionNode(TokenType::Variable, name); }
+    Ref negation(Ref operand) { return new ExpressionNode(TokenType::Not, nullptr, operand); }
+    Ref operation(TokenType type, Ref left, Ref right) { return new ExpressionNode(type, left, right); }
+    void discard(Ref node) { releaseExpressionTree(node); }
+};
+
+/**
+ * @brief Построитель плоского дерева для разбора инфиксной записи.
+ */
+struct FlatTreeBuilder {
+    using Ref = NodeIndex; ///< Ссылка на узел.
+    static constexpr Ref null = nullNode;
+
+    FlatExpression& tree; ///< Плоское дерево.
+
+    Ref variable(Symbol name) { return tree.addNode(TokenType::Variable, name); }
+    Ref negation(Ref operand) { return tree.addNode(TokenType::Not, Symbol(), nullNode, operand); }
+    Ref operation(TokenType type, Ref left, Ref right) { return tree.addNode(type, Symbol(), left, right); }
+    void discard(Ref) {}
+};
+
+/**
+ * @brief Построитель графа с общими подвыражениями для разбора инфиксной записи.
+ */
+struct DagBuilder {
+    using Ref = NodeIndex; ///< Ссылка на узел.
+    static constexpr Ref null = nullNode;
+
+    ExpressionDag& dag; ///< Граф выражения.
+
+    Ref variable(Symbol name) { return dag.makeNode(TokenType::Variable, name); }
+    Ref negation(Ref operand) { return dag.makeNode(TokenType::Not, Symbol(), nullNode, operand); }
+    Ref operation(TokenType type, Ref left, Ref right) { return dag.makeNode(type, Symbol(), left, right); }
+    void discard(Ref) {}
+};
+
+/**
+ * @brief Построитель выражения с отрицаниями на ребрах для разбора инфиксной записи.
+ */
+struct EdgeBuilder {
+    using Ref = Edge; ///< Ссылка на узел.
+    static constexpr Ref null = nullEdge;
+
+    EdgeExpression& graph; ///< Выражение с отрицаниями на ребрах.
+
+    Ref variable(Symbol name) { return graph.addNode(TokenType::Variable, name); }
+    Ref negation(Ref operand) { return EdgeExpression::negate(operand); }
+    Ref operation(TokenType type, Ref left, Ref right) { return graph.addNode(type, Symbol(), left, right); }
+    void discard(Ref) {}
+};
+
+/**
+ * @brief Проверяет, начинается ли с указанного байта стрелка импликации "->".
+ * @param data Строка.
+ * @param size Длина строки.
+ * @param i Индекс байта.
+ * @return true, если data[i] и data[i + 1] образуют "->".
+ */
+static bool isArrow(const char* data, size_t size, size_t i) {
+    return data[i] == '-' && i + 1 < size && data[i + 1] == '>';
+}
+
+/**
+ * @brief Разбирает инфиксную запись и строит дерево выражения построителем.
+ *
+ * Лексемы выделяются за один проход по строке и сразу обрабатываются алгоритмом сортировочной станции
+ * с явными стеками операндов и отложенных операций, поэтому глубина скобок и цепочек отрицаний
+ * не ограничена размером стека вызовов, а вектор токенов не создается. Приоритеты берутся из таблицы
+ * operationPriorities, бинарные операции левоассоциативны, как при выводе expressionTreeToInfix.
+ * Позиция в ошибках — порядковый номер лексемы, как у токенов постфиксной записи. Ошибки в лексемах
+ * собираются по всей строке; ошибка структуры (пропущенный операнд или операция, непарная скобка)
+ * сообщается только первая и только при отсутствии ошибок в лексемах.
+ * @param expression Строка с логическим выражением в инфиксной записи.
+ * @param errorList Множество для хранения обнаруженных ошибок.
+ * @param builder Построитель узлов.
+ * @return Ссылка на корень построенного дерева или Builder::null при ошибке.
+ */
+template <typename Builder>
+static typename Builder::Ref parseInfix(std::string_view expression, std::set<Error>& errorList, Builder& builder) {
+    using Ref = typename Builder::Ref;
+
+    // Отложенная операция; тип Any обозначает открывающую скобку
+    struct PendingOperation {
+        TokenType type;
+        int position;
+    };
+
+    std::vector<Ref> operands;
+    std::vector<PendingOperation> operations;
+    std::vector<Error> structureErrors;
+    bool lexemeErrors = false;
+    bool expectOperand = true;
     int position = 0;
 
-    while (iss >> tokenStr) {
-        position++;
+    // Заменяет верхнюю отложенную операцию и ее операнды узлом операции
+    auto reduce = [&]() {
+        PendingOperation operation = operations.back();
+        operations.pop_back();
+
+        Ref right = operands.back();
+        operands.pop_back();
+        if (operation.type == TokenType::Not) {
+            operands.push_back(builder.negation(right));
+            return;
+        }
+
+        Ref left = operands.back();
+        operands.back() = builder.operation(operation.type, left, right);
+    };
+
+    // Позиция операции, которой не хватает операнда
+    auto missingOperandPosition = [&]() {
+        if (!operations.empty() && operations.back().type != TokenType::Any) return operations.back().position;
+        return position;
+    };
+
+    const char* data = expression.data();
+    const size_t size = expression.size();
+    size_t i = 0;
+
+    while (i < size) {
+        unsigned char c = static_cast<unsigned char>(data[i]);
+        if (charClassTable[c] & charSeparator) {
+            i++;
+            continue;
+        }
+        ++position;
+
+        // Имя переменной или нераспознанная лексема продолжается до разделителя, операции или скобки
+        if (!(charClassTable[c] & charOperation) && c != '(' && c != ')' && !isArrow(data, size, i)) {
+            size_t start = i;
+            bool alphanumeric = true;
+            while (i < size) {
+                unsigned char next = charClassTable[static_cast<unsigned char>(data[i])];
+                if ((next & (charSeparator | charOperation)) || data[i] == '(' || data[i] == ')' || isArrow(data, size, i)) break;
+                alphanumeric &= (next & (charLetter | charDigit)) != 0;
+                i++;
+            }
+
+            unsigned char first = charClassTable[c];
+            if (!(first & charLetter) || !alphanumeric) {
+                Error::ErrorType type = Error::ErrorType::unsupportedOperation;
+                if (first & charLetter) type = Error::ErrorType::invalidVariableChar;
+                else if (first & charDigit) type = Error::ErrorType::invalidVariableName;
+                errorList.insert(Error(type, position));
+                lexemeErrors = true;
+                continue;
+            }
+
+            if (lexemeErrors || !structureErrors.empty()) continue;
+
+            if (!expectOperand) {
+                structureErrors.push_back(Error(Error::ErrorType::missingOperation, position));
+                continue;
+            }
+
+            operands.push_back(builder.variable(std::string_view(data + start, i - start)));
+            expectOperand = false;
+            continue;
+        }
+
+        // Операция или скобка; "||" и "->" — обозначения из вывода, "|" и ">" — из постфиксной записи
+        TokenType type = TokenType::Any;
+        if (isArrow(data, size, i)) {
+            type = TokenType::Implication;
+            i += 2;
+        }
+        else if (c == '|' && i + 1 < size && data[i + 1] == '|') {
+            type = TokenType::Or;
+            i += 2;
+        }
+        else {
+            if (c != '(' && c != ')') type = operationType(static_cast<char>(c));
+            i++;
+        }
+
+        if (lexemeErrors || !structureErrors.empty()) continue;
+
+        if (expectOperand) {
+            if (c == '(' || type == TokenType::Not) {
+                operations.push_back({ type, position });
+            }
+            else {
+                structureErrors.push_back(Error(Error::ErrorType::insufficientOperands, missingOperandPosition()));
+            }
+            continue;
+        }
+
+        if (c == '(' || type == TokenType::Not) {
+            structureErrors.push_back(Error(Error::ErrorType::missingOperation, position));
+            continue;
+        }
+
+        if (c == ')') {
+            while (!operations.empty() && operations.back().type != TokenType::Any) reduce();
+            if (operations.empty()) {
+                structureErrors.push_back(Error(Error::ErrorType::unbalancedBrackets, position));
+                continue;
+            }
+            operations.pop_back();
+            continue;
+        }
+
+        // Бинарная операция: сначала сворачиваются отложенные операции с не меньшим приоритетом
+        int priority = operationPriority(type);
+        while (!operations.empty() && operations.back().type != TokenType::Any && operationPriority(operations.back().type) >= priority) {
+            reduce();
+        }
+        operations.push_back({ type, position });
+        expectOperand = true;
+    }
+
+    if (!lexemeErrors && structureErrors.empty()) {
+        if (position == 0) {
+            errorList.insert(Error(Error::ErrorType::emptyFile));
+        }
+        else if (expectOperand) {
+            structureErrors.push_back(Error(Error::ErrorType::insufficientOperands, missingOperandPosition()));
+        }
+        else {
+            while (!operations.empty() && operations.back().type != TokenType::Any) reduce();
+            if (!operations.empty()) {
+                structureErrors.push_back(Error(Error::ErrorType::unbalancedBrackets, operations.back().position));
+            }
+        }
+    }
+
+    if (lexemeErrors || !structureErrors.empty() || position == 0) {
+        errorList.insert(structureErrors.begin(), structureErrors.end());
+        for (Ref operand : operands) builder.discard(operand);
+        return Builder::null;
+    }
+
+    return operands.back();
+}
+
+/**
+ * @brief Строит дерево выражения из инфиксной записи.
+ * @param [in] expression Строка с логическим выражением в инфиксной записи.
+ * @param [in,out] errorList Множество для хранения обнаруженных ошибок.
+ * @return Указатель на корень построенного дерева или nullptr при ошибке.
+ */
+ExpressionNode* parseInfixExpression(std::string_view expression, std::set<Error>& errorList) {
+    PointerTreeBuilder builder;
+    return parseInfix(expression, errorList, builder);
+}
+
+/**
+ * @brief Строит плоское дерево выражения из инфиксной записи.
+ * @param [in] expression Строка с логическим выражением в инфиксной записи.
+ * @param [in,out] errorList Множество для хранения обнаруженных ошибок.
+ * @param [in,out] tree Плоское дерево, в которое добавляются узлы.
+ * @return Индекс корня построенного дерева или nullNode при ошибке.
+ */
+NodeIndex parseInfixExpression(std::string_view expression, std::set<Error>& errorList, FlatExpression& tree) {
+    FlatTreeBuilder builder{ tree };
+    return parseInfix(expression, errorList, builder);
+}
+
+/**
+ * @brief Строит граф выражения с общими подвыражениями из инфиксной записи.
+ * @param [in] expression Строка с логическим выражением в инфиксной записи.
+ * @param [in,out] errorList Множество для хранения обнаруженных ошибок.
+ * @param [in,out] dag Граф, в который добавляются узлы.
+ * @return Индекс корня построенного графа или nullNode при ошибке.
+ */
+NodeIndex parseInfixExpression(std::string_view expression, std::set<Error>& errorList, ExpressionDag& dag) {
+    DagBuilder builder{ dag };
+    return parseInfix(expression, errorList, builder);
+}
+
+/**
+ * @brief Строит выражение с отрицаниями на ребрах из инфиксной записи.
+ * @param [in] expression Строка с логическим выражением в инфиксной записи.
+ * @param [in,out] errorList Множество для хранения обнаруженных ошибок.
+ * @param [in,out] graph Выражение, в которое добавляются узлы.
+ * @return Ребро к корню построенного выражения или nullEdge при ошибке.
+ */
+Edge parseInfixExpression(std::string_view expression, std::set<Error>& errorList, EdgeExpression& graph) {
+    EdgeBuilder builder{ graph };
+    return parseInfix(expression, errorList, builder);
+}
+
+/**
+ * @brief Разбирает постфиксную запись и строит дерево выражения построителем без вектора токенов.
+ *
+ * Токены выделяются scanTokens и сразу применяются к стеку операндов, поэтому объекты Token не создаются,
+ * а дополнительная память ограничена глубиной стека. Ошибки и их позиции совпадают с ошибками tokenize
+ * и последующего buildExpressionTree: при ошибках в токенах ошибки построения не сообщаются.
+ * @param expression Строка с логическим выражением в постфиксной записи.
+ * @param errorList Множество для хранения обнаруженных ошибок.
+ * @param builder Построитель узлов.
+ * @return Ссылка на корень построенного дерева или Builder::null при ошибке.
+ */
+template <typename Builder>
+static typename Builder::Ref parsePostfix(std::string_view expression, std::set<Error>& errorList, Builder& builder) {
+    using Ref = typename Builder::Ref;
+
+    std::vector<Ref> stack;
+    std::vector<Error> structureErrors;
+    bool tokenErrors = false;
+    bool anyTokens = false;
+    int lastOperandPosition = 0; // Для отслеживания позиции последнего операнда
+    int lastPosition = 0;        // Позиция последнего корректного токена
+
+    scanTokens(expression, [&](std::string_view tokenStr, bool alphanumeric, int position) {
+        TokenType type = classifyToken(tokenStr, alphanumeric, position, errorList);
+        if (type == TokenType::Any) {
+            tokenErrors = true;
+            return;
+        }
+
+        anyTokens = true;
+        lastPosition = position;
+        if (tokenErrors) return;
+
+        if (type == TokenType::Variable) {
+            stack.push_back(builder.variable(tokenStr));
+            lastOperandPosition = position;
+            return;
+        }
+
+        if (type == TokenType::Not) {
+            if (stack.empty()) {
+                structureErrors.push_back(Error(Error::ErrorType::insufficientOperands, position));
+                return;
+            }
+
+            stack.back() = builder.negation(stack.back());
+            return;
+        }
+
+        // Бинарные операции
+        if (stack.size() < 2) {
+            structureErrors.push_back(Error(Error::ErrorType::insufficientOperands, position));
+            return;
+        }
+
+        Ref right = stack.back();
+        stack.pop_back();
+        Ref left = stack.back();
+        stack.back() = builder.operation(type, left, right);
+    });
+
+    if (!tokenErrors) {
+        if (!anyTokens) {
+            errorList.insert(Error(Error::ErrorType::emptyFile));
+        }
+        else if (stack.size() != 1) {
+            // Если стек содержит больше одного элемента, указываем позицию после последнего операнда
+            structureErrors.push_back(Error(Error::ErrorType::missingOperation, stack.empty() ? lastPosition : lastOperandPosition));
+        }
+    }
+
+    if (tokenErrors || !anyTokens || !structureErrors.empty()) {
+        if (!tokenErrors) errorList.insert(structureErrors.begin(), structureErrors.end());
+        for (Ref operand : stack) builder.discard(operand);
+        return Builder::null;
+    }
+
+    return stack.back();
+}
+
+/**
+ * @brief Строит дерево выражения из постфиксной записи без вектора токенов.
+ * @param [in] expression Строка с логическим выражением в постфиксной записи.
+ * @param [in,out] errorList Множество для хранения обнаруженных ошибок.
+ * @return Указатель на корень построенного дерева или nullptr при ошибке.
+ */
+ExpressionNode* parsePostfixExpression(std::string_view expression, std::set<Error>& errorList) {
+    PointerTreeBuilder builder;
+    return parsePostfix(expression, errorList, builder);
+}
+
+/**
+ * @brief Строит плоское дерево выражения из постфиксной записи без вектора токенов.
+ * @param [in] expression Строка с логическим выражением в постфиксной записи.
+ * @param [in,out] errorList Множество для хранения обнаруженных ошибок.
+ * @param [in,out] tree Плоское дерево, в которое добавляются узлы.
+ * @return Индекс корня построенного дерева или nullNode при ошибке.
+ */
+NodeIndex parsePostfixExpression(std::string_view expression, std::set<Error>& errorList, FlatExpression& tree) {
+    FlatTreeBuilder builder{ tree };
+    return parsePostfix(expression, errorList, builder);
+}
+
+/**
+ * @brief Строит граф выражения с общими подвыражениями из постфиксной записи без вектора токенов.
+ * @param [in] expression Строка с логическим выражением в постфиксной записи.
+ * @param [in,out] errorList Множество для хранения обнаруженных ошибок.
+ * @param [in,out] dag Граф, в который добавляются узлы.
+ * @return Индекс корня построенного графа или nullNode при ошибке.
+ */
+NodeIndex parsePostfixExpression(std::string_view expression, std::set<Error>& errorList, ExpressionDag& dag) {
+    DagBuilder builder{ dag };
+    return parsePostfix(expression, errorList, builder);
+}
+
+/**
+ * @brief Строит выражение с отрицаниями на ребрах из постфиксной записи без вектора токенов.
+ * @param [in] expression Строка с логическим выражением в постфиксной записи.
+ * @param [in,out] errorList Множество для хранения обнаруженных ошибок.
+ * @param [in,out] graph Выражение, в которое добавляются узлы.
+ * @return Ребро к корню построенного выражения или nullEdge при ошибке.
+ */
+Edge parsePostfixExpression(std::string_view expression, std::set<Error>& errorList, EdgeExpression& graph) {
+    EdgeBuilder builder{ graph };
+    return parsePostfix(expression, errorList, builder);
+}
+
+/**
+ * @brief Создает глубокую копию узла дерева.
+ *
+ * Копирует узел и все его поддеревья, создавая независимую копию. Обход выполняется с явным стеком,
+ * поэтому глубина дерева не ограничена размером стека вызовов.
+ * @param [in] node Указатель на узел для копирования.
+ * @return Указатель на новый узел или nullptr, если входной узел равен nullptr.
+ */
+ExpressionNode* copyNode(ExpressionNode* node) {
+    if (!node) return nullptr;
+
+    // Элемент стека: исходный узел и поле, в которое записывается его копия.
+    // Стек потока берется по ссылке один раз, чтобы не обращаться к thread_local на каждой итерации
+    thread_local std::vector<std::pair<const ExpressionNode*, ExpressionNode**>> threadStack;
+    auto& stack = threadStack;
+
+    ExpressionNode* result = nullptr;
+    stack.clear();
+    stack.push_back({ node, &result });
+
+    while (!stack.empty()) {
+        const ExpressionNode* current = stack.back().first;
+        ExpressionNode** slot = stack.back().second;
+        stack.pop_back();
+
+        // Спуск по правым поддеревьям без стека, левые поддеревья откладываются. Узлы посещаются
+        // в порядке, обратном постфиксному: дерево, построенное из постфиксной записи, читается подряд
+        while (current) {
+            ExpressionNode* copy = new ExpressionNode(current->type, current->value);
+            *slot = copy;
+
+            if (current->left) stack.push_back({ current->left, &copy->left });
+            slot = &copy->right;
+            current = current->right;
+        }
+    }
+
+    return result;
+}
+
+/**
+ * @brief Обходит дерево в обратном порядке (сначала поддеревья, затем узел) с явным стеком.
+ *
+ * Поддеревья узла обходятся до вызова visit для него, поэтому visit может заменять поддеревья
+ * узла: новые поддеревья не обходятся. В стеке хранится только путь от корня до текущего узла,
+ * листья в него не попадают. Стек принадлежит потоку и не освобождается между вызовами,
+ * поэтому visit не должна сама вызывать visitPostOrder для дерева из ExpressionNode.
+ * @param root Корень дерева.
+ * @param visit Функция, вызываемая для каждого узла.
+ */
+template <typename Visit>
+static void visitPostOrder(ExpressionNode* root, Visit visit) {
+    thread_local std::vector<ExpressionNode*> threadPath;
+    std::vector<ExpressionNode*>& storage = threadPath;
+    if (storage.size() < 64) storage.resize(64);
+
+    // Вершина стека хранится в локальной переменной: visit выделяет и освобождает память,
+    // и размер вектора пришлось бы перечитывать из памяти после каждого вызова
+    ExpressionNode** bottom = storage.data();
+    ExpressionNode** top = bottom;
+    ExpressionNode** limit = bottom + storage.size();
+
+    ExpressionNode* current = root;
+    const ExpressionNode* visited = nullptr; // Последний обработанный узел
+    while (true) {
+        // Спуск по левым поддеревьям; лист обрабатывается сразу
+        while (current) {
+            if (!current->left && !current->right) {
+                visit(current);
+                visited = current;
+                break;
+            }
+            if (top == limit) {
+                size_t depth = top - bottom;
+                storage.resize(storage.size() * 2);
+                bottom = storage.data();
+                top = bottom + depth;
+                limit = bottom + storage.size();
+            }
+            *top++ = current;
+            current = current->left;
+        }
+        current = nullptr;
+
+        // Подъем: правое поддерево обходится, если из него еще не вернулись
+        while (top != bottom) {
+            ExpressionNode* node = top[-1];
+            if (node->right && node->right != visited) {
+                current = node->right;
+                break;
+            }
+            --top;
+            visit(node);
+            visited = node;
+        }
+        if (!current) break;
+    }
+}
+
+/**
+ * @brief Заменяет импликацию или эквивалентность в одном узле, поддеревья которого уже преобразованы.
+ * @param node Узел дерева.
+ * @param copy Функция глубокого копирования поддерева.
+ */
+template <typename Copy>
+static void rewriteImplicationAndEquivalenceNode(ExpressionNode* node, Copy copy) {
+    // Преобразование импликации A > B в !A | B
+    if (node->type == TokenType::Implication) {
+        ExpressionNode* newNot = new ExpressionNode(TokenType::Not, nullptr, copy(node->left));
+        node->type = TokenType::Or;
+        node->left = newNot; // node->right остается без изменений
+        return;
+    }
+
+    // Преобразование эквивалентности A ~ B в (A & B) | (!A & !B)
+    if (node->type == TokenType::Equivalence) {
+        // Создаем левый узел конъюнкции (A & B)
+        ExpressionNode* newLeft = new ExpressionNode(TokenType::And, copy(node->left), copy(node->right));
+
+        // Создаем правый узел конъюнкции (!A & !B)
+        ExpressionNode* newRightL = new ExpressionNode(TokenType::Not, nullptr, copy(node->left));
+        ExpressionNode* newRightR = new ExpressionNode(TokenType::Not, nullptr, copy(node->right));
+        ExpressionNode* newRight = new ExpressionNode(TokenType::And, newRightL, newRightR);
+
+        // Обновляем текущий узел
+        node->type = TokenType::Or;
+        node->left = newLeft;
+        node->right = newRight;
+    }
+}
+
+/**
+ * @brief Преобразует операции импликации и эквивалентности.
+ *
+ * Преобразует импликацию (A > B) в (!A | B) и эквивалентность (A ~ B) в ((A & B) | (!A & !B)).
+ * Обрабатывает все узлы дерева за один обход с явным стеком: поддеревья узла преобразуются до него.
+ * @param [in,out] node Указатель на корень дерева для преобразования.
+ */
+void transformImplicationAndEquivalence(ExpressionNode* node) {
+    visitPostOrder(node, [](ExpressionNode* current) {
+        rewriteImplicationAndEquivalenceNode(current, [](ExpressionNode* subtree) { return copyNode(subtree); });
+    });
+}
+
+/**
+ * @brief Наибольшее число узлов в запасе потока.
+ */
+static const size_t maxSpareNodes = 1 << 16;
+
+/**
+ * @brief Запас узлов потока для повторного использования.
+ *
+ * Узлы, удаленные из дерева при преобразованиях вне пула, связываются в список через поле right
+ * и используются следующими преобразованиями вместо выделения памяти.
+ */
+struct SpareNodes {
+    ExpressionNode* head = nullptr; ///< Первый узел списка.
+    size_t count = 0;               ///< Число узлов в списке.
+
+    ~SpareNodes() { clear(); }
+
+    /**
+     * @brief Освобождает все узлы запаса.
+     */
+    void clear() {
+        while (head) {
+            ExpressionNode* node = head;
+            head = node->right;
+            node->right = nullptr;
+            delete node;
+        }
+        count = 0;
+    }
+};
+
+/**
+ * @brief Возвращает запас узлов текущего потока.
+ * @return Ссылка на запас.
+ */
+static SpareNodes& spareNodes() {
+    thread_local SpareNodes spares;
+    return spares;
+}
+
+/**
+ * @brief Возвращает удаленный из дерева узел в запас потока.
+ *
+ * Узлы при активном пуле возвращаются в его список свободных ячеек: после сброса пула
+ * запас ссылался бы на недействительную память.
+ * @param node Узел без поддеревьев.
+ */
+static void recycleNode(ExpressionNode* node) {
+    SpareNodes& spares = spareNodes();
+    if (NodeArena::current() || spares.count >= maxSpareNodes) {
+        delete node;
+        return;
+    }
+
+    node->right = spares.head;
+    spares.head = node;
+    ++spares.count;
+}
+
+/**
+ * @brief Создает узел отрицания, по возможности из запаса потока.
+ * @param operand Отрицаемое поддерево.
+ * @return Указатель на узел отрицания.
+ */
+static ExpressionNode* makeNotNode(ExpressionNode* operand) {
+    SpareNodes& spares = spareNodes();
+    if (spares.head && !NodeArena::current()) {
+        ExpressionNode* node = spares.head;
+        spares.head = node->right;
+        --spares.count;
+
+        node->type = TokenType::Not;
+        node->value = Symbol();
+        node->left = nullptr;
+        node->right = operand;
+        return node;
+    }
+
+    return new ExpressionNode(TokenType::Not, nullptr, operand);
+}
+
+/**
+ * @brief Возвращает число узлов в запасе текущего потока.
+ * @return Число узлов, доступных для повторного использования.
+ */
+size_t spareNodeCount() {
+    return spareNodes().count;
+}
+
+/**
+ * @brief Освобождает запас узлов текущего потока.
+ */
+void releaseSpareNodes() {
+    spareNodes().clear();
+}
+
+/**
+ * @brief Применяет законы де Моргана к одному узлу.
+ *
+ * Преобразует узел вида !(A & B) в !A | !B и !(A | B) в !A & !B; поддеревья не обходятся.
+ * Узел операции становится отрицанием левого операнда, поэтому новым создается только
+ * отрицание правого операнда, и оно берется из запаса потока, если тот не пуст.
+ * @param node Узел дерева.
+ * @param changed Устанавливается в true, если узел преобразован.
+ */
+static void applyDeMorgan(ExpressionNode* node, bool& changed) {
+    if (node->type != TokenType::Not || !node->right) return;
+
+    ExpressionNode* operation = node->right;
+    TokenType dual;
+    // Первый закон де Моргана: !(A & B) → !A | !B, второй: !(A | B) → !A & !B
+    if (operation->type == TokenType::And) dual = TokenType::Or;
+    else if (operation->type == TokenType::Or) dual = TokenType::And;
+    else return;
+
+    ExpressionNode* leftOperand = operation->left;
+    ExpressionNode* rightOperand = operation->right;
+
+    // Узел операции становится отрицанием левого операнда
+    operation->type = TokenType::Not;
+    operation->left = nullptr;
+    operation->right = leftOperand;
+
+    node->type = dual;
+    node->left = operation;
+    node->right = makeNotNode(rightOperand);
+
+    changed = true;
+}
+
+/**
+ * @brief Применяет законы де Моргана.
+ *
+ * Преобразует выражения вида !(A & B) в !A | !B и !(A | B) в !A & !B.
+ * Обходит дерево с явным стеком: поддеревья узла упрощаются до него, а созданные
+ * при этом отрицания обрабатываются следующим вызовом.
+ * @param [in,out] node Указатель на корень дерева для упрощения.
+ * @return true, если были внесены изменения, иначе false.
+ */
+bool simplifyExpression(ExpressionNode* node, bool& changed) {
+    if (!node) return false;
+
+    // Применяем законы де Моргана к каждому узлу после его поддеревьев
+    visitPostOrder(node, [&changed](ExpressionNode* current) {
+        if (current->type == TokenType::Not) applyDeMorgan(current, changed);
+    });
+
+    return changed;
+}
+
+/**
+ * @brief Наименьший размер поддерева, которое обрабатывается отдельной задачей fork-join.
+ *
+ * Поддеревья меньшего размера обрабатываются последовательными вариантами проходов, чтобы накладные
+ * расходы на задачу оставались малыми по сравнению с работой над поддеревом.
+ */
+constexpr size_t forkJoinCutoff = 1 << 12;
+
+/**
+ * @brief Наибольшая глубина рекурсии параллельных вариантов проходов.
+ *
+ * Параллельные варианты рекурсивны; глубже этого уровня поддерево обрабатывается последовательным
+ * вариантом с явным стеком, поэтому вырожденные деревья не переполняют стек вызовов.
+ * Для сбалансированных деревьев предел не достигается.
+ */
+constexpr unsigned forkJoinMaxDepth = 256;
+
+/**
+ * @brief Подсчитывает узлы поддерева, останавливаясь на заданном пределе.
+ * @param node Корень поддерева.
+ * @param limit Предел подсчета.
+ * @return Количество узлов поддерева или limit, если их не меньше limit.
+ */
+static size_t countNodes(const ExpressionNode* node, size_t limit) {
+    thread_local std::vector<const ExpressionNode*> stack;
+    stack.clear();
+    if (node) stack.push_back(node);
+
+    size_t count = 0;
+    while (!stack.empty() && count < limit) {
+        const ExpressionNode* current = stack.back();
+        stack.pop_back();
+        count++;
+
+        if (current->left) stack.push_back(current->left);
+        if (current->right) stack.push_back(current->right);
+    }
+    return count;
+}
+
+/**
+ * @brief Определяет, какие поддеревья узла меньше forkJoinCutoff.
+ *
+ * Оба поддерева подсчитываются с удваивающимся пределом, пока одно из них не окажется подсчитанным
+ * полностью или оба не достигнут forkJoinCutoff. Подсчет стоит не больше четырех размеров меньшего поддерева,
+ * которое затем обрабатывается последовательно, а узлов с двумя большими поддеревьями не больше
+ * n / forkJoinCutoff, поэтому общая стоимость подсчетов линейна даже для вырожденных деревьев.
+ * @param node Узел дерева.
+ * @param leftSmall Устанавливается в true, если левое поддерево меньше forkJoinCutoff.
+ * @param rightSmall Устанавливается в true, если правое поддерево меньше forkJoinCutoff.
+ */
+static void classifySubtrees(const ExpressionNode* node, bool& leftSmall, bool& rightSmall) {
+    leftSmall = false;
+    rightSmall = false;
+
+    for (size_t limit = 1; limit <= forkJoinCutoff; limit *= 2) {
+        leftSmall = countNodes(node->left, limit) < limit;
+        rightSmall = countNodes(node->right, limit) < limit;
+        if (leftSmall || rightSmall) return;
+    }
+}
+
+/**
+ * @brief Обрабатывает поддеревья узла, распараллеливая обработку двух больших поддеревьев.
+ *
+ * Размеры поддеревьев проверяются, только когда в очередях пула нет задач, то есть кто-то из потоков
+ * может простаивать. Если оба поддерева не меньше forkJoinCutoff, левое становится задачей, доступной
+ * для перехвата, а правое обрабатывается в текущем потоке. Иначе поддеревья обрабатываются по очереди.
+ * @param node Узел дерева.
+ * @param pool Пул потоков.
+ * @param leftTask Обработчик левого поддерева; получает true, если поддерево может быть большим.
+ * @param rightTask Обработчик правого поддерева; получает true, если поддерево может быть большим.
+ */
+template <typename LeftTask, typename RightTask>
+static void forkJoinChildren(const ExpressionNode* node, ForkJoinPool& pool, LeftTask leftTask, RightTask rightTask) {
+    // Задач для перехвата достаточно: поддеревья обрабатываются в текущем потоке без подсчета размеров
+    if (pool.pendingTasks() > 0) {
+        leftTask(true);
+        rightTask(true);
+        return;
+    }
+
+    bool leftSmall, rightSmall;
+    classifySubtrees(node, leftSmall, rightSmall);
+
+    if (!leftSmall && !rightSmall) {
+        pool.invoke([&]() { leftTask(true); }, [&]() { rightTask(true); });
+        return;
+    }
+
+    leftTask(!leftSmall);
+    rightTask(!rightSmall);
+}
+
+/**
+ * @brief Проверяет, можно ли выполнять проходы над деревом в нескольких потоках.
+ *
+ * Пул узлов не потокобезопасен, поэтому при активном в текущем потоке пуле (ArenaScope) проходы
+ * выполняются последовательно; иначе узлы выделяются в общей куче.
+ * @param pool Пул потоков.
+ * @return true, если в пуле больше одного потока и пул узлов не активен.
+ */
+static bool canForkJoin(const ForkJoinPool& pool) {
+    return pool.size() > 1 && !NodeArena::current();
+}
+
+/**
+ * @brief Копирует поддерево, распределяя большие поддеревья между потоками.
+ * @param node Корень поддерева.
+ * @param pool Пул потоков.
+ * @param depth Глубина рекурсии.
+ * @return Копия поддерева.
+ */
+static ExpressionNode* copyNodeParallel(ExpressionNode* node, ForkJoinPool& pool, unsigned depth = 0) {
+    if (!node) return nullptr;
+    if (depth >= forkJoinMaxDepth) return copyNode(node);
+
+    ExpressionNode* left = nullptr;
+    ExpressionNode* right = nullptr;
+    forkJoinChildren(node, pool,
+        [&](bool large) { left = large ? copyNodeParallel(node->left, pool, depth + 1) : copyNode(node->left); },
+        [&](bool large) { right = large ? copyNodeParallel(node->right, pool, depth + 1) : copyNode(node->right); });
+
+    return new ExpressionNode(node->type, node->value, left, right);
+}
+
+/**
+ * @brief Создает глубокую копию узла дерева в нескольких потоках.
+ *
+ * Результат совпадает с copyNode(node). Поддеревья меньше forkJoinCutoff копируются последовательно.
+ * @param [in] node Указатель на узел для копирования.
+ * @param [in] pool Пул потоков.
+ * @return Указатель на новый узел или nullptr, если входной узел равен nullptr.
+ */
+ExpressionNode* copyNode(ExpressionNode* node, ForkJoinPool& pool) {
+    if (!canForkJoin(pool)) return copyNode(node);
+    return copyNodeParallel(node, pool);
+}
+
+/**
+ * @brief Преобразует импликацию и эквивалентность в поддереве, распределяя большие поддеревья между потоками.
+ * @param node Корень поддерева.
+ * @param pool Пул потоков.
+ * @param depth Глубина рекурсии.
+ */
+static void transformParallel(ExpressionNode* node, ForkJoinPool& pool, unsigned depth = 0) {
+    if (!node) return;
+    if (depth >= forkJoinMaxDepth) {
+        transformImplicationAndEquivalence(node);
+        return;
+    }
+
+    forkJoinChildren(node, pool,
+        [&](bool large) {
+            if (large) transformParallel(node->left, pool, depth + 1);
+            else transformImplicationAndEquivalence(node->left);
+        },
+        [&](bool large) {
+            if (large) transformParallel(node->right, pool, depth + 1);
+            else transformImplicationAndEquivalence(node->right);
+        });
+
+    rewriteImplicationAndEquivalenceNode(node, [&pool](ExpressionNode* subtree) { return copyNodeParallel(subtree, pool); });
+}
+
+/**
+ * @brief Преобразует операции импликации и эквивалентности в нескольких потоках.
+ *
+ * Результат совпадает с transformImplicationAndEquivalence(node): поддеревья преобразуются независимо,
+ * поэтому большие поддеревья и их копии обрабатываются параллельно.
+ * @param [in,out] node Указатель на корень дерева для преобразования.
+ * @param [in] pool Пул потоков.
+ */
+void transformImplicationAndEquivalence(ExpressionNode* node, ForkJoinPool& pool) {
+    if (!canForkJoin(pool)) {
+        transformImplicationAndEquivalence(node);
+        return;
+    }
+    transformParallel(node, pool);
+}
+
+/**
+ * @brief Применяет законы де Моргана в поддереве, распределяя большие поддеревья между потоками.
+ * @param node Корень поддерева.
+ * @param changed Устанавливается в true, если были внесены изменения.
+ * @param pool Пул потоков.
+ * @param depth Глубина рекурсии.
+ */
+static void simplifyParallel(ExpressionNode* node, bool& changed, ForkJoinPool& pool, unsigned depth = 0) {
+    if (depth >= forkJoinMaxDepth) {
+        simplifyExpression(node, changed);
+        return;
+    }
+
+    // У каждой задачи свой признак изменений: общий признак не записывается из разных потоков
+    bool leftChanged = false;
+    bool rightChanged = false;
+
+    forkJoinChildren(node, pool,
+        [&](bool large) {
+            if (!node->left) return;
+            if (large) simplifyParallel(node->left, leftChanged, pool, depth + 1);
+            else simplifyExpression(node->left, leftChanged);
+        },
+        [&](bool large) {
+            if (!node->right) return;
+            if (large) simplifyParallel(node->right, rightChanged, pool, depth + 1);
+            else simplifyExpression(node->right, rightChanged);
+        });
+
+    changed |= leftChanged || rightChanged;
+    applyDeMorgan(node, changed);
+}
+
+/**
+ * @brief Применяет законы де Моргана в нескольких потоках.
+ *
+ * Результат совпадает с simplifyExpression(node, changed).
+ * @param [in,out] node Указатель на корень дерева для упрощения.
+ * @param [in,out] changed Устанавливается в true, если были внесены изменения.
+ * @param [in] pool Пул потоков.
+ * @return true, если были внесены изменения, иначе false.
+ */
+bool simplifyExpression(ExpressionNode* node, bool& changed, ForkJoinPool& pool) {
+    if (!node) return false;
+
+    if (!canForkJoin(pool)) return simplifyExpression(node, changed);
+
+    simplifyParallel(node, changed, pool);
+    return changed;
+}
+
+/**
+ * @brief Удаляет двойные отрицания.
+ *
+ * Преобразует выражения вида !!A в A, рекурсивно обрабатывая поддеревья.
+ * Удаленные узлы отрицания не освобождаются, а сохраняются в запасе потока.
+ * @param [in,out] node Указатель на корень дерева для преобразования.
+ */
+void removeDoubleNot(ExpressionNode* node) {
+    if (!node) return;
+
+    std::stack<std::pair<ExpressionNode*, bool>> stack; // Пара: узел, обработан ли
+    stack.push({ node, false });
+
+    while (!stack.empty()) {
+        ExpressionNode* current = stack.top().first;
+        bool processed = stack.top().second;
+        stack.pop();
+
+        if (!current) continue;
+
+        if (!processed) {
+            // Помечаем как обработанный и добавляем поддеревья
+            stack.push({ current, true });
+            if (current->right) stack.push({ current->right, false });
+            if (current->left) stack.push({ current->left, false });
+        }
+        else {
+            // Проверяем и удаляем двойное отрицание
+            if (current->type == TokenType::Not && current->right && current->right->type == TokenType::Not) {
+                ExpressionNode* temp = current->right;
+                if (temp && temp->right) { // Проверяем валидность
+                    ExpressionNode* inner = temp->right;
+                    if (inner) {
+                        current->type = inner->type;
+                        current->value = inner->value;
+                        current->left = inner->left;
+                        current->right = inner->right;
+
+                        // Оба отрицания убираются из дерева и сохраняются для повторного использования
+                        inner->left = nullptr;
+                        inner->right = nullptr;
+                        temp->right = nullptr;
+                        recycleNode(temp);
+                        recycleNode(inner);
+                    }
+                }
+            }
+        }
+    }
+}
+
+/**
+ * @brief Доступ к узлам дерева из ExpressionNode для обходов, общих с плоским деревом.
+ */
+struct PointerTreeView {
+    using Ref = const ExpressionNode*; ///< Ссылка на узел.
+    static constexpr Ref null = nullptr;
+
+    TokenType type(Ref node) const { return node->type; }
+    Ref left(Ref node) const { return node->left; }
+    Ref right(Ref node) const { return node->right; }
+    std::string_view name(Ref node) const { return node->value.name(); }
+    uint32_t symbol(Ref node) const { return node->value.id; }
+};
+
+/**
+ * @brief Доступ к узлам плоского дерева для обходов, общих с деревом из ExpressionNode.
+ */
+struct FlatTreeView {
+    using Ref = NodeIndex; ///< Ссылка на узел.
+    static constexpr Ref null = nullNode;
+
+    const FlatExpression& tree; ///< Плоское дерево.
+
+    TokenType type(Ref node) const { return tree.type(node); }
+    Ref left(Ref node) const { return tree.lefts[node]; }
+    Ref right(Ref node) const { return tree.rights[node]; }
+    std::string_view name(Ref node) const { return SymbolTable::instance().name(tree.symbols[node]); }
+    uint32_t symbol(Ref node) const { return tree.symbols[node]; }
+};
+
+/**
+ * @brief Доступ к выражению с отрицаниями на ребрах как к отрицательной нормальной форме.
+ *
+ * Отрицательное ребро к конъюнкции или дизъюнкции читается как двойственная операция над отрицаниями
+ * поддеревьев, а отрицательное ребро к переменной — как узел отрицания с этой переменной справа.
+ * Поэтому законы де Моргана и удаление двойных отрицаний выполняются при выводе, без изменения выражения.
+ */
+struct EdgeTreeView {
+    using Ref = Edge; ///< Ссылка на узел.
+    static constexpr Ref null = nullEdge;
+
+    const EdgeExpression& graph; ///< Выражение с отрицаниями на ребрах.
+
+    TokenType type(Ref edge) const {
+        TokenType type = graph.type(EdgeExpression::node(edge));
+        if (!EdgeExpression::negated(edge)) return type;
+        if (type == TokenType::And) return TokenType::Or;
+        if (type == TokenType::Or) return TokenType::And;
+        return TokenType::Not;
+    }
+
+    Ref left(Ref edge) const {
+        NodeIndex node = EdgeExpression::node(edge);
+        if (!EdgeExpression::negated(edge)) return graph.lefts[node];
+        if (!isDualized(node)) return nullEdge;
+        return EdgeExpression::negate(graph.lefts[node]);
+    }
+
+    Ref right(Ref edge) const {
+        NodeIndex node = EdgeExpression::node(edge);
+        if (!EdgeExpression::negated(edge)) return graph.rights[node];
+        // Операнд отрицания — то же ребро без отрицания
+        if (!isDualized(node)) return EdgeExpression::negate(edge);
+        return EdgeExpression::negate(graph.rights[node]);
+    }
+
+    std::string_view name(Ref edge) const { return SymbolTable::instance().name(graph.symbols[EdgeExpression::node(edge)]); }
+    uint32_t symbol(Ref edge) const { return graph.symbols[EdgeExpression::node(edge)]; }
+
+    bool isDualized(NodeIndex node) const {
+        return graph.type(node) == TokenType::And || graph.type(node) == TokenType::Or;
+    }
+};
+
+/**
+ * @brief Дописывает инфиксную запись дерева в конец строки или в выходной файл.
+ *
+ * Обходит дерево один раз с явным стеком, дописывая каждый фрагмент в общий буфер, поэтому время
+ * пропорционально длине результата при любой глубине дерева. Скобки расставляются по приоритетам
+ * из таблицы operationPriorities: операнд отрицания берется в скобки, если это не переменная и не отрицание;
+ * операнд бинарной операции — если его приоритет ниже, а для правого операнда импликации — если не выше.
+ * @param view Способ доступа к узлам дерева.
+ * @param root Корень дерева.
+ * @param out Приемник текста (std::string или OutputWriter), в конец которого дописывается результат.
+ */
+template <typename View, typename Sink>
+static void appendInfix(const View& view, typename View::Ref root, Sink& out) {
+    using Ref = typename View::Ref;
+
+    // Элемент стека: узел для вывода или готовый фрагмент текста
+    struct Item {
+        Ref node;
+        const char* text;
+    };
+
+    std::vector<Item> stack = { { root, nullptr } };
+
+    while (!stack.empty()) {
+        Item item = stack.back();
+        stack.pop_back();
+
+        if (item.text) {
+            out += item.text;
+            continue;
+        }
+
+        Ref node = item.node;
+        if (node == View::null) continue;
+
+        TokenType type = view.type(node);
+        if (type == TokenType::Variable) {
+            out += view.name(node);
+            continue;
+        }
+
+        Ref right = view.right(node);
+        if (type == TokenType::Not) {
+            bool needParens = right != View::null && view.type(right) != TokenType::Variable && view.type(right) != TokenType::Not;
+
+            // Фрагменты помещаются в стек в обратном порядке
+            if (needParens) stack.push_back({ View::null, ")" });
+            stack.push_back({ right, nullptr });
+            if (needParens) stack.push_back({ View::null, "(" });
+            out += '!';
+            continue;
+        }
+
+        Ref left = view.left(node);
+        int priority = operationPriority(type);
+        int leftPriority = left != View::null ? operationPriority(view.type(left)) : 0;
+        int rightPriority = right != View::null ? operationPriority(view.type(right)) : 0;
+        bool needLeftParens = leftPriority > 0 && leftPriority < priority;
+        bool needRightParens = rightPriority > 0 && (rightPriority < priority || (rightPriority == priority && type == TokenType::Implication));
+
+        if (needRightParens) stack.push_back({ View::null, ")" });
+        stack.push_back({ right, nullptr });
+        if (needRightParens) stack.push_back({ View::null, "(" });
+        stack.push_back({ View::null, operationTexts[type] });
+        if (needLeftParens) stack.push_back({ View::null, ")" });
+        stack.push_back({ left, nullptr });
+        if (needLeftParens) stack.push_back({ View::null, "(" });
+    }
+}
+
+/**
+ * @brief Преобразует дерево выражения в инфиксную строку.
+ *
+ * Формирует строковое представление логического выражения в инфиксной нотации,
+ * добавляя скобки с учетом приоритетов операций.
+ * @param [in] node Указатель на корень дерева.
+ * @return Строковое представление выражения в инфиксной форме.
+ */
+std::string expressionTreeToInfix(ExpressionNode* node) {
+    std::string out;
+    appendInfix(PointerTreeView(), node, out);
+    return out;
+}
+
+/**
+ * @brief Компилирует дерево в программу над битовыми векторами.
+ *
+ * Первый проход с явным стеком выписывает команды в естественном постфиксном порядке. Затем для каждой команды
+ * вычисляется начало ее поддерева и глубина стека, нужная поддереву, и второй проход переставляет операнды
+ * так, чтобы более требовательный вычислялся первым.
+ * @param view Способ доступа к узлам дерева.
+ * @param root Корень дерева.
+ * @param variables Нумерация переменных, общая для сравниваемых программ.
+ * @param program Программа; прежние команды удаляются.
+ */
+template <typename View>
+static void compileBitProgram(const View& view, typename View::Ref root, BitVariables& variables, BitProgram& program) {
+    using Ref = typename View::Ref;
+    using Instruction = BitProgram::Instruction;
+
+    // Естественный постфиксный порядок; рабочие массивы принадлежат потоку и используются повторно
+    struct Item {
+        Ref node;
+        bool expanded;
+    };
+    thread_local std::vector<Instruction> natural;
+    thread_local std::vector<Item> stack;
+    natural.clear();
+    stack.assign(1, { root, false });
+    while (!stack.empty()) {
+        Item item = stack.back();
+        stack.pop_back();
+        if (item.node == View::null) continue;
+
+        TokenType type = view.type(item.node);
+        if (type == TokenType::Variable) {
+            Symbol name;
+            name.id = view.symbol(item.node);
+            natural.push_back({ static_cast<uint8_t>(type), 0, variables.indexOf(name) });
+            continue;
+        }
+        if (item.expanded) {
+            natural.push_back({ static_cast<uint8_t>(type), 0, 0 });
+            continue;
+        }
+        stack.push_back({ item.node, true });
+        stack.push_back({ view.right(item.node), false });
+        if (type != TokenType::Not) stack.push_back({ view.left(item.node), false });
+    }
+
+    // Начало поддерева и нужная ему глубина стека для каждой команды
+    size_t count = natural.size();
+    thread_local std::vector<uint32_t> starts, needs;
+    starts.resize(count);
+    needs.resize(count);
+    for (uint32_t i = 0; i < count; i++) {
+        TokenType type = static_cast<TokenType>(natural[i].type);
+        if (type == TokenType::Variable) {
+            starts[i] = i;
+            needs[i] = 1;
+        }
+        else if (type == TokenType::Not) {
+            starts[i] = starts[i - 1];
+            needs[i] = needs[i - 1];
+        }
+        else {
+            uint32_t right = i - 1;
+            uint32_t left = starts[right] - 1;
+            starts[i] = starts[left];
+            needs[i] = needs[left] == needs[right] ? needs[left] + 1 : std::max(needs[left], needs[right]);
+        }
+    }
+
+    // Перестановка: из двух операндов первым вычисляется тот, которому нужно больше места в стеке
+    program.clear();
+    if (count == 0) return;
+    program.code.reserve(count);
+    program.stackDepth = needs[count - 1];
+
+    struct Step {
+        uint32_t index;
+        bool expanded;
+    };
+    thread_local std::vector<Step> steps;
+    steps.assign(1, { static_cast<uint32_t>(count - 1), false });
+    while (!steps.empty()) {
+        Step step = steps.back();
+        steps.pop_back();
+
+        Instruction instruction = natural[step.index];
+        TokenType type = static_cast<TokenType>(instruction.type);
+        if (type == TokenType::Variable) {
+            program.code.push_back(instruction);
+            continue;
+        }
+        if (type == TokenType::Not) {
+            if (step.expanded) {
+                program.code.push_back(instruction);
+                continue;
+            }
+            steps.push_back({ step.index, true });
+            steps.push_back({ step.index - 1, false });
+            continue;
+        }
+
+        uint32_t right = step.index - 1;
+        uint32_t left = starts[right] - 1;
+        bool swapped = needs[right] > needs[left];
+        if (step.expanded) {
+            instruction.swapped = swapped ? 1 : 0;
+            program.code.push_back(instruction);
+            continue;
+        }
+        steps.push_back({ step.index, true });
+        steps.push_back({ swapped ? left : right, false });
+        steps.push_back({ swapped ? right : left, false });
+    }
+}
+
+/**
+ * @brief Компилирует дерево из узлов ExpressionNode в программу над битовыми векторами.
+ * @param [in] root Указатель на корень дерева.
+ * @param [in,out] variables Нумерация переменных, общая для сравниваемых программ.
+ * @param [out] program Программа.
+ */
+void compileBitProgram(const ExpressionNode* root, BitVariables& variables, BitProgram& program) {
+    compileBitProgram(PointerTreeView(), root, variables, program);
+}
+
+/**
+ * @brief Выполняет программу над векторами заданной длины.
+ *
+ * Результат остается в первых words словах стека.
+ * @param program Программа.
+ * @param words Длина векторов в 64-битных словах.
+ * @param stack Память под program.stackDepth векторов.
+ * @param load Функция load(variable, out), записывающая в out вектор значений переменной.
+ */
+template <typename Load>
+static void runBitProgram(const BitProgram& program, size_t words, uint64_t* stack, Load load) {
+    const BitKernel& kernel = *bitKernel;
+    uint64_t* top = stack;
+    for (const BitProgram::Instruction& instruction : program.code) {
+        switch (instruction.type) {
+        case TokenType::Variable:
+            load(instruction.variable, top);
+            top += words;
+            break;
+        case TokenType::Not:
+            kernel.notWords(top - words, words);
+            break;
+        default: {
+            // a — нижний операнд, b — верхний; результат записывается на место a
+            uint64_t* b = top - words;
+            uint64_t* a = b - words;
+            top = b;
+            switch (instruction.type) {
+            case TokenType::And:
+                kernel.andWords(a, b, words);
+                break;
+            case TokenType::Or:
+                kernel.orWords(a, b, words);
+                break;
+            case TokenType::Implication:
+                if (instruction.swapped) {
+                    kernel.converseWords(a, b, words);
+                }
+                else {
+                    kernel.implicationWords(a, b, words);
+                }
+                break;
+            default:
+                kernel.equivalenceWords(a, b, words);
+                break;
+            }
+            break;
+        }
+        }
+    }
+}
+
+/**
+ * @brief Количество слов случайных наборов на переменную при предварительной проверке моделированием.
+ */
+constexpr size_t verifySimulationWords = 4;
+
+/**
+ * @brief Наибольшее число переменных, при котором равносильность доказывается полной таблицей истинности.
+ */
+constexpr size_t verifyTruthTableLimit = 24;
+
+/**
+ * @brief Наибольшее число словесных операций полной таблицы истинности; при большем выражение сравнивается диаграммами.
+ */
+constexpr uint64_t verifyTruthTableBudget = 1ull << 31;
+
+/**
+ * @brief Наибольшее число узлов диаграмм двоичных решений при доказательстве равносильности (около 100 МБ).
+ */
+constexpr size_t verifyBddNodeLimit = 1 << 22;
+
+/**
+ * @brief Длина фрагмента таблицы истинности в словах: стеки обеих программ помещаются в кэш первого уровня.
+ */
+constexpr size_t verifyChunkWords = 32;
+
+/**
+ * @brief Векторы значений переменных с номерами 0..5 внутри одного слова таблицы истинности.
+ */
+constexpr uint64_t variablePatterns[6] = {
+    0xAAAAAAAAAAAAAAAAull, 0xCCCCCCCCCCCCCCCCull, 0xF0F0F0F0F0F0F0F0ull,
+    0xFF00FF00FF00FF00ull, 0xFFFF0000FFFF0000ull, 0xFFFFFFFF00000000ull
+};
+
+/**
+ * @brief Записывает значения переменных для фрагмента таблицы истинности.
+ *
+ * Набор с номером index задает переменной i значение бита i числа index; слово w содержит наборы w*64..w*64+63.
+ * @param variable Номер переменной.
+ * @param firstWord Номер первого слова фрагмента.
+ * @param words Длина фрагмента в словах.
+ * @param out Вектор значений.
+ */
+static void loadTruthTableVariable(uint32_t variable, uint64_t firstWord, size_t words, uint64_t* out) {
+    if (variable < 6) {
+        std::fill(out, out + words, variablePatterns[variable]);
+        return;
+    }
+
+    // Значение переменной постоянно на отрезках по 2^(variable - 6) слов
+    uint64_t run = 1ull << (variable - 6);
+    for (size_t k = 0; k < words;) {
+        uint64_t word = firstWord + k;
+        size_t length = static_cast<size_t>(std::min<uint64_t>(words - k, run - (word & (run - 1))));
+        std::fill(out + k, out + k + length, (word >> (variable - 6)) & 1 ? ~0ull : 0ull);
+        k += length;
+    }
+}
+
+/**
+ * @brief Следующее значение генератора псевдослучайных чисел SplitMix64.
+ * @param state Состояние генератора.
+ * @return Псевдослучайное 64-битное число.
+ */
+static uint64_t splitMix64(uint64_t& state) {
+    uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+/**
+ * @brief Сравнивает программы на случайных наборах, по 64 набора в слове.
+ * @param variables Нумерация переменных.
+ * @param first Первая программа.
+ * @param second Вторая программа.
+ * @param counterexample Набор, на котором программы различаются (заполняется при различии).
+ * @return true, если различие найдено.
+ */
+static bool findDifferenceBySimulation(const BitVariables& variables, const BitProgram& first, const BitProgram& second, std::vector<bool>& counterexample) {
+    const size_t words = verifySimulationWords;
+    thread_local std::vector<uint64_t> random, firstStack, secondStack;
+    random.resize(variables.size() * words);
+    uint64_t state = 0x5DEECE66Dull;
+    for (uint64_t& word : random) word = splitMix64(state);
+
+    firstStack.resize(first.stackDepth * words);
+    secondStack.resize(second.stackDepth * words);
+    auto load = [&](uint32_t variable, uint64_t* out) {
+        std::copy(random.begin() + variable * words, random.begin() + (variable + 1) * words, out);
+    };
+    runBitProgram(first, words, firstStack.data(), load);
+    runBitProgram(second, words, secondStack.data(), load);
+
+    for (size_t k = 0; k < words; k++) {
+        uint64_t difference = firstStack[k] ^ secondStack[k];
+        if (!difference) continue;
+
+        unsigned bit = countTrailingZeros(difference);
+        counterexample.resize(variables.size());
+        for (size_t i = 0; i < variables.size(); i++) counterexample[i] = (random[i * words + k] >> bit) & 1;
+        return true;
+    }
+    return false;
+}
+
+/**
+ * @brief Сравнивает программы на всех наборах значений по фрагментам таблицы истинности.
+ * @param variables Нумерация переменных (не больше verifyTruthTableLimit).
+ * @param first Первая программа.
+ * @param second Вторая программа.
+ * @param counterexample Первый набор, на котором программы различаются (заполняется при различии).
+ * @return true, если различие найдено.
+ */
+static bool findDifferenceExhaustive(const BitVariables& variables, const BitProgram& first, const BitProgram& second, std::vector<bool>& counterexample) {
+    size_t count = variables.size();
+    uint64_t totalWords = count > 6 ? 1ull << (count - 6) : 1;
+    uint64_t lastMask = count >= 6 ? ~0ull : (1ull << (1u << count)) - 1;
+
+    size_t chunk = static_cast<size_t>(std::min<uint64_t>(totalWords, verifyChunkWords));
+    thread_local std::vector<uint64_t> firstStack, secondStack;
+    firstStack.resize(first.stackDepth * chunk);
+    secondStack.resize(second.stackDepth * chunk);
+
+    for (uint64_t firstWord = 0; firstWord < totalWords; firstWord += chunk) {
+        auto load = [firstWord, chunk](uint32_t variable, uint64_t* out) {
+            loadTruthTableVariable(variable, firstWord, chunk, out);
+        };
+        runBitProgram(first, chunk, firstStack.data(), load);
+        runBitProgram(second, chunk, secondStack.data(), load);
+
+        for (size_t k = 0; k < chunk; k++) {
+            uint64_t difference = (firstStack[k] ^ secondStack[k]) & lastMask;
+            if (!difference) continue;
+
+            uint64_t index = (firstWord + k) * 64 + countTrailingZeros(difference);
+            counterexample.resize(count);
+            for (size_t i = 0; i < count; i++) counterexample[i] = (index >> i) & 1;
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Возвращает ребро к переменной, создавая узлы переменных до нее при первом обращении.
+ * @param index Номер переменной.
+ * @return Ребро без отрицания к узлу переменной.
+ */
+Edge AndInverterGraph::variable(uint32_t index) {
+    while (variables.size() <= index) {
+        lefts.push_back(nullEdge);
+        rights.push_back(nullEdge);
+        variables.push_back(static_cast<Edge>(lefts.size() - 1) << 1);
+    }
+    return variables[index];
+}
+
+/**
+ * @brief Возвращает ребро к конъюнкции, создавая узел при отсутствии.
+ * @param a Первый операнд.
+ * @param b Второй операнд.
+ * @return Ребро к единственному узлу с такими операндами или упрощенный результат.
+ */
+Edge AndInverterGraph::conjunction(Edge a, Edge b) {
+    if (a > b) std::swap(a, b);
+    if (a == 0) return 0;               // ложь & x
+    if (a == 1) return b;               // истина & x
+    if (a == b) return a;               // x & x
+    if (a == EdgeExpression::negate(b)) return 0; // x & !x
+
+    uint64_t key = static_cast<uint64_t>(a) << 32 | b;
+    auto found = table.find(key);
+    if (found != table.end()) return static_cast<Edge>(found->second) << 1;
+
+    lefts.push_back(a);
+    rights.push_back(b);
+    NodeIndex node = static_cast<NodeIndex>(lefts.size() - 1);
+    table.emplace(key, node);
+    return static_cast<Edge>(node) << 1;
+}
+
+/**
+ * @brief Строит диаграмму двоичных решений, выполняя программу на стеке диаграмм.
+ * @param manager Менеджер, в котором переменные объявлены в порядке нумерации.
+ * @param variables Нумерация переменных.
+ * @param program Программа.
+ * @return Ссылка на корень диаграммы, защищенная ref.
+ */
+static BddRef runBddProgram(BddManager& manager, const BitVariables& variables, const BitProgram& program) {
+    std::vector<BddRef> stack;
+    stack.reserve(program.stackDepth);
+    for (const BitProgram::Instruction& instruction : program.code) {
+        BddRef result;
+        if (instruction.type == TokenType::Variable) {
+            result = manager.variable(variables.names[instruction.variable]);
+        }
+        else if (instruction.type == TokenType::Not) {
+            BddRef operand = stack.back();
+            stack.pop_back();
+            result = manager.negate(operand);
+            manager.deref(operand);
+        }
+        else {
+            BddRef top = stack.back();
+            stack.pop_back();
+            BddRef below = stack.back();
+            stack.pop_back();
+            BddRef left = instruction.swapped ? top : below;
+            BddRef right = instruction.swapped ? below : top;
+            result = manager.apply(static_cast<TokenType>(instruction.type), left, right);
+            manager.deref(top);
+            manager.deref(below);
+        }
+        manager.ref(result);
+        stack.push_back(result);
+    }
+    return stack.back();
+}
+
+/**
+ * @brief Строит граф из конъюнкций, выполняя программу на стеке ребер.
+ * @param graph Граф со структурным хешированием, общий для сравниваемых программ.
+ * @param program Программа.
+ * @return Ребро к корню.
+ */
+static Edge runAigProgram(AndInverterGraph& graph, const BitProgram& program) {
+    thread_local std::vector<Edge> stack;
+    stack.clear();
+    for (const BitProgram::Instruction& instruction : program.code) {
+        if (instruction.type == TokenType::Variable) {
+            stack.push_back(graph.variable(instruction.variable));
+            continue;
+        }
+        if (instruction.type == TokenType::Not) {
+            stack.back() = EdgeExpression::negate(stack.back());
+            continue;
+        }
+
+        Edge top = stack.back();
+        stack.pop_back();
+        Edge below = stack.back();
+        Edge left = instruction.swapped ? top : below;
+        Edge right = instruction.swapped ? below : top;
+        switch (instruction.type) {
+        case TokenType::And: stack.back() = graph.conjunction(left, right); break;
+        case TokenType::Or: stack.back() = graph.disjunction(left, right); break;
+        case TokenType::Implication: stack.back() = graph.implication(left, right); break;
+        default: stack.back() = graph.equivalence(left, right); break;
+        }
+    }
+    return stack.back();
+}
+
+/**
+ * @brief Сравнивает программы диаграммами двоичных решений.
+ *
+ * Диаграммы канонические, поэтому равносильность проверяется сравнением ссылок. При различии контрпример
+ * берется с любого пути к константе «истина» в диаграмме отрицания эквивалентности. Размер диаграмм
+ * экспоненциален по числу переменных для некоторых выражений, поэтому число узлов ограничено verifyBddNodeLimit.
+ * @param variables Нумерация переменных.
+ * @param first Первая программа.
+ * @param second Вторая программа.
+ * @param counterexample Набор, на котором программы различаются (заполняется при различии).
+ * @return true, если различие найдено.
+ * @throw Error с типом bddNodeLimit, если диаграммы превысили verifyBddNodeLimit узлов.
+ */
+static bool findDifferenceBdd(const BitVariables& variables, const BitProgram& first, const BitProgram& second, std::vector<bool>& counterexample) {
+    BddManager manager;
+    manager.setNodeLimit(verifyBddNodeLimit);
+    for (const Symbol& name : variables.names) manager.variableIndex(name);
+
+    BddRef firstRoot = runBddProgram(manager, variables, first);
+    BddRef secondRoot = runBddProgram(manager, variables, second);
+    if (BddManager::areEquivalent(firstRoot, secondRoot)) return false;
+
+    BddRef difference = manager.negate(manager.apply(TokenType::Equivalence, firstRoot, secondRoot));
+    counterexample.assign(variables.size(), false);
+    for (BddRef node = difference; !BddManager::isConstant(node);) {
+        bool value = manager.low(node) == bddFalse;
+        counterexample[manager.variableOf(node)] = value;
+        node = value ? manager.high(node) : manager.low(node);
+    }
+    return true;
+}
+
+/**
+ * @brief Доказывает равносильность двух программ с общей нумерацией переменных.
+ *
+ * Сначала программы сравниваются на случайных наборах. Если различие не найдено, обе программы строятся
+ * в одном графе из конъюнкций со структурным хешированием: преобразования программы (законы де Моргана,
+ * удаление двойных отрицаний, раскрытие импликации и эквивалентности) не меняют ребро корня, поэтому
+ * правильный результат доказывается за линейное время. Если ребра различаются, равносильность доказывается
+ * полной таблицей истинности, когда переменных не больше verifyTruthTableLimit и таблица укладывается
+ * в verifyTruthTableBudget словесных операций, иначе — диаграммами двоичных решений не более чем
+ * из verifyBddNodeLimit узлов.
+ * @param [in] variables Нумерация переменных.
+ * @param [in] first Первая программа.
+ * @param [in] second Вторая программа.
+ * @param [out] counterexample Значения переменных по номерам, на которых программы различаются (при различии).
+ * @return true, если программы равносильны.
+ * @throw Error с типом bddNodeLimit, если равносильность не удалось ни доказать, ни опровергнуть в пределах числа узлов.
+ */
+bool verifyEquivalence(const BitVariables& variables, const BitProgram& first, const BitProgram& second, std::vector<bool>& counterexample) {
+    if (findDifferenceBySimulation(variables, first, second, counterexample)) return false;
+
+    thread_local AndInverterGraph graph;
+    graph.clear();
+    if (runAigProgram(graph, first) == runAigProgram(graph, second)) return true;
+
+    size_t count = variables.size();
+    if (count <= verifyTruthTableLimit) {
+        uint64_t totalWords = count > 6 ? 1ull << (count - 6) : 1;
+        uint64_t cost = totalWords * (first.code.size() + second.code.size());
+        if (cost <= verifyTruthTableBudget) {
+            return !findDifferenceExhaustive(variables, first, second, counterexample);
+        }
+    }
+    return !findDifferenceBdd(variables, first, second, counterexample);
+}
+
+/**
+ * @brief Доказывает равносильность двух деревьев.
+ * @param [in] first Указатель на корень первого дерева.
+ * @param [in] second Указатель на корень второго дерева.
+ * @param [out] counterexample Значения переменных, на которых деревья различаются (при различии).
+ * @return true, если деревья равносильны.
+ * @throw Error с типом bddNodeLimit, если равносильность не удалось ни доказать, ни опровергнуть в пределах числа узлов.
+ */
+bool verifyEquivalence(const ExpressionNode* first, const ExpressionNode* second, std::vector<std::pair<Symbol, bool>>& counterexample) {
+    BitVariables variables;
+    BitProgram firstProgram, secondProgram;
+    compileBitProgram(first, variables, firstProgram);
+    compileBitProgram(second, variables, secondProgram);
+
+    std::vector<bool> values;
+    counterexample.clear();
+    if (verifyEquivalence(variables, firstProgram, secondProgram, values)) return true;
+
+    for (size_t i = 0; i < variables.size(); i++) counterexample.emplace_back(variables.names[i], values[i]);
+    return false;
+}
+
+/**
+ * @brief Формирует текст набора значений переменных для сообщения об ошибке.
+ * @param variables Нумерация переменных.
+ * @param values Значения переменных по номерам.
+ * @return Строка вида "a = 1, b = 0".
+ */
+static std::string formatAssignment(const BitVariables& variables, const std::vector<bool>& values) {
+    std::string text;
+    for (size_t i = 0; i < variables.size(); i++) {
+        if (i > 0) text += ", ";
+        text += variables.names[i].name();
+        text += values[i] ? " = 1" : " = 0";
+    }
+    return text;
+}
+
+/**
+ * @brief Объем кэша второго уровня, в который помещается стек программы при вычислении фрагмента таблицы истинности.
+ */
+constexpr size_t truthTableCacheBytes = 256 * 1024;
+
+/**
+ * @brief Выбирает длину фрагмента таблицы истинности.
+ *
+ * Фрагмент — наибольшая степень двойки слов (не меньше одного регистра AVX2), при которой все векторы
+ * стека программы помещаются в truthTableCacheBytes.
+ * @param program Программа.
+ * @param totalWords Длина таблицы в словах.
+ * @return Длина фрагмента в словах.
+ */
+static size_t truthTableChunkWords(const BitProgram& program, uint64_t totalWords) {
+    size_t limit = truthTableCacheBytes / sizeof(uint64_t) / std::max<size_t>(program.stackDepth, 1);
+    size_t chunk = 4;
+    while (chunk * 2 <= limit) chunk *= 2;
+    return static_cast<size_t>(std::min<uint64_t>(chunk, totalWords));
+}
+
+/**
+ * @brief Строит таблицу истинности выражения.
+ *
+ * Выражение компилируется в программу над битовыми векторами, которая выполняется фрагментами таблицы
+ * операциями текущего ядра (AVX2 или 64-битными словами). Количество выполняющих наборов считается
+ * подсчетом единичных битов каждого фрагмента, пока он находится в кэше.
+ * @param [in] root Указатель на корень дерева.
+ * @param [out] table Таблица истинности; при превышении TruthTable::maxVariables заполняются только переменные.
+ * @return true, если таблица построена.
+ */
+bool buildTruthTable(const ExpressionNode* root, TruthTable& table) {
+    thread_local BitVariables variables;
+    thread_local BitProgram program;
+    thread_local std::vector<uint64_t> stack;
+    variables.clear();
+    compileBitProgram(root, variables, program);
+
+    table.clear();
+    table.variables = variables.names;
+    size_t count = variables.size();
+    if (count > TruthTable::maxVariables) {
+        return false;
+    }
+
+    uint64_t totalWords = count > 6 ? 1ull << (count - 6) : 1;
+    table.words.resize(static_cast<size_t>(totalWords));
+    size_t chunk = truthTableChunkWords(program, totalWords);
+    stack.resize(program.stackDepth * chunk);
+
+    const BitKernel& kernel = *bitKernel;
+    for (uint64_t firstWord = 0; firstWord < totalWords; firstWord += chunk) {
+        auto load = [firstWord, chunk](uint32_t variable, uint64_t* out) {
+            loadTruthTableVariable(variable, firstWord, chunk, out);
+        };
+        runBitProgram(program, chunk, stack.data(), load);
+        std::copy(stack.begin(), stack.begin() + chunk, table.words.begin() + static_cast<size_t>(firstWord));
+        table.models += kernel.countWords(stack.data(), chunk);
+    }
+
+    // В единственном слове таблицы меньше чем от 6 переменных лишние биты сбрасываются
+    if (count < 6) {
+        table.words[0] &= (1ull << (1u << count)) - 1;
+        table.models = countOnes(table.words[0]);
+    }
+    return true;
+}
+
+/**
+ * @brief Количество блоков перебора на один поток: мелкие блоки выравнивают нагрузку, когда блоки вычисляются неравномерно.
+ */
+constexpr uint64_t modelCountBlocksPerThread = 16;
+
+/**
+ * @brief Итоги перебора части наборов значений.
+ */
+struct ModelTally {
+    uint64_t models = 0;                            ///< Количество выполняющих наборов.
+    uint64_t firstModel = ModelCount::none;         ///< Первый выполняющий набор.
+    uint64_t firstCountermodel = ModelCount::none;  ///< Первый опровергающий набор.
+
+    /**
+     * @brief Добавляет итоги другой части наборов.
+     * @param other Итоги другой части.
+     */
+    void merge(const ModelTally& other) {
+        models += other.models;
+        firstModel = std::min(firstModel, other.firstModel);
+        firstCountermodel = std::min(firstCountermodel, other.firstCountermodel);
+    }
+};
+
+/**
+ * @brief Перебирает один блок наборов фрагментами, помещающимися в кэш.
+ *
+ * Блок — наборы с общими значениями старших переменных, то есть непрерывный отрезок слов таблицы истинности.
+ * Сама таблица не хранится: каждый фрагмент вычисляется в стеке потока, после чего из него берутся только
+ * количество единиц и номера первых наборов.
+ * @param program Программа.
+ * @param count Количество переменных.
+ * @param firstWord Номер первого слова блока.
+ * @param blockWords Длина блока в словах.
+ * @param chunk Длина фрагмента в словах (делит blockWords).
+ * @param tally Итоги, к которым добавляется блок.
+ */
+static void countBlockModels(const BitProgram& program, size_t count, uint64_t firstWord, uint64_t blockWords, size_t chunk, ModelTally& tally) {
+    // Память потока не зависит от числа переменных: только стек программы на один фрагмент
+    thread_local std::vector<uint64_t> stack;
+    stack.resize(program.stackDepth * chunk);
+    const BitKernel& kernel = *bitKernel;
+    uint64_t lastMask = count >= 6 ? ~0ull : (1ull << (1u << count)) - 1;
+
+    for (uint64_t word = firstWord; word < firstWord + blockWords; word += chunk) {
+        auto load = [word, chunk](uint32_t variable, uint64_t* out) {
+            loadTruthTableVariable(variable, word, chunk, out);
+        };
+        runBitProgram(program, chunk, stack.data(), load);
+        if (count < 6) stack[0] &= lastMask;
+        tally.models += kernel.countWords(stack.data(), chunk);
+
+        // Блоки перебираются по возрастанию, поэтому первый найденный набор — наименьший в своей части
+        if (tally.firstModel == ModelCount::none) {
+            for (size_t k = 0; k < chunk; k++) {
+                if (!stack[k]) continue;
+                tally.firstModel = (word + k) * 64 + countTrailingZeros(stack[k]);
+                break;
+            }
+        }
+        if (tally.firstCountermodel == ModelCount::none) {
+            for (size_t k = 0; k < chunk; k++) {
+                uint64_t falsified = ~stack[k] & lastMask;
+                if (!falsified) continue;
+                tally.firstCountermodel = (word + k) * 64 + countTrailingZeros(falsified);
+                break;
+            }
+        }
+    }
+}
+
+/**
+ * @brief Перебирает блоки из полуинтервала [firstBlock, lastBlock), деля его пополам между потоками пула.
+ * @param program Программа.
+ * @param count Количество переменных.
+ * @param firstBlock Первый блок.
+ * @param lastBlock Блок, следующий за последним.
+ * @param blockWords Длина блока в словах.
+ * @param chunk Длина фрагмента в словах.
+ * @param pool Пул потоков (nullptr — в текущем потоке).
+ * @return Итоги перебора блоков.
+ */
+static ModelTally countModelsParallel(const BitProgram& program, size_t count, uint64_t firstBlock, uint64_t lastBlock, uint64_t blockWords, size_t chunk, ForkJoinPool* pool) {
+    if (pool && pool->size() > 1 && lastBlock - firstBlock > 1) {
+        uint64_t middle = firstBlock + (lastBlock - firstBlock) / 2;
+        ModelTally left, right;
+        pool->invoke(
+            [&]() { left = countModelsParallel(program, count, firstBlock, middle, blockWords, chunk, pool); },
+            [&]() { right = countModelsParallel(program, count, middle, lastBlock, blockWords, chunk, pool); });
+        left.merge(right);
+        return left;
+    }
+
+    ModelTally tally;
+    for (uint64_t block = firstBlock; block < lastBlock; block++) {
+        countBlockModels(program, count, block * blockWords, blockWords, chunk, tally);
+    }
+    return tally;
+}
+
+/**
+ * @brief Подсчитывает выполняющие наборы выражения перебором всех наборов без хранения таблицы истинности.
+ *
+ * Наборы делятся на блоки фиксацией значений старших переменных; блоки распределяются между потоками пула
+ * и вычисляются так же, как фрагменты таблицы истинности. От каждого блока сохраняются только количество
+ * выполняющих наборов и первые выполняющий и опровергающий наборы, поэтому память потока постоянна.
+ * @param [in] root Указатель на корень дерева.
+ * @param [out] result Итоги перебора; при превышении ModelCount::maxVariables заполняются только переменные.
+ * @param [in] pool Пул потоков (nullptr — в текущем потоке).
+ * @return true, если перебор выполнен.
+ */
+bool countModels(const ExpressionNode* root, ModelCount& result, ForkJoinPool* pool) {
+    BitVariables variables;
+    BitProgram program;
+    compileBitProgram(root, variables, program);
+
+    result.clear();
+    result.variables = variables.names;
+    size_t count = variables.size();
+    if (count > ModelCount::maxVariables) {
+        return false;
+    }
+
+    uint64_t totalWords = count > 6 ? 1ull << (count - 6) : 1;
+    size_t chunk = truthTableChunkWords(program, totalWords);
+
+    // Блоков достаточно для выравнивания нагрузки, но каждый не короче фрагмента
+    uint64_t threads = pool ? pool->size() : 1;
+    uint64_t blockWords = chunk;
+    while (blockWords < totalWords && totalWords / blockWords > threads * modelCountBlocksPerThread) {
+        blockWords *= 2;
+    }
+
+    ModelTally tally = countModelsParallel(program, count, 0, totalWords / blockWords, blockWords, chunk, pool);
+    result.models = tally.models;
+    result.firstModel = tally.firstModel;
+    result.firstCountermodel = tally.firstCountermodel;
+    return true;
+}
+
+/**
+ * @brief Приемник результатов обработки, сохраняющий выражения в строки.
+ */
+struct StringEmitter {
+    std::string& inputStr; ///< Исходное выражение в инфиксной форме.
+    std::string& result;   ///< Преобразованное выражение в инфиксной форме.
+
+    bool needsInput() const { return true; }
+
+    template <typename View>
+    void input(const View& view, typename View::Ref root) {
+        inputStr.clear();
+        appendInfix(view, root, inputStr);
+    }
+
+    void inputText(std::string_view text) {
+        inputStr.assign(text.data(), text.size());
+    }
+
+    template <typename View>
+    void output(const View& view, typename View::Ref root) {
+        result.clear();
+        appendInfix(view, root, result);
+    }
+};
+
+/**
+ * @brief Приемник результатов обработки, выводящий выражения прямо в файл или в буфер.
+ *
+ * Исходное выражение выводится только при заданном echoInput и отделяется от результата переводом строки.
+ */
+template <typename Sink>
+struct StreamEmitter {
+    Sink& writer;         ///< Выходной файл (OutputWriter) или буфер (std::string).
+    bool echoInput;       ///< Выводить исходное выражение.
+
+    bool needsInput() const { return echoInput; }
+
+    template <typename View>
+    void input(const View& view, typename View::Ref root) {
+        if (!echoInput) return;
+        appendInfix(view, root, writer);
+        writer += '\n';
+    }
+
+    void inputText(std::string_view text) {
+        if (!echoInput) return;
+        writer += text;
+        writer += '\n';
+    }
+
+    template <typename View>
+    void output(const View& view, typename View::Ref root) {
+        appendInfix(view, root, writer);
+    }
+};
+
+/**
+ * @brief Приемник результатов, проверяющий равносильность результата исходному выражению перед выводом.
+ *
+ * Исходное и преобразованное выражения компилируются в программы над битовыми векторами с общей нумерацией
+ * переменных и сравниваются verifyEquivalence. Исходное выражение для вывода запоминается в строке, поэтому
+ * при различии внутреннему приемнику ничего не передается, а в errorList добавляется ошибка с контрпримером.
+ * Если равносильность не удалось доказать в пределах числа узлов диаграмм, результат также не выводится,
+ * а в errorList добавляется ошибка verificationUnproven.
+ */
+template <typename Emitter>
+struct VerifyingEmitter {
+    Emitter& inner;             ///< Приемник проверенных выражений.
+    std::set<Error>& errorList; ///< Множество для ошибки проверки.
+    BitVariables& variables;    ///< Общая нумерация переменных.
+    BitProgram& source;         ///< Программа исходного выражения.
+    BitProgram& result;         ///< Программа преобразованного выражения.
+    std::string& echo;          ///< Исходное выражение в инфиксной форме.
+    bool verified = false;      ///< Результат равносилен исходному выражению.
+
+    bool needsInput() const { return true; }
+
+    template <typename View>
+    void input(const View& view, typename View::Ref root) {
+        compileBitProgram(view, root, variables, source);
+        if (inner.needsInput()) {
+            echo.clear();
+            appendInfix(view, root, echo);
+        }
+    }
+
+    template <typename View>
+    void output(const View& view, typename View::Ref root) {
+        compileBitProgram(view, root, variables, result);
+
+        std::vector<bool> counterexample;
+        try {
+            verified = verifyEquivalence(variables, source, result, counterexample);
+        }
+        catch (const Error& error) {
+            if (error.type != Error::bddNodeLimit) throw;
+            errorList.insert(Error(Error::verificationUnproven, -1, "диаграммы двоичных решений превысили " + std::to_string(verifyBddNodeLimit) + " узлов"));
+            return;
+        }
+        if (!verified) {
+            errorList.insert(Error(Error::verificationFailed, -1, formatAssignment(variables, counterexample)));
+            return;
+        }
+
+        if (inner.needsInput()) inner.inputText(echo);
+        inner.output(view, root);
+    }
+};
+
+/**
+ * @brief Исходное выражение, передаваемое построителям представлений.
+ */
+struct ExpressionSource {
+    std::string_view text; ///< Строка с выражением.
+    InputSyntax syntax;    ///< Форма записи выражения.
+};
+
+/**
+ * @brief Строит представление выражения по исходной строке.
+ *
+ * Инфиксная запись разбирается parseInfixExpression, постфиксная — parsePostfixExpression; в обоих случаях
+ * дерево строится при чтении строки. Параметр target выбирает представление так же, как в этих функциях.
+ * @param source Исходное выражение.
+ * @param errorList Множество для хранения обнаруженных ошибок.
+ * @param target Плоское дерево, граф или выражение с отрицаниями на ребрах (для ExpressionNode не указывается).
+ * @return Ссылка на корень построенного представления.
+ */
+template <typename... Target>
+static auto parseSource(const ExpressionSource& source, std::set<Error>& errorList, Target&... target) {
+    if (source.syntax == syntaxInfix) {
+        return parseInfixExpression(source.text, errorList, target...);
+    }
+    return parsePostfixExpression(source.text, errorList, target...);
+}
+
+/**
+ * @brief Выполняет преобразования на дереве из узлов ExpressionNode.
+ * @param source Исходное выражение.
+ * @param emit Приемник исходного и преобразованного выражений.
+ * @param errorList Множество для хранения обнаруженных ошибок.
+ * @param rewrite Способ переноса отрицаний.
+ * @param pool Пул потоков для поэтапных преобразований (nullptr — в текущем потоке).
+ * @return true, если дерево построено без ошибок.
+ */
+template <typename Emitter>
+static bool runTreePipeline(const ExpressionSource& source, Emitter& emit, std::set<Error>& errorList, RewriteMode rewrite, ForkJoinPool* pool) {
+    // Построение дерева выражения
+    ExpressionNode* exprTree = parseSource(source, errorList);
+
+    // Проверка на ошибки построения дерева
+    if (!errorList.empty()) {
+        releaseExpressionTree(exprTree); // Освобождаем память
+        return false;
+    }
+
+    // Вывод первоначального выражения
+    emit.input(PointerTreeView(), exprTree);
+
+    if (rewrite == rewriteFused) {
+        // Все преобразования за один проход по исходному дереву
+        ExpressionNode* normalForm = fusedNormalForm(exprTree);
+        emit.output(PointerTreeView(), normalForm);
+        releaseExpressionTree(normalForm);
+        releaseExpressionTree(exprTree);
+        return true;
+    }
+
+    // Преобразование импликации и эквивалентности
+    if (pool) {
+        transformImplicationAndEquivalence(exprTree, *pool);
+    }
+    else {
+        transformImplicationAndEquivalence(exprTree);
+    }
+
+    if (rewrite == rewriteNnf) {
+        // Перенос отрицаний и удаление двойных отрицаний за один проход
+        ExpressionNode* normalForm = negationNormalForm(exprTree);
+        releaseExpressionTree(exprTree);
+        exprTree = normalForm;
+    }
+    else {
+        // Применение законов де Моргана до тех пор, пока есть изменения
+        bool changed;
+        do {
+            changed = false;
+            if (pool) {
+                simplifyExpression(exprTree, changed, *pool);
+            }
+            else {
+                simplifyExpression(exprTree, changed);
+            }
+        } while (changed);
+
+        // Удаление двойных отрицаний
+        removeDoubleNot(exprTree);
+    }
+
+    // Вывод результата
+    emit.output(PointerTreeView(), exprTree);
+
+    // Освобождение памяти
+    releaseExpressionTree(exprTree);
+
+    return true;
+}
+
+/**
+ * @brief Выполняет преобразования на плоском дереве FlatExpression.
+ *
+ * Массивы дерева принадлежат потоку и очищаются без освобождения памяти,
+ * поэтому при обработке последовательности выражений память выделяется повторно только для выражений большего размера.
+ * @param source Исходное выражение.
+ * @param emit Приемник исходного и преобразованного выражений.
+ * @param errorList Множество для хранения обнаруженных ошибок.
+ * @param rewrite Способ переноса отрицаний.
+ * @return true, если дерево построено без ошибок.
+ */
+template <typename Emitter>
+static bool runFlatPipeline(const ExpressionSource& source, Emitter& emit, std::set<Error>& errorList, RewriteMode rewrite) {
+    thread_local FlatExpression tree;
+    tree.clear();
+
+    NodeIndex root = parseSource(source, errorList, tree);
+    if (!errorList.empty()) {
+        return false;
+    }
+
+    emit.input(FlatTreeView{ tree }, root);
+
+    if (rewrite == rewriteFused) {
+        root = fusedNormalForm(tree, root);
+        emit.output(FlatTreeView{ tree }, root);
+        return true;
+    }
+
+    transformImplicationAndEquivalence(tree, root);
+
+    if (rewrite == rewriteNnf) {
+        root = negationNormalForm(tree, root);
+    }
+    else {
+        bool changed;
+        do {
+            changed = false;
+            simplifyExpression(tree, root, changed);
+        } while (changed);
+
+        removeDoubleNot(tree, root);
+    }
+
+    emit.output(FlatTreeView{ tree }, root);
+    return true;
+}
+
+/**
+ * @brief Выполняет преобразования на графе ExpressionDag с общими подвыражениями.
+ *
+ * Законы де Моргана на графе всегда переносят отрицание до переменных за один проход,
+ * поэтому способ переноса отрицаний для этого представления не выбирается.
+ * @param source Исходное выражение.
+ * @param emit Приемник исходного и преобразованного выражений.
+ * @param errorList Множество для хранения обнаруженных ошибок.
+ * @return true, если граф построен без ошибок.
+ */
+template <typename Emitter>
+static bool runDagPipeline(const ExpressionSource& source, Emitter& emit, std::set<Error>& errorList) {
+    thread_local ExpressionDag dag;
+    dag.clear();
+
+    NodeIndex root = parseSource(source, errorList, dag);
+    if (!errorList.empty()) {
+        return false;
+    }
+
+    emit.input(FlatTreeView{ dag.graph() }, root);
+
+    root = transformImplicationAndEquivalence(dag, root);
+
+    bool changed;
+    do {
+        changed = false;
+        root = simplifyExpression(dag, root, changed);
+    } while (changed);
+
+    root = removeDoubleNot(dag, root);
+
+    emit.output(FlatTreeView{ dag.graph() }, root);
+    return true;
+}
+
+/**
+ * @brief Выполняет преобразования на выражении EdgeExpression с отрицаниями на ребрах.
+ *
+ * После раскрытия импликации и эквивалентности выражение выводится через EdgeTreeView, который читает его
+ * в отрицательной нормальной форме, поэтому способ переноса отрицаний для этого представления не выбирается.
+ * Двойные отрицания исходной записи на ребрах не сохраняются, поэтому исходное выражение, если оно нужно
+ * приемнику, выводится по отдельно разобранному плоскому дереву.
+ * @param source Исходное выражение.
+ * @param emit Приемник исходного и преобразованного выражений.
+ * @param errorList Множество для хранения обнаруженных ошибок.
+ * @return true, если выражение построено без ошибок.
+ */
+template <typename Emitter>
+static bool runEdgePipeline(const ExpressionSource& source, Emitter& emit, std::set<Error>& errorList) {
+    thread_local EdgeExpression graph;
+    graph.clear();
+
+    Edge root = parseSource(source, errorList, graph);
+    if (!errorList.empty()) {
+        return false;
+    }
+
+    if (emit.needsInput()) {
+        thread_local FlatExpression sourceTree;
+        sourceTree.clear();
+        NodeIndex sourceRoot = parseSource(source, errorList, sourceTree);
+        emit.input(FlatTreeView{ sourceTree }, sourceRoot);
+    }
+
+    transformImplicationAndEquivalence(graph);
+
+    emit.output(EdgeTreeView{ graph }, root);
+    return true;
+}
+
+/**
+ * @brief Выполняет полный цикл обработки выражения и передает результаты приемнику.
+ * @param expression Строка с логическим выражением.
+ * @param emit Приемник исходного и преобразованного выражений.
+ * @param errorList Множество для хранения обнаруженных ошибок.
+ * @param engine Представление дерева, на котором выполняются преобразования.
+ * @param rewrite Способ переноса отрицаний.
+ * @param pool Пул потоков для преобразований дерева из ExpressionNode (nullptr — в текущем потоке).
+ * @param syntax Форма записи выражения.
+ * @return true, если выражение обработано без ошибок.
+ */
+template <typename Emitter>
+static bool runPipeline(std::string_view expression, Emitter& emit, std::set<Error>& errorList, PipelineEngine engine, RewriteMode rewrite, ForkJoinPool* pool = nullptr, InputSyntax syntax = syntaxPostfix) {
+    ExpressionSource source = { expression, syntax };
+
+    if (engine == engineFlat) {
+        return runFlatPipeline(source, emit, errorList, rewrite);
+    }
+
+    if (engine == engineDag) {
+        return runDagPipeline(source, emit, errorList);
+    }
+
+    if (engine == engineEdge) {
+        return runEdgePipeline(source, emit, errorList);
+    }
+
+    return runTreePipeline(source, emit, errorList, rewrite, pool);
+}
+
+/**
+ * @brief Выполняет преобразования и, при заданном verify, выводит результат только после доказательства равносильности.
+ * @param expression Строка с логическим выражением.
+ * @param emit Приемник исходного и преобразованного выражений.
+ * @param errorList Множество для хранения обнаруженных ошибок.
+ * @param engine Представление дерева.
+ * @param rewrite Способ переноса отрицаний.
+ * @param pool Пул потоков для поэтапных преобразований (nullptr — в текущем потоке).
+ * @param syntax Форма записи выражения.
+ * @param verify Проверять равносильность результата исходному выражению.
+ * @return true, если выражение обработано без ошибок и проверка (если задана) пройдена.
+ */
+template <typename Emitter>
+static bool runCheckedPipeline(std::string_view expression, Emitter& emit, std::set<Error>& errorList, PipelineEngine engine, RewriteMode rewrite, ForkJoinPool* pool, InputSyntax syntax, bool verify) {
+    if (!verify) {
+        return runPipeline(expression, emit, errorList, engine, rewrite, pool, syntax);
+    }
+
+    // Программы и нумерация принадлежат потоку, чтобы в пакетном режиме память не выделялась для каждой строки
+    thread_local BitVariables variables;
+    thread_local BitProgram source, result;
+    thread_local std::string echo;
+    variables.clear();
+
+    VerifyingEmitter<Emitter> checked{ emit, errorList, variables, source, result, echo };
+    return runPipeline(expression, checked, errorList, engine, rewrite, pool, syntax) && checked.verified;
+}
+
+/**
+ * @brief Обрабатывает одно логическое выражение.
+ *
+ * Выполняет полный цикл преобразования выражения в постфиксной или инфиксной записи: разбор, построение дерева,
+ * преобразование импликации и эквивалентности, применение законов де Моргана и удаление двойных отрицаний.
+ * @param [in] expression Строка с логическим выражением в форме записи options.syntax.
+ * @param [out] inputStr Исходное выражение в инфиксной форме.
+ * @param [out] result Преобразованное выражение в инфиксной форме.
+ * @param [in,out] errorList Множество для хранения обнаруженных ошибок.
+ * @param [in] options Параметры обработки: представление дерева (engine), способ переноса отрицаний (rewrite),
+ * форма записи (syntax) и проверка равносильности результата исходному выражению (verify);
+ * при различии добавляется ошибка verificationFailed, если равносильность не доказана — verificationUnproven.
+ * @param [in] pool Пул потоков для преобразований одного дерева (nullptr — в текущем потоке).
+ * @return true, если выражение обработано без ошибок, иначе false.
+ */
+bool processExpression(std::string_view expression, std::string& inputStr, std::string& result, std::set<Error>& errorList, const ProgramOptions& options, ForkJoinPool* pool) {
+    StringEmitter emit{ inputStr, result };
+    return runCheckedPipeline(expression, emit, errorList, options.engine, options.rewrite, pool, options.syntax, options.verify);
+}
+
+/**
+ * @brief Обрабатывает одно логическое выражение с выводом результата прямо в файл.
+ *
+ * Выполняет те же преобразования, что и processExpression со строковым результатом, но выводит выражения
+ * при обходе дерева в буфер выходного файла, не формируя строку результата. При ошибках в файл ничего не выводится.
+ * @param [in] expression Строка с логическим выражением в форме записи options.syntax.
+ * @param [in,out] output Выходной файл.
+ * @param [in] echoInput Выводить перед результатом исходное выражение в инфиксной форме и перевод строки.
+ * @param [in,out] errorList Множество для хранения обнаруженных ошибок.
+ * @param [in] options Параметры обработки: представление дерева (engine), способ переноса отрицаний (rewrite),
+ * форма записи (syntax) и проверка равносильности результата исходному выражению (verify);
+ * при различии добавляется ошибка verificationFailed, если равносильность не доказана — verificationUnproven.
+ * @param [in] pool Пул потоков для преобразований одного дерева (nullptr — в текущем потоке).
+ * @return true, если выражение обработано без ошибок, иначе false.
+ * @throw Error с типом outputFile, если запись в файл не удалась.
+ */
+bool processExpression(std::string_view expression, OutputWriter& output, bool echoInput, std::set<Error>& errorList, const ProgramOptions& options, ForkJoinPool* pool) {
+    StreamEmitter<OutputWriter> emit{ output, echoInput };
+    return runCheckedPipeline(expression, emit, errorList, options.engine, options.rewrite, pool, options.syntax, options.verify);
+}
+
+/**
+ * @brief Формирует подробности ошибки tooManyVariables.
+ * @param count Количество переменных выражения.
+ * @param limit Допустимое количество переменных.
+ * @return Строка вида "33 переменных, допустимо не более 32".
+ */
+static std::string variableLimitDetail(size_t count, size_t limit) {
+    return std::to_string(count) + " переменных, допустимо не более " + std::to_string(limit);
+}
+
+/**
+ * @brief Строит таблицу истинности выражения, заданного строкой.
+ * @param [in] expression Строка с логическим выражением.
+ * @param [out] table Таблица истинности.
+ * @param [in,out] errorList Множество для хранения обнаруженных ошибок.
+ * @param [in] syntax Форма записи выражения.
+ * @return true, если выражение разобрано без ошибок и таблица построена.
+ */
+bool processTruthTable(std::string_view expression, TruthTable& table, std::set<Error>& errorList, InputSyntax syntax) {
+    ExpressionSource source = { expression, syntax };
+    ExpressionNode* exprTree = parseSource(source, errorList);
+    if (!errorList.empty()) {
+        releaseExpressionTree(exprTree);
+        return false;
+    }
+
+    bool built = buildTruthTable(exprTree, table);
+    releaseExpressionTree(exprTree);
+    if (!built) {
+        errorList.insert(Error(Error::tooManyVariables, -1, variableLimitDetail(table.variables.size(), TruthTable::maxVariables)));
+    }
+    return built;
+}
+
+/**
+ * @brief Выводит таблицу истинности одной строкой.
+ *
+ * Строка содержит имена переменных через пробел, двоеточие, значения выражения шестнадцатеричным числом,
+ * бит index которого — значение на наборе index (старшие наборы слева), и количество выполняющих наборов в скобках.
+ * Например, для a & b || c получается "a b c: f8 (5)".
+ * @param table Таблица истинности.
+ * @param output Выходной файл (OutputWriter) или буфер (std::string).
+ */
+template <typename Sink>
+static void appendTruthTable(const TruthTable& table, Sink& output) {
+    for (size_t i = 0; i < table.variables.size(); i++) {
+        if (i > 0) output += ' ';
+        output += table.variables[i].name();
+    }
+    output += ": ";
+
+    static const char digits[] = "0123456789abcdef";
+    size_t wordDigits = static_cast<size_t>(std::min<uint64_t>(std::max<uint64_t>(table.size() / 4, 1), 16));
+    char buffer[16];
+    for (size_t w = table.words.size(); w-- > 0;) {
+        uint64_t word = table.words[w];
+        for (size_t j = 0; j < wordDigits; j++) {
+            buffer[wordDigits - 1 - j] = digits[(word >> (4 * j)) & 15];
+        }
+        output += std::string_view(buffer, wordDigits);
+    }
+
+    output += " (";
+    output += std::to_string(table.models);
+    output += ')';
+}
+
+/**
+ * @brief Строит таблицу истинности выражения и выводит ее строкой appendTruthTable.
+ * @param expression Строка с логическим выражением.
+ * @param output Выходной файл (OutputWriter) или буфер (std::string).
+ * @param errorList Множество для хранения обнаруженных ошибок.
+ * @param syntax Форма записи выражения.
+ * @return true, если таблица построена и выведена.
+ */
+template <typename Sink>
+static bool writeTruthTable(std::string_view expression, Sink& output, std::set<Error>& errorList, InputSyntax syntax) {
+    // Таблица принадлежит потоку, чтобы в пакетном режиме память не выделялась для каждой строки
+    thread_local TruthTable table;
+    if (!processTruthTable(expression, table, errorList, syntax)) {
+        return false;
+    }
+    appendTruthTable(table, output);
+    return true;
+}
+
+/**
+ * @brief Строит таблицу истинности выражения и выводит ее в файл.
+ * @param [in] expression Строка с логическим выражением.
+ * @param [in,out] output Выходной файл.
+ * @param [in,out] errorList Множество для хранения обнаруженных ошибок.
+ * @param [in] syntax Форма записи выражения.
+ * @return true, если таблица построена и выведена; при ошибках в файл ничего не выводится.
+ * @throw Error с типом outputFile, если запись в файл не удалась.
+ */
+bool processTruthTable(std::string_view expression, OutputWriter& output, std::set<Error>& errorList, InputSyntax syntax) {
+    return writeTruthTable(expression, output, errorList, syntax);
+}
+
+/**
+ * @brief Подсчитывает выполняющие наборы выражения, заданного строкой.
+ * @param [in] expression Строка с логическим выражением.
+ * @param [out] result Итоги перебора.
+ * @param [in,out] errorList Множество для хранения обнаруженных ошибок.
+ * @param [in] syntax Форма записи выражения.
+ * @param [in] pool Пул потоков (nullptr — в текущем потоке).
+ * @return true, если выражение разобрано без ошибок и перебор выполнен.
+ */
+bool processModelCount(std::string_view expression, ModelCount& result, std::set<Error>& errorList, InputSyntax syntax, ForkJoinPool* pool) {
+    ExpressionSource source = { expression, syntax };
+    ExpressionNode* exprTree = parseSource(source, errorList);
+    if (!errorList.empty()) {
+        releaseExpressionTree(exprTree);
+        return false;
+    }
+
+    bool counted = countModels(exprTree, result, pool);
+    releaseExpressionTree(exprTree);
+    if (!counted) {
+        errorList.insert(Error(Error::tooManyVariables, -1, variableLimitDetail(result.variables.size(), ModelCount::maxVariables)));
+    }
+    return counted;
+}
+
+/**
+ * @brief Выводит набор значений переменных в виде "a = 1, b = 0".
+ * @param result Итоги перебора с именами переменных.
+ * @param assignment Номер набора.
+ * @param output Выходной файл (OutputWriter) или буфер (std::string).
+ */
+template <typename Sink>
+static void appendAssignment(const ModelCount& result, uint64_t assignment, Sink& output) {
+    for (size_t i = 0; i < result.variables.size(); i++) {
+        if (i > 0) output += ", ";
+        output += result.variables[i].name();
+        output += (assignment >> i) & 1 ? " = 1" : " = 0";
+    }
+}
+
+/**
+ * @brief Выводит итоги перебора одной строкой.
+ *
+ * Строка содержит имена переменных через пробел, двоеточие, количество выполняющих наборов из общего числа
+ * и первые выполняющий и опровергающий наборы, если они есть. Например, для a & b получается
+ * "a b: 1 из 4; выполняющий набор: a = 1, b = 1; опровергающий набор: a = 0, b = 0".
+ * @param result Итоги перебора.
+ * @param output Выходной файл (OutputWriter) или буфер (std::string).
+ */
+template <typename Sink>
+static void appendModelCount(const ModelCount& result, Sink& output) {
+    for (size_t i = 0; i < result.variables.size(); i++) {
+        if (i > 0) output += ' ';
+        output += result.variables[i].name();
+    }
+    output += ": ";
+    output += std::to_string(result.models);
+    output += " из ";
+    output += std::to_string(result.size());
+
+    if (result.isSatisfiable()) {
+        output += "; выполняющий набор: ";
+        appendAssignment(result, result.firstModel, output);
+    }
+    if (!result.isTautology()) {
+        output += "; опровергающий набор: ";
+        appendAssignment(result, result.firstCountermodel, output);
+    }
+}
+
+/**
+ * @brief Подсчитывает выполняющие наборы выражения и выводит итоги строкой appendModelCount.
+ * @param expression Строка с логическим выражением.
+ * @param output Выходной файл (OutputWriter) или буфер (std::string).
+ * @param errorList Множество для хранения обнаруженных ошибок.
+ * @param syntax Форма записи выражения.
+ * @param pool Пул потоков (nullptr — в текущем потоке).
+ * @return true, если перебор выполнен и итоги выведены.
+ */
+template <typename Sink>
+static bool writeModelCount(std::string_view expression, Sink& output, std::set<Error>& errorList, InputSyntax syntax, ForkJoinPool* pool) {
+    thread_local ModelCount result;
+    if (!processModelCount(expression, result, errorList, syntax, pool)) {
+        return false;
+    }
+    appendModelCount(result, output);
+    return true;
+}
+
+/**
+ * @brief Подсчитывает выполняющие наборы выражения и выводит итоги в файл.
+ * @param [in] expression Строка с логическим выражением.
+ * @param [in,out] output Выходной файл.
+ * @param [in,out] errorList Множество для хранения обнаруженных ошибок.
+ * @param [in] syntax Форма записи выражения.
+ * @param [in] pool Пул потоков (nullptr — в текущем потоке).
+ * @return true, если перебор выполнен и итоги выведены; при ошибках в файл ничего не выводится.
+ * @throw Error с типом outputFile, если запись в файл не удалась.
+ */
+bool processModelCount(std::string_view expression, OutputWriter& output, std::set<Error>& errorList, InputSyntax syntax, ForkJoinPool* pool) {
+    return writeModelCount(expression, output, errorList, syntax, pool);
+}
+
+/**
+ * @brief Обрабатывает одну строку в пакетном режиме.
+ *
+ * Записывает одну строку: преобразованное выражение или описание ошибок этой строки.
+ * Пустая строка сохраняется, чтобы номера строк результата совпадали с входными.
+ * @param line Строка входного файла.
+ * @param output Выходной файл (OutputWriter) или буфер (std::string).
+ * @param errorList Множество, в которое записываются ошибки строки.
+ * @param options Параметры запуска программы.
+ * @return true, если строка обработана без ошибок.
+ */
+template <typename Sink>
+static bool processBatchLine(std::string_view line, Sink& output, std::set<Error>& errorList, const ProgramOptions& options) {
+    // Пустые строки сохраняются, чтобы номера строк результата совпадали с входными
+    if (std::all_of(line.begin(), line.end(), [](char c) { return isspace(static_cast<unsigned char>(c)); })) {
+        output += '\n';
+        return true;
+    }
+
+    // Узлы каждого выражения размещаются в пуле потока, который сбрасывается после обработки строки
+    thread_local NodeArena arena;
+    ArenaScope scope(arena);
+
+    errorList.clear();
+    StreamEmitter<Sink> emit{ output, false };
+    bool processed;
+    if (options.truthTable) {
+        processed = writeTruthTable(line, output, errorList, options.syntax);
+    }
+    else if (options.countModels) {
+        processed = writeModelCount(line, output, errorList, options.syntax, nullptr);
+    }
+    else {
+        processed = runCheckedPipeline(line, emit, errorList, options.engine, options.rewrite, nullptr, options.syntax, options.verify);
+    }
+    arena.reset();
+
+    if (processed) {
+        output += '\n';
+        return true;
+    }
+
+    // Ошибки строки записываются на ее место в выходном файле
+    bool first = true;
+    for (const auto& error : errorList) {
+        if (!first) output += ' ';
+        output += error.description;
+        first = false;
+    }
+    output += '\n';
+    return false;
+}
+
+/**
+ * @brief Выводит в консоль ошибки строки с указанием ее номера.
+ * @param lineNumber Номер строки (с единицы).
+ * @param errorList Ошибки строки.
+ * @param diagnostics Поток для сообщений об ошибках.
+ */
+static void reportLineErrors(int lineNumber, const std::set<Error>& errorList, std::wostream& diagnostics) {
+    for (const auto& error : errorList) {
+        diagnostics << L"Строка " << lineNumber << L": ";
+        error.message(diagnostics);
+    }
+}
+
+/**
+ * @brief Передает обработчику все строки входного файла пакетного режима.
+ *
+ * Файл отображается в память, и строки передаются без копирования; их представления действительны до
+ * возврата из функции. Вход "-" (стандартный ввод) читается блоками по мере поступления данных, и
+ * представление строки действительно только во время вызова обработчика. Перед ожиданием новых данных
+ * из потока и перед возвратом вызывается drain.
+ * @param inputFile Путь к входному файлу или "-".
+ * @param onLine Обработчик (строка, номер строки, действительна ли строка до возврата из функции).
+ * @param drain Обработчик, завершающий вывод уже прочитанных строк.
+ * @throw Error с типом inputFile, если файл не удалось открыть или прочитать.
+ */
+template <typename LineHandler, typename DrainHandler>
+static void readBatchLines(const std::string& inputFile, LineHandler onLine, DrainHandler drain) {
+    int lineNumber = 0;
+
+    if (inputFile == "-") {
+#ifdef _WIN32
+        LineReader reader(_fileno(stdin));
+#else
+        LineReader reader(STDIN_FILENO);
+#endif
+        std::string_view line;
+
+        while (true) {
+            // Результаты выводятся до ожидания новых данных
+            if (reader.needsRead()) drain();
+            if (!reader.next(line)) break;
+
+            onLine(line, ++lineNumber, false);
+        }
+        return;
+    }
+
+    MappedFile input(inputFile);      // Отображение входного файла в память
+    std::string_view content = input.view();
+    size_t lineStart = 0;
+
+    while (lineStart < content.size()) {
+        // Выделение очередной строки без копирования
+        size_t lineEnd = content.find('\n', lineStart);
+        if (lineEnd == std::string_view::npos) {
+            lineEnd = content.size();
+        }
+        onLine(content.substr(lineStart, lineEnd - lineStart), ++lineNumber, true);
+        lineStart = lineEnd + 1;
+    }
+
+    drain();
+}
+
+/**
+ * @brief Блок строк пакетного режима, обрабатываемый одной задачей пула потоков.
+ */
+struct BatchChunk {
+    static constexpr size_t maxLines = 1024;     ///< Наибольшее количество строк в блоке.
+    static constexpr size_t maxBytes = 1 << 20;  ///< Наибольший объем копий строк в блоке.
+
+    int firstLine = 0;                       ///< Номер первой строки блока.
+    std::vector<std::string_view> lines;     ///< Строки блока.
+    std::string storage;                     ///< Копии строк, прочитанных из потока.
+    std::string output;                      ///< Результаты строк блока.
+    std::vector<std::pair<int, std::set<Error>>> errors; ///< Ошибки строк блока по номерам строк.
+};
+
+/**
+ * @brief Обрабатывает строки пакетного режима в нескольких потоках.
+ *
+ * Строки группируются в блоки, которые обрабатываются задачами пула потоков; у каждого потока свой
+ * пул узлов и свои плоские деревья. Результаты блоков записываются в выходной файл в порядке строк
+ * входного файла. Одновременно обрабатывается ограниченное число блоков, поэтому расход памяти не
+ * зависит от размера входа.
+ * @param options Параметры запуска программы.
+ * @param output Выходной файл.
+ * @param diagnostics Поток для сообщений об ошибках.
+ * @return true, если все строки обработаны без ошибок.
+ */
+static bool processBatchParallel(const ProgramOptions& options, OutputWriter& output, std::wostream& diagnostics) {
+    ThreadPool pool(options.threads);
+    const size_t maxInFlight = options.threads * 4;
+
+    std::deque<std::pair<std::unique_ptr<BatchChunk>, std::future<void>>> inFlight;
+    std::unique_ptr<BatchChunk> current(new BatchChunk());
+    bool success = true;
+
+    // Запись результатов самого раннего блока
+    auto writeOldest = [&]() {
+        inFlight.front().second.get();
+        BatchChunk& chunk = *inFlight.front().first;
+
+        for (const auto& lineErrors : chunk.errors) {
+            reportLineErrors(lineErrors.first, lineErrors.second, diagnostics);
+            success = false;
+        }
+        output += chunk.output;
+        inFlight.pop_front();
+    };
+
+    // Передача накопленного блока пулу
+    auto submit = [&]() {
+        if (current->lines.empty()) return;
+
+        if (inFlight.size() >= maxInFlight) writeOldest();
+
+        BatchChunk* chunk = current.get();
+        std::future<void> done = pool.submit([chunk, &options]() {
+            std::set<Error> errorList;
+            int lineNumber = chunk->firstLine;
+            for (std::string_view line : chunk->lines) {
+                if (!processBatchLine(line, chunk->output, errorList, options)) {
+                    chunk->errors.emplace_back(lineNumber, errorList);
+                }
+                lineNumber++;
+            }
+        });
+        inFlight.emplace_back(std::move(current), std::move(done));
+        current.reset(new BatchChunk());
+    };
+
+    try {
+        readBatchLines(options.inputFile,
+            [&](std::string_view line, int lineNumber, bool stable) {
+                if (!stable) {
+                    // Копии строк не должны перемещаться при добавлении новых
+                    if (current->storage.size() + line.size() > current->storage.capacity()) {
+                        submit();
+                        current->storage.reserve(std::max(BatchChunk::maxBytes, line.size()));
+                    }
+                    current->storage.append(line.data(), line.size());
+                    line = std::string_view(current->storage.data() + current->storage.size() - line.size(), line.size());
+                }
+
+                if (current->lines.empty()) current->firstLine = lineNumber;
+                current->lines.push_back(line);
+
+                if (current->lines.size() == BatchChunk::maxLines) submit();
+            },
+            [&]() {
+                submit();
+                while (!inFlight.empty()) writeOldest();
+                output.flush();
+            });
+    }
+    catch (...) {
+        // Задачи ссылаются на строки входного файла: они должны завершиться до выхода
+        for (auto& chunk : inFlight) chunk.second.wait();
+        throw;
+    }
+
+    return success;
+}
+
+/**
+ * @brief Обрабатывает все выражения входного файла в пакетном режиме.
+ *
+ * Входной файл отображается в память, и каждая его строка обрабатывается как отдельное выражение
+ * без копирования. Вход "-" (стандартный ввод) читается блоками по мере поступления данных. В выходной файл для каждой строки
+ * записывается одна строка: преобразованное выражение или описание ошибок этой строки.
+ * Результаты накапливаются в буфере и не сбрасываются после каждой строки; при чтении из потока буфер
+ * сбрасывается только перед ожиданием новых данных, чтобы программа могла работать фильтром в конвейере.
+ * Ошибки дополнительно выводятся в консоль с указанием номера строки (при выводе в "-" — в поток ошибок).
+ * При options.threads больше 1 строки обрабатываются в нескольких потоках, а результаты записываются
+ * в порядке строк входного файла.
+ * @param [in] options Параметры запуска программы (пути к файлам, представление дерева, количество потоков).
+ * @return true, если все строки обработаны без ошибок, иначе false.
+ * @throw Error с типом inputFile или outputFile, если файл не удалось открыть.
+ */
+bool processBatch(const ProgramOptions& options) {
+    OutputWriter output(options.outputFile);  // Буферизованная запись результатов
+    std::wostream& diagnostics = options.outputFile == "-" ? std::wcerr : std::wcout;
+
+    bool success = true;
+    if (options.threads > 1) {
+        success = processBatchParallel(options, output, diagnostics);
+    }
+    else {
+        std::set<Error> errorList;
+        readBatchLines(options.inputFile,
+            [&](std::string_view line, int lineNumber, bool) {
+                if (!processBatchLine(line, output, errorList, options)) {
+                    reportLineErrors(lineNumber, errorList, diagnostics);
+                    success = false;
+                }
+            },
+            [&]() { output.flush(); });
+    }
+
+    output.close();
+    return success;
+}
+
+/**
+ * @brief Конструктор класса MappedFile.
+ *
+ * Открывает файл и отображает его содержимое в память только для чтения.
+ * Пустой файл не отображается: его содержимое представляется пустой строкой.
+ * @param filePath Путь к файлу.
+ * @throw Error с типом inputFile, если файл не удалось открыть или отобразить.
+ */
+MappedFile::MappedFile(const std::string& filePath) : data(nullptr), size(0) {
+#ifdef _WIN32
+    fileHandle = nullptr;
+    mappingHandle = nullptr;
+
+    HANDLE file = CreateFileA(filePath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        throw Error(Error::inputFile);
+    }
+
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(file, &fileSize)) {
+        CloseHandle(file);
+        throw Error(Error::inputFile);
+    }
+
+    fileHandle = file;
+    size = static_cast<size_t>(fileSize.QuadPart);
+    if (size == 0) {
+        return;
+    }
+
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!mapping) {
+        CloseHandle(file);
+        throw Error(Error::inputFile);
+    }
+
+    const void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (!view) {
+        CloseHandle(mapping);
+        CloseHandle(file);
+        throw Error(Error::inputFile);
+    }
+
+    mappingHandle = mapping;
+    data = static_cast<const char*>(view);
+#else
+    int fd = open(filePath.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw Error(Error::inputFile);
+    }
+
+    struct stat fileStat;
+    if (fstat(fd, &fileStat) != 0) {
+        close(fd);
+        throw Error(Error::inputFile);
+    }
+
+    size = static_cast<size_t>(fileStat.st_size);
+    if (size == 0) {
+        close(fd);
+        return;
+    }
+
+    void* view = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd); // Отображение остается действительным после закрытия дескриптора
+    if (view == MAP_FAILED) {
+        throw Error(Error::inputFile);
+    }
+
+    madvise(view, size, MADV_SEQUENTIAL);
+    data = static_cast<const char*>(view);
+#endif
+}
+
+/**
+ * @brief Деструктор класса MappedFile.
+ *
+ * Освобождает отображение и закрывает файл.
+ */
+MappedFile::~MappedFile() {
+#ifdef _WIN32
+    if (data) UnmapViewOfFile(data);
+    if (mappingHandle) CloseHandle(mappingHandle);
+    if (fileHandle) CloseHandle(fileHandle);
+#else
+    if (data) munmap(const_cast<char*>(data), size);
+#endif
+}
+
+/**
+ * @brief Возвращает очередную строку входного потока без завершающего перевода строки.
+ *
+ * Ищет перевод строки в уже прочитанных данных и читает поток только при его отсутствии. Перед чтением
+ * непрочитанный остаток переносится в начало буфера; если он занимает весь буфер, буфер удваивается.
+ * @param [out] line Очередная строка, действительная до следующего вызова.
+ * @return true, если строка прочитана, false в конце потока.
+ * @throw Error с типом inputFile, если чтение не удалось.
+ */
+bool LineReader::next(std::string_view& line) {
+    while (true) {
+        const char* start = buffer.data() + begin;
+        const char* newline = static_cast<const char*>(std::memchr(start, '\n', end - begin));
+        if (newline) {
+            line = std::string_view(start, newline - start);
+            begin += line.size() + 1;
+            return true;
+        }
+
+        if (finished) {
+            if (begin == end) return false;
+
+            // Последняя строка без перевода строки
+            line = std::string_view(start, end - begin);
+            begin = end;
+            return true;
+        }
+
+        // Перенос остатка в начало буфера и дочитывание
+        std::memmove(buffer.data(), start, end - begin);
+        end -= begin;
+        begin = 0;
+        if (end == buffer.size()) {
+            buffer.resize(buffer.size() * 2);
+        }
+
+#ifdef _WIN32
+        int count = _read(descriptor, buffer.data() + end, static_cast<unsigned>(std::min(buffer.size() - end, static_cast<size_t>(INT_MAX))));
+#else
+        ssize_t count = read(descriptor, buffer.data() + end, buffer.size() - end);
+        if (count < 0 && errno == EINTR) continue;
+#endif
+        if (count < 0) {
+            throw Error(Error::inputFile);
+        }
+        if (count == 0) {
+            finished = true;
+        }
+        end += static_cast<size_t>(count);
+    }
+}
+
+/**
+ * @brief Деструктор класса OutputWriter.
+ *
+ * Записывает остаток буфера и закрывает файл, не сообщая об ошибках записи.
+ */
+OutputWriter::~OutputWriter() {
+    try {
+        flush();
+    }
+    catch (const Error&) {
+        // Ошибки записи сообщаются только из close()
+    }
+
+    if (file && file != stdout) std::fclose(file);
+}
+
+/**
+ * @brief Открывает файл, если он еще не открыт.
+ * @throw Error с типом outputFile, если файл не удалось открыть.
+ */
+void OutputWriter::ensureOpen() {
+    if (file) return;
+
+    file = path == "-" ? stdout : std::fopen(path.c_str(), "w");
+    if (!file) {
+        throw Error(Error::outputFile);
+    }
+
+    // Буферизация выполняется самим объектом
+    std::setvbuf(file, nullptr, _IONBF, 0);
+}
+
+/**
+ * @brief Записывает содержимое буфера в файл.
+ * @throw Error с типом outputFile, если запись не удалась.
+ */
+void OutputWriter::flush() {
+    if (buffer.empty()) return;
+
+    writeDirect(buffer);
+    buffer.clear();
+}
+
+/**
+ * @brief Записывает остаток буфера и закрывает файл.
+ *
+ * Файл с отложенным открытием, в который ничего не было выведено, создается пустым.
+ * Стандартный вывод не закрывается, а только сбрасывается.
+ * @throw Error с типом outputFile, если запись не удалась.
+ */
+void OutputWriter::close() {
+    ensureOpen();
+    flush();
+
+    std::FILE* closing = file;
+    file = nullptr;
+    if ((closing == stdout ? std::fflush(closing) : std::fclose(closing)) != 0) {
+        throw Error(Error::outputFile);
+    }
+}
+
+/**
+ * @brief Записывает фрагмент в файл, минуя буфер.
+ * @param text Фрагмент.
+ * @throw Error с типом outputFile, если запись не удалась.
+ */
+void OutputWriter::writeDirect(std::string_view text) {
+    ensureOpen();
+
+    if (std::fwrite(text.data(), 1, text.size(), file) != text.size()) {
+        throw Error(Error::outputFile);
+    }
+}
+
+/**
+ * @brief Выбирает ядро поиска разделителей для токенизатора.
+ *
+ * По умолчанию при запуске выбирается наиболее быстрое ядро, поддерживаемое процессором.
+ * @param [in] kernel Требуемое ядро.
+ * @return true, если ядро поддерживается процессором и выбрано, иначе false.
+ */
+bool selectScanKernel(ScanKernel kernel) {
+    if (!isScanKernelSupported(kernel)) {
+        return false;
+    }
+
+    currentScanKernel = kernel;
+    scanBlock = scanBlockFunction(kernel);
+    bitKernel = bitKernelFunction(kernel);
+    return true;
+}
+
+/**
+ * @brief Возвращает текущее ядро поиска разделителей.
+ * @return Ядро, используемое токенизатором.
+ */
+ScanKernel activeScanKernel() {
+    return currentScanKernel;
+}
+
+/**
+ * @brief Освобождает память узла.
+ *
+ * Память узла из активного пула возвращается в список свободных ячеек пула, иначе в общую кучу.
+ * @param p Указатель на память узла.
+ */
+void ExpressionNode::operator delete(void* p) {
+    ++releaseCount();
+    NodeArena* arena = NodeArena::current();
+    if (arena && arena->owns(p)) {
+        arena->release(p);
+        return;
+    }
+
+    // Память чужого или неактивного пула нельзя возвращать в общую кучу
+    assert(!NodeArena::ownedByAnyArena(p));
+    ::operator delete(p);
+}
+
+/**
+ * @brief Освобождает дерево выражения.
+ *
+ * Узлы, размещенные в активном пуле, не удаляются по одному: они освобождаются вместе
+ * при сбросе пула его владельцем. Остальные деревья удаляются обычным образом.
+ * @param [in] node Указатель на корень дерева.
+ */
+void releaseExpressionTree(ExpressionNode* node) {
+    NodeArena* arena = NodeArena::current();
+    if (arena && arena->owns(node)) {
+        return;
+    }
+
+    delete node;
+}
+
+/**
+ * @brief Строит плоское дерево выражения из вектора токенов.
+ *
+ * Работает так же, как buildExpressionTree для узлов ExpressionNode, и сообщает о тех же ошибках.
+ * @param [in] tokens Вектор токенов в постфиксной записи.
+ * @param [in,out] errorList Множество для хранения обнаруженных ошибок.
+ * @param [in,out] tree Плоское дерево, в которое добавляются узлы.
+ * @return Индекс корня построенного дерева или nullNode при ошибке.
+ */
+NodeIndex buildExpressionTree(const std::vector<Token>& tokens, std::set<Error>& errorList, FlatExpression& tree) {
+    std::vector<NodeIndex> stack;
+    int lastOperandPosition = 0; // Для отслеживания позиции последнего операнда
+
+    tree.reserve(tree.size() + tokens.size());
+
+    for (const auto& token : tokens) {
+        if (token.type == TokenType::Variable) {
+            stack.push_back(tree.addNode(token.type, token.value));
+            lastOperandPosition = token.position;
+            continue;
+        }
+
+        if (token.type == TokenType::Not) {
+            if (stack.empty()) {
+                errorList.insert(Error(Error::ErrorType::insufficientOperands, token.position));
+                continue;
+            }
+
+            NodeIndex operand = stack.back();
+            stack.back() = tree.addNode(token.type, Symbol(), nullNode, operand);
+            continue;
+        }
+
+        // Бинарные операции
+        if (stack.size() < 2) {
+            errorList.insert(Error(Error::ErrorType::insufficientOperands, token.position));
+            continue;
+        }
+
+        NodeIndex right = stack.back();
+        stack.pop_back();
+        NodeIndex left = stack.back();
+        stack.back() = tree.addNode(token.type, Symbol(), left, right);
+    }
+
+    if (stack.size() != 1) {
+        int errorPosition = lastOperandPosition;
+        if (stack.empty()) {
+            errorPosition = tokens.empty() ? 0 : tokens.back().position;
+        }
+        errorList.insert(Error(Error::ErrorType::missingOperation, errorPosition));
+        return nullNode;
+    }
+
+    return stack.back();
+}
+
+/**
+ * @brief Преобразует дерево из узлов ExpressionNode в плоское дерево.
+ * @param [in] node Указатель на корень исходного дерева.
+ * @param [in,out] tree Плоское дерево, в которое добавляются узлы.
+ * @return Индекс корня в плоском дереве или nullNode для пустого дерева.
+ */
+NodeIndex toFlatExpression(const ExpressionNode* node, FlatExpression& tree) {
+    if (!node) return nullNode;
+
+    // Элемент стека: исходный узел и ссылка на поле родителя, в которое записывается его индекс
+    struct Item {
+        const ExpressionNode* node;
+        NodeIndex parent;
+        bool isLeft;
+    };
+
+    NodeIndex root = nullNode;
+    std::vector<Item> stack = { { node, nullNode, false } };
+
+    while (!stack.empty()) {
+        Item item = stack.back();
+        stack.pop_back();
+
+        NodeIndex index = tree.addNode(item.node->type, item.node->value);
+        if (item.parent == nullNode) root = index;
+        else if (item.isLeft) tree.lefts[item.parent] = index;
+        else tree.rights[item.parent] = index;
+
+        if (item.node->right) stack.push_back({ item.node->right, index, false });
+        if (item.node->left) stack.push_back({ item.node->left, index, true });
+    }
+
+    return root;
+}
+
+/**
+ * @brief Преобразует плоское дерево в дерево из узлов ExpressionNode.
+ * @param [in] tree Плоское дерево.
+ * @param [in] root Индекс корня.
+ * @return Указатель на корень нового дерева или nullptr для пустого дерева.
+ */
+ExpressionNode* fromFlatExpression(const FlatExpression& tree, NodeIndex root) {
+    ExpressionNode* result = nullptr;
+    std::vector<std::pair<NodeIndex, ExpressionNode**>> stack = { { root, &result } };
+
+    while (!stack.empty()) {
+        auto item = stack.back();
+        stack.pop_back();
+
+        if (item.first == nullNode) continue;
+
+        ExpressionNode* node = new ExpressionNode(tree.type(item.first), Symbol());
+        node->value.id = tree.symbols[item.first];
+        *item.second = node;
+
+        stack.push_back({ tree.rights[item.first], &node->right });
+        stack.push_back({ tree.lefts[item.first], &node->left });
+    }
+
+    return result;
+}
+
+/**
+ * @brief Создает глубокую копию поддерева плоского дерева.
+ *
+ * Копия добавляется в конец массивов того же дерева.
+ * @param [in,out] tree Плоское дерево.
+ * @param [in] node Индекс корня копируемого поддерева.
+ * @return Индекс корня копии или nullNode, если входной индекс равен nullNode.
+ */
+NodeIndex copyNode(FlatExpression& tree, NodeIndex node) {
+    if (node == nullNode) return nullNode;
+
+    struct Item {
+        NodeIndex source;
+        NodeIndex parent;
+        bool isLeft;
+    };
+
+    NodeIndex root = nullNode;
+    std::vector<Item> stack = { { node, nullNode, false } };
+
+    while (!stack.empty()) {
+        Item item = stack.back();
+        stack.pop_back();
+
+        // Поля читаются до добавления узла: массивы могут быть перераспределены
+        NodeIndex left = tree.lefts[item.source];
+        NodeIndex right = tree.rights[item.source];
+        Symbol value;
+        value.id = tree.symbols[item.source];
+
+        NodeIndex index = tree.addNode(tree.type(item.source), value);
+        if (item.parent == nullNode) root = index;
+        else if (item.isLeft) tree.lefts[item.parent] = index;
+        else tree.rights[item.parent] = index;
+
+        if (right != nullNode) stack.push_back({ right, index, false });
+        if (left != nullNode) stack.push_back({ left, index, true });
+    }
+
+    return root;
+}
+
+/**
+ * @brief Обходит плоское дерево в обратном порядке (сначала поддеревья, затем узел).
+ *
+ * Поддеревья узла выбираются в момент его первого посещения, поэтому узлы, добавленные
+ * при обработке, не посещаются.
+ * @param tree Плоское дерево.
+ * @param root Индекс корня.
+ * @param visit Функция, вызываемая для каждого узла.
+ */
+template <typename Visit>
+static void visitPostOrder(FlatExpression& tree, NodeIndex root, Visit visit) {
+    if (root == nullNode) return;
+
+    std::vector<std::pair<NodeIndex, bool>> stack = { { root, false } }; // Пара: узел, обработаны ли поддеревья
+
+    while (!stack.empty()) {
+        auto item = stack.back();
+        stack.pop_back();
+
+        if (item.second) {
+            visit(item.first);
+            continue;
+        }
+
+        stack.push_back({ item.first, true });
+        if (tree.rights[item.first] != nullNode) stack.push_back({ tree.rights[item.first], false });
+        if (tree.lefts[item.first] != nullNode) stack.push_back({ tree.lefts[item.first], false });
+    }
+}
+
+/**
+ * @brief Преобразует операции импликации и эквивалентности в плоском дереве.
+ *
+ * Преобразует импликацию (A > B) в (!A | B) и эквивалентность (A ~ B) в ((A & B) | (!A & !B)).
+ * Исходные поддеревья A и B используются в результате повторно, копируются только
+ * поддеревья под добавленными отрицаниями эквивалентности.
+ * @param [in,out] tree Плоское дерево.
+ * @param [in] root Индекс корня.
+ */
+void transformImplicationAndEquivalence(FlatExpression& tree, NodeIndex root) {
+    visitPostOrder(tree, root, [&tree](NodeIndex node) {
+        // Преобразование импликации A > B в !A | B
+        if (tree.type(node) == TokenType::Implication) {
+            NodeIndex newNot = tree.addNode(TokenType::Not, Symbol(), nullNode, tree.lefts[node]);
+            tree.types[node] = TokenType::Or;
+            tree.lefts[node] = newNot;
+            return;
+        }
+
+        // Преобразование эквивалентности A ~ B в (A & B) | (!A & !B)
+        if (tree.type(node) == TokenType::Equivalence) {
+            NodeIndex left = tree.lefts[node];
+            NodeIndex right = tree.rights[node];
+
+            NodeIndex newRightL = tree.addNode(TokenType::Not, Symbol(), nullNode, copyNode(tree, left));
+            NodeIndex newRightR = tree.addNode(TokenType::Not, Symbol(), nullNode, copyNode(tree, right));
+            NodeIndex newRight = tree.addNode(TokenType::And, Symbol(), newRightL, newRightR);
+            NodeIndex newLeft = tree.addNode(TokenType::And, Symbol(), left, right);
+
+            tree.types[node] = TokenType::Or;
+            tree.lefts[node] = newLeft;
+            tree.rights[node] = newRight;
+        }
+    });
+}
+
+/**
+ * @brief Применяет законы де Моргана к плоскому дереву.
+ *
+ * Выполняет один проход, как simplifyExpression для узлов ExpressionNode. Узел исходной
+ * конъюнкции (дизъюнкции) становится левым отрицанием результата.
+ * @param [in,out] tree Плоское дерево.
+ * @param [in] root Индекс корня.
+ * @param [in,out] changed Устанавливается в true, если были внесены изменения.
+ * @return true, если были внесены изменения, иначе false.
+ */
+bool simplifyExpression(FlatExpression& tree, NodeIndex root, bool& changed) {
+    visitPostOrder(tree, root, [&tree, &changed](NodeIndex node) {
+        if (tree.type(node) != TokenType::Not || tree.rights[node] == nullNode) return;
+
+        NodeIndex operand = tree.rights[node];
+        TokenType operandType = tree.type(operand);
+        if (operandType != TokenType::And && operandType != TokenType::Or) return;
+
+        // !(A & B) → !A | !B, !(A | B) → !A & !B
+        NodeIndex leftOperand = tree.lefts[operand];
+        NodeIndex rightOperand = tree.rights[operand];
+
+        tree.types[operand] = TokenType::Not;
+        tree.lefts[operand] = nullNode;
+        tree.rights[operand] = leftOperand;
+        NodeIndex newNotRight = tree.addNode(TokenType::Not, Symbol(), nullNode, rightOperand);
+
+        tree.types[node] = operandType == TokenType::And ? TokenType::Or : TokenType::And;
+        tree.lefts[node] = operand;
+        tree.rights[node] = newNotRight;
+
+        changed = true;
+    });
+
+    return changed;
+}
+
+/**
+ * @brief Удаляет двойные отрицания в плоском дереве.
+ *
+ * Преобразует выражения вида !!A в A.
+ * @param [in,out] tree Плоское дерево.
+ * @param [in] root Индекс корня.
+ */
+void removeDoubleNot(FlatExpression& tree, NodeIndex root) {
+    visitPostOrder(tree, root, [&tree](NodeIndex node) {
+        if (tree.type(node) != TokenType::Not) return;
+
+        NodeIndex temp = tree.rights[node];
+        if (temp == nullNode || tree.type(temp) != TokenType::Not) return;
+
+        NodeIndex inner = tree.rights[temp];
+        if (inner == nullNode) return;
+
+        tree.types[node] = tree.types[inner];
+        tree.symbols[node] = tree.symbols[inner];
+        tree.lefts[node] = tree.lefts[inner];
+        tree.rights[node] = tree.rights[inner];
+    });
+}
+
+/**
+ * @brief Преобразует плоское дерево в инфиксную строку.
+ *
+ * Расставляет скобки по тем же правилам, что и expressionTreeToInfix для узлов ExpressionNode.
+ * @param [in] tree Плоское дерево.
+ * @param [in] root Индекс корня.
+ * @return Строковое представление выражения в инфиксной форме.
+ */
+std::string expressionTreeToInfix(const FlatExpression& tree, NodeIndex root) {
+    std::string out;
+    appendInfix(FlatTreeView{ tree }, root, out);
+    return out;
+}
+
+/**
+ * @brief Строит граф выражения с общими подвыражениями из вектора токенов.
+ *
+ * Работает так же, как buildExpressionTree для узлов ExpressionNode, и сообщает о тех же ошибках.
+ * @param [in] tokens Вектор токенов в постфиксной записи.
+ * @param [in,out] errorList Множество для хранения обнаруженных ошибок.
+ * @param [in,out] dag Граф, в который добавляются узлы.
+ * @return Индекс корня построенного графа или nullNode при ошибке.
+ */
+NodeIndex buildExpressionTree(const std::vector<Token>& tokens, std::set<Error>& errorList, ExpressionDag& dag) {
+    std::vector<NodeIndex> stack;
+    int lastOperandPosition = 0; // Для отслеживания позиции последнего операнда
+
+    for (const auto& token : tokens) {
+        if (token.type == TokenType::Variable) {
+            stack.push_back(dag.makeNode(token.type, token.value));
+            lastOperandPosition = token.position;
+            continue;
+        }
+
+        if (token.type == TokenType::Not) {
+            if (stack.empty()) {
+                errorList.insert(Error(Error::ErrorType::insufficientOperands, token.position));
+                continue;
+            }
+
+            stack.back() = dag.makeNode(token.type, Symbol(), nullNode, stack.back());
+            continue;
+        }
+
+        // Бинарные операции
+        if (stack.size() < 2) {
+            errorList.insert(Error(Error::ErrorType::insufficientOperands, token.position));
+            continue;
+        }
+
+        NodeIndex right = stack.back();
+        stack.pop_back();
+        stack.back() = dag.makeNode(token.type, Symbol(), stack.back(), right);
+    }
+
+    if (stack.size() != 1) {
+        int errorPosition = lastOperandPosition;
+        if (stack.empty()) {
+            errorPosition = tokens.empty() ? 0 : tokens.back().position;
+        }
+        errorList.insert(Error(Error::ErrorType::missingOperation, errorPosition));
+        return nullNode;
+    }
+
+    return stack.back();
+}
+
+/**
+ * @brief Перестраивает граф снизу вверх, обрабатывая каждый общий узел один раз.
+ *
+ * Для каждого узла, достижимого из корня, вызывает rebuild с индексами уже перестроенных поддеревьев
+ * и запоминает результат, поэтому время прохода пропорционально числу уникальных узлов, а не размеру
+ * развернутого дерева.
+ * @param dag Граф выражения.
+ * @param root Индекс корня.
+ * @param rebuild Функция (узел, новое левое поддерево, новое правое поддерево) → индекс нового узла.
+ * @return Индекс корня перестроенного графа.
+ */
+template <typename Rebuild>
+static NodeIndex rewriteDag(ExpressionDag& dag, NodeIndex root, Rebuild rebuild) {
+    if (root == nullNode) return nullNode;
+
+    std::vector<NodeIndex> memo(dag.size(), nullNode); // Результаты для узлов, существовавших до прохода
+    std::vector<std::pair<NodeIndex, bool>> stack = { { root, false } }; // Пара: узел, обработаны ли поддеревья
+
+    while (!stack.empty()) {
+        auto item = stack.back();
+        stack.pop_back();
+
+        NodeIndex node = item.first;
+        if (memo[node] != nullNode) continue;
+
+        NodeIndex left = dag.left(node);
+        NodeIndex right = dag.right(node);
+
+        if (!item.second) {
+            stack.push_back({ node, true });
+            if (right != nullNode && memo[right] == nullNode) stack.push_back({ right, false });
+            if (left != nullNode && memo[left] == nullNode) stack.push_back({ left, false });
+            continue;
+        }
+
+        memo[node] = rebuild(node, left == nullNode ? nullNode : memo[left], right == nullNode ? nullNode : memo[right]);
+    }
+
+    return memo[root];
+}
+
+/**
+ * @brief Преобразует операции импликации и эквивалентности в графе.
+ *
+ * Преобразует импликацию (A > B) в (!A | B) и эквивалентность (A ~ B) в ((A & B) | (!A & !B)).
+ * Операнды эквивалентности не копируются: оба вхождения ссылаются на один узел.
+ * @param [in,out] dag Граф выражения.
+ * @param [in] root Индекс корня.
+ * @return Индекс корня преобразованного выражения.
+ */
+NodeIndex transformImplicationAndEquivalence(ExpressionDag& dag, NodeIndex root) {
+    return rewriteDag(dag, root, [&dag](NodeIndex node, NodeIndex left, NodeIndex right) {
+        TokenType type = dag.type(node);
+
+        // Преобразование импликации A > B в !A | B
+        if (type == TokenType::Implication) {
+            return dag.makeNode(TokenType::Or, Symbol(), dag.makeNode(TokenType::Not, Symbol(), nullNode, left), right);
+        }
+
+        // Преобразование эквивалентности A ~ B в (A & B) | (!A & !B)
+        if (type == TokenType::Equivalence) {
+            NodeIndex both = dag.makeNode(TokenType::And, Symbol(), left, right);
+            NodeIndex neither = dag.makeNode(TokenType::And, Symbol(),
+                dag.makeNode(TokenType::Not, Symbol(), nullNode, left),
+                dag.makeNode(TokenType::Not, Symbol(), nullNode, right));
+            return dag.makeNode(TokenType::Or, Symbol(), both, neither);
+        }
+
+        return dag.makeNode(type, dag.value(node), left, right);
+    });
+}
+
+/**
+ * @brief Строит отрицание подвыражения графа, полностью перенося его к переменным.
+ *
+ * Конъюнкция и дизъюнкция заменяются двойственной операцией над отрицаниями операндов,
+ * двойное отрицание сокращается. Результат для каждого узла запоминается, поэтому общее
+ * подвыражение обрабатывается один раз.
+ * @param dag Граф выражения.
+ * @param node Индекс узла.
+ * @param memo Отрицания уже обработанных узлов.
+ * @return Индекс узла, равносильного !node.
+ */
+static NodeIndex negateDagNode(ExpressionDag& dag, NodeIndex node, std::unordered_map<NodeIndex, NodeIndex>& memo) {
+    std::vector<std::pair<NodeIndex, bool>> stack = { { node, false } }; // Пара: узел, обработаны ли поддеревья
+
+    while (!stack.empty()) {
+        auto item = stack.back();
+        stack.pop_back();
+
+        NodeIndex current = item.first;
+        if (memo.count(current)) continue;
+
+        TokenType type = dag.type(current);
+        if (type != TokenType::And && type != TokenType::Or) {
+            // !!A → A, остальные узлы получают отрицание
+            bool isNot = type == TokenType::Not && dag.right(current) != nullNode;
+            memo[current] = isNot ? dag.right(current) : dag.makeNode(TokenType::Not, Symbol(), nullNode, current);
+            continue;
+        }
+
+        if (!item.second) {
+            stack.push_back({ current, true });
+            stack.push_back({ dag.right(current), false });
+            stack.push_back({ dag.left(current), false });
+            continue;
+        }
+
+        // !(A & B) → !A | !B, !(A | B) → !A & !B
+        TokenType dual = type == TokenType::And ? TokenType::Or : TokenType::And;
+        memo[current] = dag.makeNode(dual, Symbol(), memo[dag.left(current)], memo[dag.right(current)]);
+    }
+
+    return memo[node];
+}
+
+/**
+ * @brief Применяет законы де Моргана к графу.
+ *
+ * В отличие от simplifyExpression для узлов ExpressionNode, переносит каждое отрицание сразу до переменных,
+ * поэтому следующий вызов уже не вносит изменений. Пошаговый перенос в графе неприменим: общее подвыражение
+ * оказывается под отрицаниями, перенесенными на разную глубину, и каждый такой вариант становится отдельным
+ * узлом. Промежуточные двойные отрицания при переносе сокращаются; результат после removeDoubleNot совпадает
+ * с результатом для дерева из узлов.
+ * @param [in,out] dag Граф выражения.
+ * @param [in] root Индекс корня.
+ * @param [in,out] changed Устанавливается в true, если были внесены изменения.
+ * @return Индекс корня преобразованного выражения.
+ */
+NodeIndex simplifyExpression(ExpressionDag& dag, NodeIndex root, bool& changed) {
+    std::unordered_map<NodeIndex, NodeIndex> negations; // Отрицания, общие для всего прохода
+
+    return rewriteDag(dag, root, [&dag, &changed, &negations](NodeIndex node, NodeIndex left, NodeIndex right) {
+        TokenType type = dag.type(node);
+
+        if (type == TokenType::Not && right != nullNode) {
+            TokenType operandType = dag.type(right);
+            if (operandType == TokenType::And || operandType == TokenType::Or) {
+                changed = true;
+                return negateDagNode(dag, right, negations);
+            }
+        }
+
+        return dag.makeNode(type, dag.value(node), left, right);
+    });
+}
+
+/**
+ * @brief Удаляет двойные отрицания в графе.
+ *
+ * Преобразует выражения вида !!A в A.
+ * @param [in,out] dag Граф выражения.
+ * @param [in] root Индекс корня.
+ * @return Индекс корня преобразованного выражения.
+ */
+NodeIndex removeDoubleNot(ExpressionDag& dag, NodeIndex root) {
+    return rewriteDag(dag, root, [&dag](NodeIndex node, NodeIndex left, NodeIndex right) {
+        TokenType type = dag.type(node);
+
+        if (type == TokenType::Not && right != nullNode && dag.type(right) == TokenType::Not && dag.right(right) != nullNode) {
+            return dag.right(right);
+        }
+
+        return dag.makeNode(type, dag.value(node), left, right);
+    });
+}
+
+/**
+ * @brief Строит выражение с отрицаниями на ребрах из вектора токенов.
+ *
+ * Работает так же, как buildExpressionTree для узлов ExpressionNode, и сообщает о тех же ошибках.
+ * Отрицание не создает узла, а инвертирует бит ребра к операнду.
+ * @param [in] tokens Вектор токенов в постфиксной записи.
+ * @param [in,out] errorList Множество для хранения обнаруженных ошибок.
+ * @param [in,out] graph Выражение, в которое добавляются узлы.
+ * @return Ребро к корню построенного выражения или nullEdge при ошибке.
+ */
+Edge buildExpressionTree(const std::vector<Token>& tokens, std::set<Error>& errorList, EdgeExpression& graph) {
+    std::vector<Edge> stack;
+    int lastOperandPosition = 0; // Для отслеживания позиции последнего операнда
+
+    graph.reserve(graph.size() + tokens.size());
+
+    for (const auto& token : tokens) {
+        if (token.type == TokenType::Variable) {
+            stack.push_back(graph.addNode(token.type, token.value));
+            lastOperandPosition = token.position;
+            continue;
+        }
+
+        if (token.type == TokenType::Not) {
+            if (stack.empty()) {
+                errorList.insert(Error(Error::ErrorType::insufficientOperands, token.position));
+                continue;
+            }
+
+            stack.back() = EdgeExpression::negate(stack.back());
+            continue;
+        }
+
+        // Бинарные операции
+        if (stack.size() < 2) {
+            errorList.insert(Error(Error::ErrorType::insufficientOperands, token.position));
+            continue;
+        }
+
+        Edge right = stack.back();
+        stack.pop_back();
+        Edge left = stack.back();
+        stack.back() = graph.addNode(token.type, Symbol(), left, right);
+    }
+
+    if (stack.size() != 1) {
+        int errorPosition = lastOperandPosition;
+        if (stack.empty()) {
+            errorPosition = tokens.empty() ? 0 : tokens.back().position;
+        }
+        errorList.insert(Error(Error::ErrorType::missingOperation, errorPosition));
+        return nullEdge;
+    }
+
+    return stack.back();
+}
+
+/**
+ * @brief Преобразует операции импликации и эквивалентности в выражении с отрицаниями на ребрах.
+ *
+ * Узлы не зависят друг от друга, поэтому обрабатываются одним проходом по массивам в порядке индексов.
+ * Импликация (A > B) заменяется на (!A | B) инверсией бита ребра, эквивалентность (A ~ B) — на
+ * ((A & B) | (!A & !B)) с двумя новыми узлами, ссылающимися на те же операнды без копирования.
+ * @param [in,out] graph Выражение с отрицаниями на ребрах.
+ */
+void transformImplicationAndEquivalence(EdgeExpression& graph) {
+    size_t count = graph.size();
+    for (size_t i = 0; i < count; i++) {
+        TokenType type = graph.type(static_cast<NodeIndex>(i));
+
+        if (type == TokenType::Implication) {
+            graph.types[i] = static_cast<uint8_t>(TokenType::Or);
+            graph.lefts[i] = EdgeExpression::negate(graph.lefts[i]);
+        }
+        else if (type == TokenType::Equivalence) {
+            Edge left = graph.lefts[i];
+            Edge right = graph.rights[i];
+            Edge both = graph.addNode(TokenType::And, Symbol(), left, right);
+            Edge neither = graph.addNode(TokenType::And, Symbol(), EdgeExpression::negate(left), EdgeExpression::negate(right));
+
+            graph.types[i] = static_cast<uint8_t>(TokenType::Or);
+            graph.lefts[i] = both;
+            graph.rights[i] = neither;
+        }
+    }
+}
+
+/**
+ * @brief Преобразует выражение с отрицаниями на ребрах в инфиксную строку.
+ *
+ * Выражение читается через EdgeTreeView в отрицательной нормальной форме.
+ * @param [in] graph Выражение с отрицаниями на ребрах.
+ * @param [in] root Ребро к корню.
+ * @return Строковое представление выражения в инфиксной форме.
+ */
+std::string expressionTreeToInfix(const EdgeExpression& graph, Edge root) {
+    std::string out;
+    appendInfix(EdgeTreeView{ graph }, root, out);
+    return out;
+}
+
+/**
+ * @brief Строит отрицательную нормальную форму дерева за один проход.
+ *
+ * Обходит дерево сверху вниз, передавая поддеревьям полярность — признак того, что над ними стоит
+ * нечетное число отрицаний. Отрицания не копируются, а меняют полярность; конъюнкция и дизъюнкция
+ * под отрицательной полярностью заменяются двойственной операцией; отрицание ставится только перед
+ * переменной. Результат совпадает с результатом повторных вызовов simplifyExpression и последующего
+ * removeDoubleNot. Импликация и эквивалентность, если они не были раскрыты, остаются под отрицанием как есть.
+ * @param [in] node Указатель на корень дерева после transformImplicationAndEquivalence.
+ * @return Указатель на корень нового дерева; исходное дерево не изменяется.
+ */
+ExpressionNode* negationNormalForm(const ExpressionNode* node) {
+    // Элемент стека: исходный узел, полярность и поле, в которое записывается результат
+    struct Item {
+        const ExpressionNode* node;
+        bool negated;
+        ExpressionNode** slot;
+    };
+
+    ExpressionNode* result = nullptr;
+    std::vector<Item> stack = { { node, false, &result } };
+
+    while (!stack.empty()) {
+        Item item = stack.back();
+        stack.pop_back();
+
+        const ExpressionNode* current = item.node;
+        bool negated = item.negated;
+
+        // Цепочка отрицаний только меняет полярность
+        while (current && current->type == TokenType::Not && current->right) {
+            current = current->right;
+            negated = !negated;
+        }
+        if (!current) continue;
+
+        if (current->type == TokenType::And || current->type == TokenType::Or) {
+            TokenType type = current->type;
+            if (negated) type = type == TokenType::And ? TokenType::Or : TokenType::And;
+
+            ExpressionNode* copy = new ExpressionNode(type, nullptr, nullptr);
+            *item.slot = copy;
+            stack.push_back({ current->right, negated, &copy->right });
+            stack.push_back({ current->left, negated, &copy->left });
+            continue;
+        }
+
+        ExpressionNode* copy = new ExpressionNode(current->type, current->value);
+        *item.slot = negated ? new ExpressionNode(TokenType::Not, nullptr, copy) : copy;
+
+        // Поддеревья прочих операций обрабатываются с положительной полярностью
+        if (current->right) stack.push_back({ current->right, false, &copy->right });
+        if (current->left) stack.push_back({ current->left, false, &copy->left });
+    }
+
+    return result;
+}
+
+/**
+ * @brief Строит отрицательную нормальную форму плоского дерева за один проход.
+ *
+ * Работает так же, как negationNormalForm для узлов ExpressionNode. Узлы результата добавляются в конец
+ * массивов того же дерева, исходные узлы не изменяются.
+ * @param [in,out] tree Плоское дерево после transformImplicationAndEquivalence.
+ * @param [in] root Индекс корня.
+ * @return Индекс корня результата.
+ */
+NodeIndex negationNormalForm(FlatExpression& tree, NodeIndex root) {
+    struct Item {
+        NodeIndex source;
+        bool negated;
+        NodeIndex parent;
+        bool isLeft;
+    };
+
+    NodeIndex result = nullNode;
+    std::vector<Item> stack = { { root, false, nullNode, false } };
+
+    while (!stack.empty()) {
+        Item item = stack.back();
+        stack.pop_back();
+
+        NodeIndex current = item.source;
+        bool negated = item.negated;
+
+        // Цепочка отрицаний только меняет полярность
+        while (current != nullNode && tree.type(current) == TokenType::Not && tree.rights[current] != nullNode) {
+            current = tree.rights[current];
+            negated = !negated;
+        }
+        if (current == nullNode) continue;
+
+        // Поля читаются до добавления узлов: массивы могут быть перераспределены
+        TokenType type = tree.type(current);
+        NodeIndex left = tree.lefts[current];
+        NodeIndex right = tree.rights[current];
+        Symbol value;
+        value.id = tree.symbols[current];
+
+        bool isBinary = type == TokenType::And || type == TokenType::Or;
+        if (isBinary && negated) type = type == TokenType::And ? TokenType::Or : TokenType::And;
+
+        NodeIndex copy = tree.addNode(type, value);
+        NodeIndex node = copy;
+        if (!isBinary && negated) {
+            node = tree.addNode(TokenType::Not, Symbol(), nullNode, copy);
+        }
+
+        if (item.parent == nullNode) result = node;
+        else if (item.isLeft) tree.lefts[item.parent] = node;
+        else tree.rights[item.parent] = node;
+
+        // Поддеревья прочих операций обрабатываются с положительной полярностью
+        bool childNegated = isBinary && negated;
+        if (right != nullNode) stack.push_back({ right, childNegated, copy, false });
+        if (left != nullNode) stack.push_back({ left, childNegated, copy, true });
+    }
+
+    return result;
+}
+
+/**
+ * @brief Выполняет все преобразования выражения за один проход по исходному дереву.
+ *
+ * Обходит дерево сверху вниз с учетом полярности, как negationNormalForm, и одновременно раскрывает
+ * импликацию и эквивалентность:
+ * A > B дает !A | B, а под отрицанием A & !B;
+ * A ~ B дает (A & B) | (!A & !B), а под отрицанием (!A | !B) & (A | B).
+ * Результат совпадает с результатом transformImplicationAndEquivalence, повторных вызовов simplifyExpression
+ * и removeDoubleNot. Операнды эквивалентности обходятся дважды, по разу для каждой полярности.
+ * @param [in] node Указатель на корень исходного дерева.
+ * @return Указатель на корень нового дерева; исходное дерево не изменяется.
+ */
+ExpressionNode* fusedNormalForm(const ExpressionNode* node) {
+    // Элемент стека: исходный узел, полярность и поле, в которое записывается результат
+    struct Item {
+        const ExpressionNode* node;
+        bool negated;
+        ExpressionNode** slot;
+    };
+
+    ExpressionNode* result = nullptr;
+    std::vector<Item> stack = { { node, false, &result } };
+
+    while (!stack.empty()) {
+        Item item = stack.back();
+        stack.pop_back();
+
+        const ExpressionNode* current = item.node;
+        bool negated = item.negated;
+
+        // Цепочка отрицаний только меняет полярность
+        while (current && current->type == TokenType::Not && current->right) {
+            current = current->right;
+            negated = !negated;
+        }
+        if (!current) continue;
+
+        switch (current->type) {
+        case TokenType::And:
+        case TokenType::Or: {
+            TokenType type = current->type;
+            if (negated) type = type == TokenType::And ? TokenType::Or : TokenType::And;
+
+            ExpressionNode* copy = new ExpressionNode(type, nullptr, nullptr);
+            *item.slot = copy;
+            stack.push_back({ current->right, negated, &copy->right });
+            stack.push_back({ current->left, negated, &copy->left });
+            break;
+        }
+        case TokenType::Implication: {
+            // A > B → !A | B, !(A > B) → A & !B
+            ExpressionNode* copy = new ExpressionNode(negated ? TokenType::And : TokenType::Or, nullptr, nullptr);
+            *item.slot = copy;
+            stack.push_back({ current->right, negated, &copy->right });
+            stack.push_back({ current->left, !negated, &copy->left });
+            break;
+        }
+        case TokenType::Equivalence: {
+            // A ~ B → (A & B) | (!A & !B), !(A ~ B) → (!A | !B) & (A | B)
+            TokenType inner = negated ? TokenType::Or : TokenType::And;
+            ExpressionNode* first = new ExpressionNode(inner, nullptr, nullptr);
+            ExpressionNode* second = new ExpressionNode(inner, nullptr, nullptr);
+            *item.slot = new ExpressionNode(negated ? TokenType::And : TokenType::Or, first, second);
+
+            stack.push_back({ current->right, !negated, &second->right });
+            stack.push_back({ current->left, !negated, &second->left });
+            stack.push_back({ current->right, negated, &first->right });
+            stack.push_back({ current->left, negated, &first->left });
+            break;
+        }
+        default: {
+            ExpressionNode* copy = new ExpressionNode(current->type, current->value);
+            *item.slot = negated ? new ExpressionNode(TokenType::Not, nullptr, copy) : copy;
+
+            if (current->right) stack.push_back({ current->right, false, &copy->right });
+            if (current->left) stack.push_back({ current->left, false, &copy->left });
+            break;
+        }
+        }
+    }
+
+    return result;
+}
+
+/**
+ * @brief Выполняет все преобразования плоского дерева за один проход.
+ *
+ * Работает так же, как fusedNormalForm для узлов ExpressionNode. Узлы результата добавляются в конец
+ * массивов того же дерева, исходные узлы не изменяются.
+ * @param [in,out] tree Плоское дерево.
+ * @param [in] root Индекс корня исходного выражения.
+ * @return Индекс корня результата.
+ */
+NodeIndex fusedNormalForm(FlatExpression& tree, NodeIndex root) {
+    struct Item {
+        NodeIndex source;
+        bool negated;
+        NodeIndex parent;
+        bool isLeft;
+    };
+
+    NodeIndex result = nullNode;
+    std::vector<Item> stack = { { root, false, nullNode, false } };
+
+    while (!stack.empty()) {
+        Item item = stack.back();
+        stack.pop_back();
+
+        NodeIndex current = item.source;
+        bool negated = item.negated;
 
-        // Проверка на операцию
-        auto it = stringToTokenType.find(tokenStr);
-        if (it != stringToTokenType.end()) {
-            tokens.emplace_back(it->second, tokenStr, position);
-            continue;
+        // Цепочка отрицаний только меняет полярность
+        while (current != nullNode && tree.type(current) == TokenType::Not && tree.rights[current] != nullNode) {
+            current = tree.rights[current];
+            negated = !negated;
         }
+        if (current == nullNode) continue;
 
-        // Проверка на переменную
-        if (isalpha(tokenStr[0])) {
-            bool valid = std::all_of(tokenStr.begin(), tokenStr.end(), [](char c) {
-                return isalnum(c);
-                });
+        // Поля читаются до добавления узлов: массивы могут быть перераспределены
+        TokenType type = tree.type(current);
+        NodeIndex left = tree.lefts[current];
+        NodeIndex right = tree.rights[current];
+        Symbol value;
+        value.id = tree.symbols[current];
 
-            if (!valid) {
-                errorList.insert(Error(Error::ErrorType::invalidVariableChar, position));
-                continue;
-            }
+        NodeIndex node = nullNode;
+        switch (type) {
+        case TokenType::And:
+        case TokenType::Or: {
+            if (negated) type = type == TokenType::And ? TokenType::Or : TokenType::And;
+            node = tree.addNode(type);
+            stack.push_back({ right, negated, node, false });
+            stack.push_back({ left, negated, node, true });
+            break;
+        }
+        case TokenType::Implication: {
+            // A > B → !A | B, !(A > B) → A & !B
+            node = tree.addNode(negated ? TokenType::And : TokenType::Or);
+            stack.push_back({ right, negated, node, false });
+            stack.push_back({ left, !negated, node, true });
+            break;
+        }
+        case TokenType::Equivalence: {
+            // A ~ B → (A & B) | (!A & !B), !(A ~ B) → (!A | !B) & (A | B)
+            TokenType inner = negated ? TokenType::Or : TokenType::And;
+            NodeIndex first = tree.addNode(inner);
+            NodeIndex second = tree.addNode(inner);
+            node = tree.addNode(negated ? TokenType::And : TokenType::Or, Symbol(), first, second);
 
-            tokens.emplace_back(TokenType::Variable, tokenStr, position);
-            continue;
+            stack.push_back({ right, !negated, second, false });
+            stack.push_back({ left, !negated, second, true });
+            stack.push_back({ right, negated, first, false });
+            stack.push_back({ left, negated, first, true });
+            break;
         }
+        default: {
+            NodeIndex copy = tree.addNode(type, value);
+            node = negated ? tree.addNode(TokenType::Not, Symbol(), nullNode, copy) : copy;
 
-        // Проверка на начало с цифры
-        if (isdigit(tokenStr[0])) {
-            errorList.insert(Error(Error::ErrorType::invalidVariableName, position));
-            continue;
+            if (right != nullNode) stack.push_back({ right, false, copy, false });
+            if (left != nullNode) stack.push_back({ left, false, copy, true });
+            break;
+        }
         }
 
-        // Все остальные случаи — неподдерживаемая операция
-        errorList.insert(Error(Error::ErrorType::unsupportedOperation, position));
+        if (item.parent == nullNode) result = node;
+        else if (item.isLeft) tree.lefts[item.parent] = node;
+        else tree.rights[item.parent] = node;
     }
 
-    // Проверка на отсутствие токенов
-    if (tokens.empty() && errorList.empty()) {
-        errorList.insert(Error(Error::ErrorType::emptyFile));
-    }
+    return result;
+}
 
-    return tokens;
+/**
+ * @brief Конструктор: создает узлы констант и пустой кэш.
+ */
+BddManager::BddManager() : freeList(nullBdd), liveNodes(0), collectThreshold(initialCollectThreshold),
+    reorderThreshold(initialReorderThreshold), autoReorder(true), reorderings(0), nodeLimit(SIZE_MAX) {
+    for (int i = 0; i < 2; i++) {
+        vars.push_back(terminalVariable);
+        lows.push_back(nullBdd);
+        highs.push_back(nullBdd);
+        nexts.push_back(nullBdd);
+        refs.push_back(0);
+    }
+    cache.assign(initialCacheSize, CacheEntry{ nullBdd, nullBdd, nullBdd, nullBdd });
 }
 
 /**
- * @brief Строит дерево выражения из вектора токенов.
- *
- * Создает бинарное дерево логического выражения на основе токенов в постфиксной записи.
- * При обнаружении ошибок (например, недостаток операндов) добавляет их в errorList.
- * @param [in] tokens Вектор токенов в постфиксной записи.
- * @param [in,out] errorList Множество для хранения обнаруженных ошибок.
- * @return Указатель на корень построенного дерева или nullptr при ошибке.
+ * @brief Возвращает номер переменной с заданным именем, добавляя ее на нижний уровень при отсутствии.
+ * @param name Имя переменной.
+ * @return Номер переменной.
  */
-ExpressionNode* buildExpressionTree(const std::vector<Token>& tokens, std::set<Error>& errorList) {
-    std::vector<ExpressionNode*> stack;
-    int lastOperandPosition = 0; // Для отслеживания позиции последнего операнда
+uint32_t BddManager::variableIndex(Symbol name) {
+    auto found = indexOfSymbol.find(name.id);
+    if (found != indexOfSymbol.end()) return found->second;
 
-    for (const auto& token : tokens) {
-        if (token.type == TokenType::Variable) {
-            stack.push_back(new ExpressionNode(token.type, token.value));
-            lastOperandPosition = token.position; // Обновляем позицию последнего операнда
-            continue;
-        }
+    uint32_t index = static_cast<uint32_t>(names.size());
+    names.push_back(name);
+    levels.push_back(index);
+    order.push_back(index);
+    subtables.emplace_back();
+    subtables.back().buckets.assign(initialSubtableSize, nullBdd);
+    indexOfSymbol.emplace(name.id, index);
+    return index;
+}
 
-        if (token.type == TokenType::Not) {
-            if (stack.empty()) {
-                errorList.insert(Error(Error::ErrorType::insufficientOperands, token.position));
-                continue;
-            }
+/**
+ * @brief Применяет бинарную логическую операцию.
+ * @param type Операция: And, Or, Implication или Equivalence.
+ * @param f Левый операнд.
+ * @param g Правый операнд.
+ * @return Ссылка на узел результата (не защищена от сборки мусора) или nullBdd для прочих типов.
+ * @throw Error с типом bddNodeLimit, если число узлов превысило предел setNodeLimit.
+ */
+BddRef BddManager::apply(TokenType type, BddRef f, BddRef g) {
+    maybeCollect(f, g, nullBdd);
+    switch (type) {
+    case TokenType::And: return iteStep(f, g, bddFalse);
+    case TokenType::Or: return iteStep(f, bddTrue, g);
+    case TokenType::Implication: return iteStep(f, g, bddTrue);
+    case TokenType::Equivalence: return iteStep(f, g, iteStep(g, bddFalse, bddTrue));
+    default: return nullBdd;
+    }
+}
 
-            ExpressionNode* operand = stack.back();
+/**
+ * @brief Возвращает количество узлов диаграммы, не считая констант.
+ * @param f Ссылка на корень.
+ * @return Количество узлов, достижимых из f.
+ */
+size_t BddManager::size(BddRef f) const {
+    std::vector<BddRef> stack = { f };
+    std::unordered_set<BddRef> visited;
+    while (!stack.empty()) {
+        BddRef node = stack.back();
+        stack.pop_back();
+        if (isConstant(node) || !visited.insert(node).second) continue;
+        stack.push_back(lows[node]);
+        stack.push_back(highs[node]);
+    }
+    return visited.size();
+}
+
+/**
+ * @brief Считает наборы значений всех переменных менеджера, на которых функция истинна.
+ *
+ * Для каждого узла вычисляется доля выполняющих наборов, равная полусумме долей ветвей, поэтому
+ * результат не зависит от порядка переменных. Время линейно по размеру диаграммы.
+ * @param f Ссылка на корень.
+ * @return Количество выполняющих наборов (2 в степени variableCount() для тождественной истины).
+ */
+double BddManager::satCount(BddRef f) const {
+    std::unordered_map<BddRef, double> density = { { bddFalse, 0.0 }, { bddTrue, 1.0 } };
+    std::vector<BddRef> stack = { f };
+    while (!stack.empty()) {
+        BddRef node = stack.back();
+        if (density.count(node)) {
             stack.pop_back();
-            stack.push_back(new ExpressionNode(token.type, nullptr, operand));
             continue;
         }
-
-        // Бинарные операции
-        if (stack.size() < 2) {
-            errorList.insert(Error(Error::ErrorType::insufficientOperands, token.position));
-            continue;
+        auto lowDensity = density.find(lows[node]);
+        auto highDensity = density.find(highs[node]);
+        if (lowDensity == density.end()) stack.push_back(lows[node]);
+        if (highDensity == density.end()) stack.push_back(highs[node]);
+        if (lowDensity != density.end() && highDensity != density.end()) {
+            density.emplace(node, (lowDensity->second + highDensity->second) / 2);
+            stack.pop_back();
         }
+    }
+    return std::ldexp(density[f], static_cast<int>(names.size()));
+}
 
-        ExpressionNode* right = stack.back();
-        stack.pop_back();
-        ExpressionNode* left = stack.back();
-        stack.pop_back();
-        stack.push_back(new ExpressionNode(token.type, left, right));
+/**
+ * @brief Удаляет узлы, на которые нет ссылок, и очищает кэш операций.
+ */
+void BddManager::collectGarbage() {
+    std::vector<BddRef> dead;
+    for (BddRef node = 2; node < vars.size(); node++) {
+        if (vars[node] != freeVariable && refs[node] == 0) dead.push_back(node);
     }
+    if (dead.empty()) return;
 
-    if (stack.size() != 1) {
-        // Если стек содержит больше одного элемента, указываем позицию после последнего операнда
-        int errorPosition = lastOperandPosition;
-        if (stack.empty()) {
-            errorPosition = tokens.empty() ? 0 : tokens.back().position;
+    // Удаление узла уменьшает счетчики его ветвей, которые тоже могут стать мертвыми
+    std::vector<uint8_t> dirty(subtables.size(), 0);
+    for (size_t i = 0; i < dead.size(); i++) {
+        BddRef node = dead[i];
+        dirty[vars[node]] = 1;
+        subtables[vars[node]].count--;
+        vars[node] = freeVariable;
+        for (BddRef child : { lows[node], highs[node] }) {
+            if (!isConstant(child) && --refs[child] == 0) dead.push_back(child);
         }
-        errorList.insert(Error(Error::ErrorType::missingOperation, errorPosition));
-        return nullptr;
     }
 
-    return stack.back();
+    // Цепочки перестраиваются до того, как поле next мертвых узлов займет список свободных узлов
+    for (uint32_t var = 0; var < subtables.size(); var++) {
+        if (!dirty[var]) continue;
+        for (BddRef& head : subtables[var].buckets) {
+            BddRef* link = &head;
+            for (BddRef node = head; node != nullBdd; node = nexts[node]) {
+                if (vars[node] == freeVariable) continue;
+                *link = node;
+                link = &nexts[node];
+            }
+            *link = nullBdd;
+        }
+    }
+    for (BddRef node : dead) {
+        nexts[node] = freeList;
+        freeList = node;
+    }
+    liveNodes -= dead.size();
+    std::fill(cache.begin(), cache.end(), CacheEntry{ nullBdd, nullBdd, nullBdd, nullBdd });
 }
 
 /**
- * @brief Создает глубокую копию узла дерева.
+ * @brief Меняет порядок переменных просеиванием.
  *
- * Рекурсивно копирует узел и все его поддеревья, создавая независимую копию.
- * @param [in] node Указатель на узел для копирования.
- * @return Указатель на новый узел или nullptr, если входной узел равен nullptr.
+ * Сначала собирает мусор, затем просеивает переменные в порядке убывания числа их узлов. Переменная идет
+ * сначала к ближнему краю, затем к дальнему; движение в одну сторону прекращается, когда число узлов
+ * превысило лучшее в maxSiftGrowth раз. Незащищенные узлы при этом удаляются.
  */
-ExpressionNode* copyNode(ExpressionNode* node) {
-    if (!node) return nullptr;
+void BddManager::reorder() {
+    collectGarbage();
 
-    return new ExpressionNode(
-        node->type,
-        node->value,
-        copyNode(node->left),
-        copyNode(node->right)
-    );
+    std::vector<uint32_t> candidates(order.size());
+    for (uint32_t var = 0; var < candidates.size(); var++) candidates[var] = var;
+    std::stable_sort(candidates.begin(), candidates.end(), [this](uint32_t a, uint32_t b) {
+        return subtables[a].count > subtables[b].count;
+    });
+    for (uint32_t var : candidates) siftVariable(var);
+
+    std::fill(cache.begin(), cache.end(), CacheEntry{ nullBdd, nullBdd, nullBdd, nullBdd });
+    reorderings++;
+    reorderThreshold = std::max(initialReorderThreshold, liveNodes * 2);
 }
 
 /**
- * @brief Преобразует операции импликации и эквивалентности.
- *
- * Преобразует импликацию (A > B) в (!A | B) и эквивалентность (A ~ B) в ((A & B) | (!A & !B)).
- * Рекурсивно обрабатывает все узлы дерева.
- * @param [in,out] node Указатель на корень дерева для преобразования.
+ * @brief Возвращает узел с заданными переменной и ветвями, создавая его при отсутствии.
+ * @param var Номер переменной.
+ * @param lowBranch Ветвь при ложной переменной.
+ * @param highBranch Ветвь при истинной переменной.
+ * @return Ссылка на единственный такой узел или на ветвь, если ветви совпадают.
  */
-void transformImplicationAndEquivalence(ExpressionNode* node) {
-    if (!node) return;
+BddRef BddManager::makeNode(uint32_t var, BddRef lowBranch, BddRef highBranch) {
+    if (lowBranch == highBranch) return lowBranch;
 
-    // Рекурсивно преобразуем поддеревья
-    transformImplicationAndEquivalence(node->left);
-    transformImplicationAndEquivalence(node->right);
+    Subtable& table = subtables[var];
+    size_t bucket = hashPair(lowBranch, highBranch) & (table.buckets.size() - 1);
+    for (BddRef node = table.buckets[bucket]; node != nullBdd; node = nexts[node]) {
+        if (lows[node] == lowBranch && highs[node] == highBranch) return node;
+    }
 
-    // Преобразование импликации A > B в !A | B
-    if (node->type == TokenType::Implication) {
-        ExpressionNode* newNot = new ExpressionNode(TokenType::Not, nullptr, copyNode(node->left));
-        node->type = TokenType::Or;
-        node->left = newNot; // node->right остается без изменений
-        return;
+    BddRef node;
+    if (freeList != nullBdd) {
+        node = freeList;
+        freeList = nexts[node];
+    }
+    else {
+        node = static_cast<BddRef>(vars.size());
+        vars.push_back(0);
+        lows.push_back(nullBdd);
+        highs.push_back(nullBdd);
+        nexts.push_back(nullBdd);
+        refs.push_back(0);
     }
+    vars[node] = var;
+    lows[node] = lowBranch;
+    highs[node] = highBranch;
+    refs[node] = 0;
+    refs[lowBranch]++;
+    refs[highBranch]++;
+    liveNodes++;
+    insertNode(node);
+    return node;
+}
 
-    // Преобразование эквивалентности A ~ B в (A & B) | (!A & !B)
-    if (node->type == TokenType::Equivalence) {
-        // Создаем левый узел конъюнкции (A & B)
-        ExpressionNode* newLeft = new ExpressionNode(TokenType::And, copyNode(node->left), copyNode(node->right));
+/**
+ * @brief Добавляет узел в таблицу уникальных узлов его переменной.
+ * @param node Ссылка на узел, которого нет в таблице.
+ */
+void BddManager::insertNode(BddRef node) {
+    Subtable& table = subtables[vars[node]];
+    size_t bucket = hashPair(lows[node], highs[node]) & (table.buckets.size() - 1);
+    nexts[node] = table.buckets[bucket];
+    table.buckets[bucket] = node;
+    table.count++;
+    if (table.count > table.buckets.size() * 2) rehash(table);
+}
 
-        // Создаем правый узел конъюнкции (!A & !B)
-        ExpressionNode* newRightL = new ExpressionNode(TokenType::Not, nullptr, copyNode(node->left));
-        ExpressionNode* newRightR = new ExpressionNode(TokenType::Not, nullptr, copyNode(node->right));
-        ExpressionNode* newRight = new ExpressionNode(TokenType::And, newRightL, newRightR);
+/**
+ * @brief Удаляет узел из таблицы уникальных узлов его переменной.
+ * @param node Ссылка на узел из таблицы.
+ */
+void BddManager::unlinkNode(BddRef node) {
+    Subtable& table = subtables[vars[node]];
+    BddRef* link = &table.buckets[hashPair(lows[node], highs[node]) & (table.buckets.size() - 1)];
+    while (*link != node) link = &nexts[*link];
+    *link = nexts[node];
+    table.count--;
+}
 
-        // Обновляем текущий узел
-        node->type = TokenType::Or;
-        node->left = newLeft;
-        node->right = newRight;
+/**
+ * @brief Снимает ссылку родителя и удаляет узлы, на которые не осталось ссылок.
+ * @param node Ссылка на ветвь.
+ */
+void BddManager::releaseBranch(BddRef node) {
+    if (isConstant(node) || --refs[node] > 0) return;
+
+    std::vector<BddRef> dead = { node };
+    while (!dead.empty()) {
+        BddRef current = dead.back();
+        dead.pop_back();
+        unlinkNode(current);
+        for (BddRef child : { lows[current], highs[current] }) {
+            if (!isConstant(child) && --refs[child] == 0) dead.push_back(child);
+        }
+        vars[current] = freeVariable;
+        nexts[current] = freeList;
+        freeList = current;
+        liveNodes--;
     }
 }
 
 /**
- * @brief Применяет законы де Моргана.
+ * @brief Меняет местами переменные соседних уровней.
  *
- * Преобразует выражения вида !(A & B) в !A | !B и !(A | B) в !A & !B.
- * Рекурсивно обрабатывает поддеревья.
- * @param [in,out] node Указатель на корень дерева для упрощения.
- * @return true, если были внесены изменения, иначе false.
+ * Узел f = (x, f0, f1), у которого есть ветвь с переменной y следующего уровня, переписывается на месте
+ * в (y, (x, f00, f10), (x, f01, f11)); остальные узлы x только опускаются на уровень. Узлы y, на которые
+ * не осталось ссылок, сразу удаляются, поэтому число живых узлов остается точным.
+ * @param level Верхний из двух уровней.
  */
-bool simplifyExpression(ExpressionNode* node, bool& changed) {
-    if (!node) return false;
+void BddManager::swapLevels(uint32_t level) {
+    uint32_t upper = order[level];
+    uint32_t lower = order[level + 1];
 
-    // Сначала рекурсивно упрощаем поддеревья
-    if (node->left) {
-        changed |= simplifyExpression(node->left, changed);
-    }
-    if (node->right) {
-        changed |= simplifyExpression(node->right, changed);
+    std::vector<BddRef> moved;
+    for (BddRef head : subtables[upper].buckets) {
+        for (BddRef node = head; node != nullBdd; node = nexts[node]) {
+            if (vars[lows[node]] == lower || vars[highs[node]] == lower) moved.push_back(node);
+        }
     }
+    for (BddRef node : moved) unlinkNode(node);
 
-    // Применяем законы де Моргана к текущему узлу
-    if (node->type == TokenType::Not && node->right) {
-        // Первый закон де Моргана: !(A & B) → !A | !B
-        if (node->right->type == TokenType::And) {
-            ExpressionNode* originalAnd = node->right;
-            ExpressionNode* leftOperand = originalAnd->left;
-            ExpressionNode* rightOperand = originalAnd->right;
+    for (BddRef node : moved) {
+        BddRef f0 = lows[node];
+        BddRef f1 = highs[node];
+        BddRef f00 = vars[f0] == lower ? lows[f0] : f0;
+        BddRef f01 = vars[f0] == lower ? highs[f0] : f0;
+        BddRef f10 = vars[f1] == lower ? lows[f1] : f1;
+        BddRef f11 = vars[f1] == lower ? highs[f1] : f1;
 
-            // Создаем новые узлы отрицания
-            ExpressionNode* newNotLeft = new ExpressionNode(TokenType::Not, nullptr, leftOperand);
-            ExpressionNode* newNotRight = new ExpressionNode(TokenType::Not, nullptr, rightOperand);
+        BddRef lowBranch = makeNode(upper, f00, f10);
+        refs[lowBranch]++;
+        BddRef highBranch = makeNode(upper, f01, f11);
+        refs[highBranch]++;
 
-            // Преобразуем текущий узел в дизъюнкцию
-            node->type = TokenType::Or;
-            node->left = newNotLeft;
-            node->right = newNotRight;
+        vars[node] = lower;
+        lows[node] = lowBranch;
+        highs[node] = highBranch;
+        insertNode(node);
 
-            // Удаляем старый узел And (но не его потомков)
-            originalAnd->left = nullptr;
-            originalAnd->right = nullptr;
-            delete originalAnd;
+        // Старые ветви освобождаются после создания новых, которые могут ссылаться на их потомков
+        releaseBranch(f0);
+        releaseBranch(f1);
+    }
 
-            changed = true;
-        }
-        // Второй закон де Моргана: !(A | B) → !A & !B
-        else if (node->right->type == TokenType::Or) {
-            ExpressionNode* originalOr = node->right;
-            ExpressionNode* leftOperand = originalOr->left;
-            ExpressionNode* rightOperand = originalOr->right;
+    order[level] = lower;
+    order[level + 1] = upper;
+    levels[lower] = level;
+    levels[upper] = level + 1;
+}
 
-            ExpressionNode* newNotLeft = new ExpressionNode(TokenType::Not, nullptr, leftOperand);
-            ExpressionNode* newNotRight = new ExpressionNode(TokenType::Not, nullptr, rightOperand);
+/**
+ * @brief Проводит переменную через все уровни и оставляет на уровне с наименьшим числом узлов.
+ * @param var Номер переменной.
+ */
+void BddManager::siftVariable(uint32_t var) {
+    uint32_t last = static_cast<uint32_t>(order.size()) - 1;
+    uint32_t start = levels[var];
+    uint32_t bestLevel = start;
+    size_t best = liveNodes;
 
-            // Преобразуем текущий узел в конъюнкцию
-            node->type = TokenType::And;
-            node->left = newNotLeft;
-            node->right = newNotRight;
+    auto explore = [&](bool down) {
+        while (down ? levels[var] < last : levels[var] > 0) {
+            swapLevels(down ? levels[var] : levels[var] - 1);
+            if (liveNodes < best) {
+                best = liveNodes;
+                bestLevel = levels[var];
+            }
+            else if (liveNodes > best * maxSiftGrowth) break;
+        }
+    };
+    auto moveTo = [&](uint32_t level) {
+        while (levels[var] < level) swapLevels(levels[var]);
+        while (levels[var] > level) swapLevels(levels[var] - 1);
+    };
 
-            originalOr->left = nullptr;
-            originalOr->right = nullptr;
-            delete originalOr;
+    // Сначала к ближнему краю; на обратном пути до start размеры уже известны
+    bool downFirst = start * 2 >= last;
+    explore(downFirst);
+    moveTo(start);
+    explore(!downFirst);
+    moveTo(bestLevel);
+}
 
-            changed = true;
+/**
+ * @brief Удваивает число цепочек таблицы переменной.
+ * @param table Таблица уникальных узлов.
+ */
+void BddManager::rehash(Subtable& table) {
+    std::vector<BddRef> buckets(table.buckets.size() * 2, nullBdd);
+    for (BddRef head : table.buckets) {
+        for (BddRef node = head; node != nullBdd;) {
+            BddRef next = nexts[node];
+            size_t bucket = hashPair(lows[node], highs[node]) & (buckets.size() - 1);
+            nexts[node] = buckets[bucket];
+            buckets[bucket] = node;
+            node = next;
         }
     }
+    table.buckets.swap(buckets);
+}
 
-    return changed;
+/**
+ * @brief Вычисляет ite без сборки мусора.
+ *
+ * Глубина рекурсии не превышает числа переменных.
+ * @param f Условие.
+ * @param g Значение при истинном условии.
+ * @param h Значение при ложном условии.
+ * @return Ссылка на узел результата.
+ * @throw Error с типом bddNodeLimit, если число узлов превысило предел setNodeLimit.
+ */
+BddRef BddManager::iteStep(BddRef f, BddRef g, BddRef h) {
+    if (f == bddTrue) return g;
+    if (f == bddFalse) return h;
+    if (g == f) g = bddTrue;
+    if (h == f) h = bddFalse;
+    if (g == h) return g;
+    if (g == bddTrue && h == bddFalse) return f;
+
+    size_t slot = (hashPair(f, g) ^ h * 0xC2B2AE3D27D4EB4Full) & (cache.size() - 1);
+    const CacheEntry& entry = cache[slot];
+    if (entry.f == f && entry.g == g && entry.h == h) return entry.result;
+
+    uint32_t top = std::min(levelOfNode(f), std::min(levelOfNode(g), levelOfNode(h)));
+    uint32_t var = order[top];
+    BddRef highBranch = iteStep(cofactor(f, top, true), cofactor(g, top, true), cofactor(h, top, true));
+    BddRef lowBranch = iteStep(cofactor(f, top, false), cofactor(g, top, false), cofactor(h, top, false));
+    BddRef result = makeNode(var, lowBranch, highBranch);
+    if (liveNodes > nodeLimit) {
+        throw Error(Error::bddNodeLimit, -1, std::to_string(nodeLimit));
+    }
+
+    cache[slot] = { f, g, h, result };
+    return result;
 }
+
 /**
- * @brief Удаляет двойные отрицания.
+ * @brief Собирает мусор или просеивает переменные, если число узлов превысило порог, и увеличивает кэш вслед за числом узлов.
+ * @param f Первый операнд предстоящей операции (или nullBdd).
+ * @param g Второй операнд.
+ * @param h Третий операнд.
+ */
+void BddManager::maybeCollect(BddRef f, BddRef g, BddRef h) {
+    bool reorderNow = autoReorder && order.size() > 1 && liveNodes >= reorderThreshold;
+    if (reorderNow || liveNodes >= collectThreshold) {
+        // Операнды защищаются на время сборки и просеивания
+        BddRef operands[] = { f, g, h };
+        for (BddRef operand : operands) if (operand != nullBdd) ref(operand);
+        if (reorderNow) reorder();
+        else collectGarbage();
+        for (BddRef operand : operands) if (operand != nullBdd) deref(operand);
+
+        // Если освободить удалось меньше половины, порог удваивается
+        if (liveNodes * 2 > collectThreshold) collectThreshold *= 2;
+    }
+    if (cache.size() < liveNodes && cache.size() < maxCacheSize) {
+        cache.assign(cache.size() * 2, CacheEntry{ nullBdd, nullBdd, nullBdd, nullBdd });
+    }
+}
+
+/**
+ * @brief Строит диаграмму двоичных решений по дереву выражения.
  *
- * Преобразует выражения вида !!A в A, рекурсивно обрабатывая поддеревья.
- * @param [in,out] node Указатель на корень дерева для преобразования.
+ * Обходит дерево в обратном порядке с явным стеком. Диаграммы поддеревьев защищаются ref, пока ждут
+ * операцию родителя, поэтому сборка мусора в начале каждой операции их не удаляет. Переменные, которых еще нет
+ * в менеджере, добавляются на нижние уровни в порядке первого вхождения слева направо.
+ * @param [in,out] manager Менеджер диаграмм.
+ * @param [in] root Указатель на корень дерева.
+ * @return Ссылка на корень диаграммы (не защищена от сборки мусора) или nullBdd для пустого дерева.
  */
-void removeDoubleNot(ExpressionNode* node) {
-    if (!node) return;
+BddRef buildBdd(BddManager& manager, const ExpressionNode* root) {
+    if (!root) return nullBdd;
 
-    std::stack<std::pair<ExpressionNode*, bool>> stack; // Пара: узел, обработан ли
-    stack.push({ node, false });
+    // Элемент стека: узел и признак того, что его поддеревья уже обработаны
+    struct Item {
+        const ExpressionNode* node;
+        bool expanded;
+    };
 
+    std::vector<Item> stack = { { root, false } };
+    std::vector<BddRef> results;
     while (!stack.empty()) {
-        ExpressionNode* current = stack.top().first;
-        bool processed = stack.top().second;
-        stack.pop();
+        Item item = stack.back();
+        stack.pop_back();
+        const ExpressionNode* node = item.node;
 
-        if (!current) continue;
+        if (!item.expanded) {
+            stack.push_back({ node, true });
+            if (node->right) stack.push_back({ node->right, false });
+            if (node->left) stack.push_back({ node->left, false });
+            continue;
+        }
 
-        if (!processed) {
-            // Помечаем как обработанный и добавляем поддеревья
-            stack.push({ current, true });
-            if (current->right) stack.push({ current->right, false });
-            if (current->left) stack.push({ current->left, false });
+        BddRef result;
+        if (node->type == TokenType::Variable) {
+            result = manager.variable(node->value);
+        }
+        else if (node->type == TokenType::Not) {
+            BddRef operand = results.back();
+            results.pop_back();
+            result = manager.negate(operand);
+            manager.deref(operand);
         }
         else {
-            // Проверяем и удаляем двойное отрицание
-            if (current->type == TokenType::Not && current->right && current->right->type == TokenType::Not) {
-                ExpressionNode* temp = current->right;
-                if (temp && temp->right) { // Проверяем валидность
-                    ExpressionNode* inner = temp->right;
-                    if (inner) {
-                        current->type = inner->type;
-                        current->value = inner->value;
-                        current->left = inner->left;
-                        current->right = inner->right;
+            BddRef right = results.back();
+            results.pop_back();
+            BddRef left = results.back();
+            results.pop_back();
+            result = manager.apply(node->type, left, right);
+            manager.deref(left);
+            manager.deref(right);
+        }
+        manager.ref(result);
+        results.push_back(result);
+    }
 
-                        inner->left = nullptr;
-                        inner->right = nullptr;
-                        delete temp; // Удаляем только внешний узел
-                    }
-                }
+    manager.deref(results.back());
+    return results.back();
+}
+
+/**
+ * @brief Преобразует диаграмму двоичных решений в дерево выражения по разложению Шеннона.
+ *
+ * Узел с переменной x и ветвями L, H становится выражением x & H | !x & L; ветви-константы сокращаются
+ * (x, !x, x & H, !x & L, x | L, !x | H). Дерево для каждого узла диаграммы строится один раз: первое
+ * вхождение забирает его, последующие получают копию, поэтому размер дерева может расти экспоненциально
+ * относительно размера диаграммы.
+ * @param [in] manager Менеджер диаграмм.
+ * @param [in] f Ссылка на корень диаграммы.
+ * @return Указатель на корень нового дерева. Константы выражаются через переменную верхнего уровня как
+ * (x & !x) и (x || !x); для константы в менеджере без переменных возвращается nullptr.
+ */
+ExpressionNode* bddToExpression(const BddManager& manager, BddRef f) {
+    if (BddManager::isConstant(f)) {
+        if (manager.variableCount() == 0) return nullptr;
+        Symbol name = manager.variableName(manager.variableAt(0));
+        return new ExpressionNode(f == bddTrue ? TokenType::Or : TokenType::And,
+            new ExpressionNode(TokenType::Variable, name),
+            new ExpressionNode(TokenType::Not, nullptr, new ExpressionNode(TokenType::Variable, name)));
+    }
+
+    // Дерево узла диаграммы и признак того, что оно уже вставлено в дерево родителя
+    struct Converted {
+        ExpressionNode* tree;
+        bool taken;
+    };
+    std::unordered_map<BddRef, Converted> memo;
+    auto take = [&memo](BddRef node) {
+        Converted& converted = memo[node];
+        if (converted.taken) return copyNode(converted.tree);
+        converted.taken = true;
+        return converted.tree;
+    };
+
+    std::vector<BddRef> stack = { f };
+    while (!stack.empty()) {
+        BddRef node = stack.back();
+        if (memo.count(node)) {
+            stack.pop_back();
+            continue;
+        }
+
+        BddRef low = manager.low(node);
+        BddRef high = manager.high(node);
+        bool ready = true;
+        for (BddRef child : { low, high }) {
+            if (!BddManager::isConstant(child) && !memo.count(child)) {
+                stack.push_back(child);
+                ready = false;
             }
         }
+        if (!ready) continue;
+        stack.pop_back();
+
+        Symbol name = manager.variableName(manager.variableOf(node));
+        ExpressionNode* positive = new ExpressionNode(TokenType::Variable, name);
+        ExpressionNode* tree;
+        if (low == bddFalse && high == bddTrue) tree = positive;
+        else if (low == bddTrue && high == bddFalse) tree = new ExpressionNode(TokenType::Not, nullptr, positive);
+        else if (low == bddFalse) tree = new ExpressionNode(TokenType::And, positive, take(high));
+        else if (high == bddTrue) tree = new ExpressionNode(TokenType::Or, positive, take(low));
+        else if (high == bddFalse) {
+            tree = new ExpressionNode(TokenType::And, new ExpressionNode(TokenType::Not, nullptr, positive), take(low));
+        }
+        else if (low == bddTrue) {
+            tree = new ExpressionNode(TokenType::Or, new ExpressionNode(TokenType::Not, nullptr, positive), take(high));
+        }
+        else {
+            ExpressionNode* negative = new ExpressionNode(TokenType::Not, nullptr, new ExpressionNode(TokenType::Variable, name));
+            tree = new ExpressionNode(TokenType::Or,
+                new ExpressionNode(TokenType::And, positive, take(high)),
+                new ExpressionNode(TokenType::And, negative, take(low)));
+        }
+        memo.emplace(node, Converted{ tree, false });
     }
+
+    return memo[f].tree;
 }
 
 /**
- * @brief Преобразует дерево выражения в инфиксную строку.
+ * @brief Наибольшее число различных переменных поддерева, при котором оно задает гиперребро в эвристике FORCE.
  *
- * Формирует строковое представление логического выражения в инфиксной нотации,
- * добавляя скобки с учетом приоритетов операций.
- * @param [in] node Указатель на корень дерева.
- * @return Строковое представление выражения в инфиксной форме.
+ * Крупные поддеревья связывают почти все переменные и только размывают центры тяжести.
  */
-std::string expressionTreeToInfix(ExpressionNode* node) {
-    if (!node) return "";
-
-    static const std::map<TokenType, int> priority = {
-        {TokenType::Equivalence, 1},
-        {TokenType::Implication, 2},
-        {TokenType::Or, 3},
-        {TokenType::And, 4},
-        {TokenType::Not, 5}
+constexpr size_t forceEdgeLimit = 8;
+
+/**
+ * @brief Наибольшее число итераций эвристики FORCE.
+ */
+constexpr int forceMaxRounds = 32;
+
+/**
+ * @brief Вычисляет статический порядок переменных для диаграмм двоичных решений по структуре дерева.
+ *
+ * Использует эвристику FORCE: каждая операция, поддерево которой содержит от 2 до forceEdgeLimit различных
+ * переменных, задает гиперребро из этих переменных. На каждой итерации переменная перемещается в среднее центров
+ * тяжести своих гиперребер, после чего позиции заменяются рангами. Итерации продолжаются, пока суммарная длина
+ * гиперребер уменьшается. Начальный порядок — порядок первого вхождения, поэтому переменные, которые стоят
+ * рядом в одной операции, оказываются рядом и тогда, когда первые вхождения их разнесли.
+ * @param [in] root Указатель на корень дерева.
+ * @return Имена переменных в порядке от верхнего уровня к нижнему.
+ */
+std::vector<Symbol> staticVariableOrder(const ExpressionNode* root) {
+    std::vector<Symbol> names;
+    std::unordered_map<uint32_t, uint32_t> indexOfSymbol;
+    std::vector<std::vector<uint32_t>> edges;
+    if (!root) return names;
+
+    // Обратный обход; результат узла — отсортированный набор его переменных или признак переполнения
+    struct Item {
+        const ExpressionNode* node;
+        bool expanded;
+    };
+    struct Support {
+        std::vector<uint32_t> vars;
+        bool overflow;
     };
 
-    std::stringstream ss;
+    std::vector<Item> stack = { { root, false } };
+    std::vector<Support> results;
+    while (!stack.empty()) {
+        Item item = stack.back();
+        stack.pop_back();
+        const ExpressionNode* node = item.node;
 
-    if (node->type == TokenType::Variable) {
-        ss << node->value;
-    }
-    else if (node->type == TokenType::Not) {
-        ss << "!";
-        bool needParens = node->right && node->right->type != TokenType::Variable && node->right->type != TokenType::Not;
-        ss << (needParens ? "(" : "") << expressionTreeToInfix(node->right) << (needParens ? ")" : "");
+        if (!item.expanded) {
+            stack.push_back({ node, true });
+            if (node->right) stack.push_back({ node->right, false });
+            if (node->left) stack.push_back({ node->left, false });
+            continue;
+        }
+
+        if (node->type == TokenType::Variable) {
+            auto inserted = indexOfSymbol.emplace(node->value.id, static_cast<uint32_t>(names.size()));
+            if (inserted.second) names.push_back(node->value);
+            results.push_back({ { inserted.first->second }, false });
+            continue;
+        }
+        if (!node->left || !node->right) continue;
+
+        Support right = std::move(results.back());
+        results.pop_back();
+        Support& left = results.back();
+        if (left.overflow || right.overflow) {
+            left.vars.clear();
+            left.overflow = true;
+            continue;
+        }
+
+        std::vector<uint32_t> merged;
+        std::set_union(left.vars.begin(), left.vars.end(), right.vars.begin(), right.vars.end(), std::back_inserter(merged));
+        if (merged.size() > forceEdgeLimit) {
+            left.vars.clear();
+            left.overflow = true;
+            continue;
+        }
+        if (merged.size() > 1) edges.push_back(merged);
+        left.vars.swap(merged);
     }
-    else {
-        bool needLeftParens = node->left && priority.count(node->left->type) && priority.at(node->left->type) < priority.at(node->type);
-        bool needRightParens = node->right && priority.count(node->right->type) && (priority.at(node->right->type) < priority.at(node->type) ||
-            (priority.at(node->right->type) == priority.at(node->type) && node->type == TokenType::Implication));
 
-        if (needLeftParens) ss << "(";
-        ss << expressionTreeToInfix(node->left);
-        if (needLeftParens) ss << ")";
+    size_t count = names.size();
+    std::vector<double> positions(count);
+    for (size_t var = 0; var < count; var++) positions[var] = static_cast<double>(var);
+
+    // Суммарная длина гиперребер при текущих позициях
+    auto span = [&edges](const std::vector<double>& position) {
+        double total = 0;
+        for (const std::vector<uint32_t>& edge : edges) {
+            auto bounds = std::minmax_element(edge.begin(), edge.end(), [&position](uint32_t a, uint32_t b) {
+                return position[a] < position[b];
+            });
+            total += position[*bounds.second] - position[*bounds.first];
+        }
+        return total;
+    };
 
-        switch (node->type) {
-        case TokenType::And: ss << " & "; break;
-        case TokenType::Or: ss << " || "; break;
-        case TokenType::Implication: ss << " -> "; break;
-        case TokenType::Equivalence: ss << " ~ "; break;
-        default: break;
+    std::vector<double> best = positions;
+    double bestSpan = span(positions);
+    std::vector<double> sums(count);
+    std::vector<uint32_t> degrees(count);
+    std::vector<uint32_t> ranked(count);
+    for (int round = 0; round < forceMaxRounds; round++) {
+        std::fill(sums.begin(), sums.end(), 0.0);
+        std::fill(degrees.begin(), degrees.end(), 0);
+        for (const std::vector<uint32_t>& edge : edges) {
+            double center = 0;
+            for (uint32_t var : edge) center += positions[var];
+            center /= edge.size();
+            for (uint32_t var : edge) {
+                sums[var] += center;
+                degrees[var]++;
+            }
         }
 
-        if (needRightParens) ss << "(";
-        ss << expressionTreeToInfix(node->right);
-        if (needRightParens) ss << ")";
+        // Переменные без гиперребер сохраняют позицию; ничьи разрешаются прежним порядком
+        std::vector<double> targets(count);
+        for (size_t var = 0; var < count; var++) targets[var] = degrees[var] ? sums[var] / degrees[var] : positions[var];
+        for (size_t var = 0; var < count; var++) ranked[var] = static_cast<uint32_t>(var);
+        std::stable_sort(ranked.begin(), ranked.end(), [&](uint32_t a, uint32_t b) {
+            if (targets[a] != targets[b]) return targets[a] < targets[b];
+            return positions[a] < positions[b];
+        });
+        for (size_t rank = 0; rank < count; rank++) positions[ranked[rank]] = static_cast<double>(rank);
+
+        double currentSpan = span(positions);
+        if (currentSpan >= bestSpan) break;
+        bestSpan = currentSpan;
+        best = positions;
     }
 
-    return ss.str();
+    std::vector<Symbol> result(count);
+    for (size_t var = 0; var < count; var++) result[static_cast<size_t>(best[var])] = names[var];
+    return result;
 }
\ No newline at end of file
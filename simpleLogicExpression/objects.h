@@ -5,7 +5,24 @@
 
 // -*- coding: utf-8 -*-
 #include <string>
+#include <string_view>
 #include <iostream>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <new>
+#include <algorithm>
+#include <deque>
+#include <vector>
+#include <unordered_map>
+#include <unordered_set>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <atomic>
+#include <exception>
 #pragma once
 
 /**
@@ -23,78 +40,1550 @@ enum TokenType {
     Any          ///< Специальный тип для неиспользуемых токенов.
 };
 
+/**
+ * @brief Перечисление вариантов ядра поиска разделителей.
+ *
+ * Определяет набор инструкций, которым токенизатор классифицирует входную строку блоками по 64 байта.
+ * Тем же набором инструкций выполняются операции над битовыми векторами таблиц истинности
+ * (scanSse2 — 64-битными словами, как scanScalar).
+ */
+enum ScanKernel {
+    scanScalar, ///< Побайтовая классификация по таблице (доступна всегда).
+    scanSse2,   ///< Классификация по 16 байт инструкциями SSE2.
+    scanAvx2    ///< Классификация по 32 байта инструкциями AVX2.
+};
+
+/**
+ * @brief Класс таблицы символов.
+ *
+ * Хранит каждое имя переменной один раз и сопоставляет ему плотный 32-битный идентификатор.
+ * Идентификатор 0 зарезервирован за пустым именем.
+ * Таблица общая для всех потоков: изменения защищены мьютексом, а каждый поток хранит собственные
+ * копии уже известных ему соответствий, поэтому повторные обращения к имени не требуют блокировки.
+ */
+class SymbolTable {
+public:
+    /**
+     * @brief Возвращает общую таблицу символов программы.
+     * @return Ссылка на таблицу символов.
+     */
+    static SymbolTable& instance() {
+        static SymbolTable table;
+        return table;
+    }
+
+    /**
+     * @brief Возвращает идентификатор имени, добавляя имя в таблицу при первом обращении.
+     * @param name Имя переменной.
+     * @return Идентификатор имени.
+     */
+    uint32_t intern(std::string_view name) {
+        // Ключи кэша указывают на строки общей таблицы, адреса которых не меняются
+        thread_local std::unordered_map<std::string_view, uint32_t> cache;
+
+        auto cached = cache.find(name);
+        if (cached != cache.end()) {
+            return cached->second;
+        }
+
+        std::lock_guard<std::mutex> lock(mutex);
+        uint32_t id;
+        auto it = ids.find(name);
+        if (it != ids.end()) {
+            id = it->second;
+        }
+        else {
+            id = static_cast<uint32_t>(names.size());
+            names.emplace_back(name);
+            ids.emplace(names.back(), id);
+        }
+
+        cache.emplace(names[id], id);
+        return id;
+    }
+
+    /**
+     * @brief Возвращает имя по идентификатору.
+     * @param id Идентификатор имени.
+     * @return Имя переменной.
+     */
+    const std::string& name(uint32_t id) const {
+        thread_local std::vector<const std::string*> cache;
+
+        if (id < cache.size() && cache[id]) {
+            return *cache[id];
+        }
+
+        std::lock_guard<std::mutex> lock(mutex);
+        if (cache.size() < names.size()) {
+            cache.resize(names.size(), nullptr);
+        }
+        cache[id] = &names[id];
+        return names[id];
+    }
+
+    /**
+     * @brief Возвращает количество имен в таблице (включая пустое имя).
+     * @return Количество имен.
+     */
+    size_t size() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return names.size();
+    }
+
+private:
+    std::deque<std::string> names;                      ///< Имена по идентификаторам (адреса строк не меняются).
+    std::unordered_map<std::string_view, uint32_t> ids; ///< Идентификаторы по именам.
+    mutable std::mutex mutex;                           ///< Защита имен и идентификаторов при добавлении.
+
+    /**
+     * @brief Конструктор класса SymbolTable.
+     *
+     * Создает таблицу, содержащую только пустое имя с идентификатором 0.
+     */
+    SymbolTable() {
+        names.emplace_back();
+        ids.emplace(names.back(), 0);
+    }
+};
+
+/**
+ * @brief Класс для представления интернированного имени.
+ *
+ * Хранит только идентификатор имени в таблице символов, поэтому копирование,
+ * сравнение и хеширование выполняются за O(1). Имя восстанавливается только при выводе.
+ */
+class Symbol {
+public:
+    uint32_t id; ///< Идентификатор имени в таблице символов.
+
+    /**
+     * @brief Конструктор пустого имени.
+     */
+    Symbol() : id(0) {}
+
+    /**
+     * @brief Конструктор класса Symbol.
+     *
+     * Интернирует имя в общей таблице символов.
+     * @param name Имя переменной.
+     */
+    Symbol(std::string_view name) : id(SymbolTable::instance().intern(name)) {}
+
+    /**
+     * @brief Конструктор класса Symbol из строки.
+     * @param name Имя переменной.
+     */
+    Symbol(const std::string& name) : Symbol(std::string_view(name)) {}
+
+    /**
+     * @brief Конструктор класса Symbol из строкового литерала.
+     * @param name Имя переменной.
+     */
+    Symbol(const char* name) : Symbol(std::string_view(name)) {}
+
+    /**
+     * @brief Возвращает имя, соответствующее идентификатору.
+     * @return Имя переменной.
+     */
+    const std::string& name() const { return SymbolTable::instance().name(id); }
+
+    /**
+     * @brief Возвращает итератор на начало имени.
+     * @return Итератор на первый символ имени.
+     */
+    std::string::const_iterator begin() const { return name().begin(); }
+
+    /**
+     * @brief Возвращает итератор на конец имени.
+     * @return Итератор за последним символом имени.
+     */
+    std::string::const_iterator end() const { return name().end(); }
+
+    /**
+     * @brief Проверяет, является ли имя пустым.
+     * @return true, если имя пустое.
+     */
+    bool empty() const { return id == 0; }
+
+    /**
+     * @brief Оператор равенства: имена равны, если равны их идентификаторы.
+     * @param other Другое имя.
+     * @return true, если имена совпадают.
+     */
+    bool operator==(const Symbol& other) const { return id == other.id; }
+
+    /**
+     * @brief Оператор неравенства.
+     * @param other Другое имя.
+     * @return true, если имена различаются.
+     */
+    bool operator!=(const Symbol& other) const { return id != other.id; }
+
+    /**
+     * @brief Оператор сравнения по идентификатору (порядок интернирования, а не алфавитный).
+     * @param other Другое имя.
+     * @return true, если идентификатор текущего имени меньше.
+     */
+    bool operator<(const Symbol& other) const { return id < other.id; }
+};
+
+/**
+ * @brief Выводит имя в поток.
+ * @param os Поток вывода.
+ * @param symbol Имя.
+ * @return Поток вывода.
+ */
+inline std::ostream& operator<<(std::ostream& os, const Symbol& symbol) {
+    return os << symbol.name();
+}
+
 /**
  * @brief Класс для представления токена логического выражения.
  *
- * Хранит информацию о типе токена, его строковом представлении и позиции в исходной строке.
+ * Хранит информацию о типе токена, его интернированном значении и позиции в исходной строке.
  */
 class Token {
 public:
-    TokenType type;     ///< Тип токена (переменная или операция).
-    std::string value;  ///< Строковое значение токена.
-    int position;       ///< Позиция токена в исходной строке.
+    TokenType type;  ///< Тип токена (переменная или операция).
+    Symbol value;    ///< Интернированное значение токена.
+    int position;    ///< Позиция токена в исходной строке.
 
     /**
      * @brief Конструктор класса Token.
      *
      * Инициализирует токен с указанным типом, значением и позицией.
      * @param t Тип токена.
-     * @param v Строковое значение токена.
+     * @param v Значение токена.
      * @param pos Позиция токена в строке.
      */
-    Token(TokenType t, const std::string& v, int pos) : type(t), value(v), position(pos) {}
+    Token(TokenType t, Symbol v, int pos) : type(t), value(v), position(pos) {}
+};
+
+/**
+ * @brief Класс для представления узла бинарного дерева логического выражения.
+ *
+ * Хранит тип узла, значение (для переменных) и указатели на левое и правое поддеревья.
+ */
+class ExpressionNode {
+public:
+    TokenType type;             ///< Тип узла (переменная или операция).
+    Symbol value;               ///< Значение переменной (для узлов типа Variable).
+    ExpressionNode* left;       ///< Указатель на левое поддерево.
+    ExpressionNode* right;      ///< Указатель на правое поддерево.
+
+    /**
+     * @brief Конструктор для узла с типом и значением.
+     *
+     * Создает узел с указанным типом и значением, поддеревья инициализируются как nullptr.
+     * @param t Тип узла.
+     * @param v Значение переменной (по умолчанию пустое имя).
+     */
+    ExpressionNode(TokenType t, Symbol v = Symbol()) : type(t), value(v), left(nullptr), right(nullptr) {}
+
+    /**
+     * @brief Конструктор для узла с типом и поддеревьями.
+     *
+     * Создает узел с указанным типом и указателями на левое и правое поддеревья.
+     * @param t Тип узла.
+     * @param l Указатель на левое поддерево.
+     * @param r Указатель на правое поддерево.
+     */
+    ExpressionNode(TokenType t, ExpressionNode* l, ExpressionNode* r) : type(t), value(), left(l), right(r) {}
+
+    /**
+     * @brief Конструктор для узла с типом, значением и поддеревьями.
+     *
+     * Создает узел с указанным типом, значением и указателями на поддеревья.
+     * @param t Тип узла.
+     * @param v Значение переменной.
+     * @param l Указатель на левое поддерево.
+     * @param r Указатель на правое поддерево.
+     */
+    ExpressionNode(TokenType t, Symbol v, ExpressionNode* l, ExpressionNode* r) : type(t), value(v), left(l), right(r) {}
+
+    /**
+     * @brief Деструктор класса ExpressionNode.
+     *
+     * Освобождает память, занятую поддеревьями. Поддеревья удаляются с явным стеком: каждый узел
+     * отсоединяется от своих поддеревьев до удаления, поэтому вложенные деструкторы не рекурсивны
+     * и глубина дерева не ограничена размером стека вызовов.
+     */
+    ~ExpressionNode() {
+        if (!left && !right) return;
+
+        // У отсоединенных узлов нет поддеревьев, поэтому их деструкторы не обращаются к стеку
+        thread_local std::vector<ExpressionNode*> pending;
+        size_t base = pending.size();
+        if (left) pending.push_back(left);
+        if (right) pending.push_back(right);
+
+        while (pending.size() > base) {
+            ExpressionNode* node = pending.back();
+            pending.pop_back();
+
+            if (node->left) pending.push_back(node->left);
+            if (node->right) pending.push_back(node->right);
+            node->left = nullptr;
+            node->right = nullptr;
+            delete node;
+        }
+    }
+
+    /**
+     * @brief Выделяет память под узел.
+     *
+     * Если в текущем потоке активен пул узлов (см. ArenaScope), память берется из него, иначе из общей кучи.
+     * @param size Размер узла в байтах.
+     * @return Указатель на выделенную память.
+     */
+    static void* operator new(size_t size);
+
+    /**
+     * @brief Освобождает память узла.
+     *
+     * Память узла из активного пула возвращается в список свободных ячеек пула, иначе в общую кучу.
+     * @param p Указатель на память узла.
+     */
+    static void operator delete(void* p);
+
+    /**
+     * @brief Счетчик выделений памяти под узлы в текущем потоке.
+     *
+     * Увеличивается при каждом вызове operator new, независимо от того, берется ли память из пула или из кучи.
+     * @return Ссылка на счетчик.
+     */
+    static size_t& allocationCount() {
+        thread_local size_t count = 0;
+        return count;
+    }
+
+    /**
+     * @brief Счетчик освобождений памяти узлов в текущем потоке.
+     * @return Ссылка на счетчик.
+     */
+    static size_t& releaseCount() {
+        thread_local size_t count = 0;
+        return count;
+    }
+};
+
+/**
+ * @brief Класс пула узлов дерева выражения.
+ *
+ * Выделяет ячейки фиксированного размера из блоков по blockBytes байт и хранит
+ * освобожденные ячейки в списке свободных. Все узлы одного выражения освобождаются за O(1)
+ * вызовом reset(): блоки сохраняются и используются повторно, поэтому при обработке
+ * последовательности выражений обращения к общей куче прекращаются после первых выражений.
+ * Блоки выровнены по своему размеру, поэтому принадлежность указателя пулу проверяется
+ * одним поиском начала его блока в хеш-таблице, без перебора блоков.
+ */
+class NodeArena {
+public:
+    /**
+     * @brief Конструктор класса NodeArena.
+     * @param slotSize Размер ячейки в байтах (по умолчанию размер узла дерева).
+     */
+    explicit NodeArena(size_t slotSize = sizeof(ExpressionNode))
+        : slotSize(slotSize < sizeof(FreeSlot) ? sizeof(FreeSlot) : slotSize), activeBlock(0), offset(0), freeList(nullptr) {
+#ifndef NDEBUG
+        std::lock_guard<std::mutex> lock(registryMutex());
+        registry().insert(this);
+#endif
+    }
+
+    /**
+     * @brief Деструктор класса NodeArena.
+     *
+     * Возвращает все блоки в общую кучу. Деструкторы узлов не вызываются.
+     */
+    ~NodeArena() {
+#ifndef NDEBUG
+        std::lock_guard<std::mutex> lock(registryMutex());
+        registry().erase(this);
+#endif
+        for (char* block : blocks) {
+            ::operator delete(block, std::align_val_t(blockBytes));
+        }
+    }
+
+    NodeArena(const NodeArena&) = delete;
+    NodeArena& operator=(const NodeArena&) = delete;
+
+    /**
+     * @brief Выделяет одну ячейку.
+     * @return Указатель на ячейку.
+     */
+    void* allocate() {
+        // Повторное использование освобожденной ячейки
+        if (freeList) {
+            FreeSlot* slot = freeList;
+            freeList = slot->next;
+            return slot;
+        }
+
+        // Переход к следующему блоку, если в текущем нет места
+        while (activeBlock < blocks.size() && offset + slotSize > blockBytes) {
+            activeBlock++;
+            offset = 0;
+        }
+        if (activeBlock == blocks.size()) {
+            addBlock();
+        }
+
+        void* slot = blocks[activeBlock] + offset;
+        offset += slotSize;
+        return slot;
+    }
+
+    /**
+     * @brief Возвращает ячейку в список свободных.
+     * @param p Указатель на ячейку, выделенную этим пулом.
+     */
+    void release(void* p) {
+        FreeSlot* slot = static_cast<FreeSlot*>(p);
+        slot->next = freeList;
+        freeList = slot;
+    }
+
+    /**
+     * @brief Проверяет, принадлежит ли память пулу.
+     * @param p Указатель на память.
+     * @return true, если указатель лежит в одном из блоков пула.
+     */
+    bool owns(const void* p) const {
+        uintptr_t block = reinterpret_cast<uintptr_t>(p) & ~static_cast<uintptr_t>(blockBytes - 1);
+        return blockIndex.count(block) != 0;
+    }
+
+#ifndef NDEBUG
+    /**
+     * @brief Проверяет, принадлежит ли память какому-либо существующему пулу (только в отладочной сборке).
+     * @param p Указатель на память.
+     * @return true, если указатель лежит в блоке одного из пулов.
+     */
+    static bool ownedByAnyArena(const void* p) {
+        std::lock_guard<std::mutex> lock(registryMutex());
+        for (const NodeArena* arena : registry()) {
+            if (arena->owns(p)) return true;
+        }
+        return false;
+    }
+#endif
+
+    /**
+     * @brief Освобождает все ячейки пула за O(1).
+     *
+     * Блоки не возвращаются в кучу и используются повторно. Деструкторы узлов не вызываются,
+     * поэтому после сброса узлы пула нельзя удалять через delete.
+     */
+    void reset() {
+        activeBlock = 0;
+        offset = 0;
+        freeList = nullptr;
+    }
+
+    /**
+     * @brief Возвращает количество блоков, полученных из общей кучи.
+     * @return Количество блоков.
+     */
+    size_t blockCount() const {
+        return blocks.size();
+    }
+
+    /**
+     * @brief Возвращает пул, активный в текущем потоке.
+     * @return Ссылка на указатель активного пула (nullptr, если пул не активен).
+     */
+    static NodeArena*& current() {
+        thread_local NodeArena* arena = nullptr;
+        return arena;
+    }
+
+    const size_t slotSize; ///< Размер ячейки в байтах.
+
+private:
+    /**
+     * @brief Ячейка в списке свободных.
+     */
+    struct FreeSlot {
+        FreeSlot* next; ///< Следующая свободная ячейка.
+    };
+
+    static constexpr size_t blockBytes = 1 << 18;  ///< Размер и выравнивание блока в байтах.
+
+    std::vector<char*> blocks;                ///< Блоки памяти в порядке выделения.
+    std::unordered_set<uintptr_t> blockIndex; ///< Адреса начал блоков для проверки принадлежности.
+    size_t activeBlock;                       ///< Индекс блока, из которого выделяются ячейки.
+    size_t offset;                            ///< Смещение первой невыделенной ячейки в активном блоке.
+    FreeSlot* freeList;                       ///< Список освобожденных ячеек.
+
+    /**
+     * @brief Получает из кучи новый блок, выровненный по своему размеру.
+     */
+    void addBlock() {
+        char* block = static_cast<char*>(::operator new(blockBytes, std::align_val_t(blockBytes)));
+#ifndef NDEBUG
+        std::lock_guard<std::mutex> lock(registryMutex());
+#endif
+        blocks.push_back(block);
+        blockIndex.insert(reinterpret_cast<uintptr_t>(block));
+    }
+
+#ifndef NDEBUG
+    /**
+     * @brief Возвращает защиту списка существующих пулов.
+     * @return Ссылка на мьютекс.
+     */
+    static std::mutex& registryMutex() {
+        static std::mutex mutex;
+        return mutex;
+    }
+
+    /**
+     * @brief Возвращает список существующих пулов для отладочных проверок.
+     * @return Ссылка на множество пулов.
+     */
+    static std::unordered_set<const NodeArena*>& registry() {
+        static std::unordered_set<const NodeArena*> arenas;
+        return arenas;
+    }
+#endif
+};
+
+/**
+ * @brief Класс области действия пула узлов.
+ *
+ * Делает пул активным в текущем потоке на время своего существования: все узлы ExpressionNode,
+ * созданные в этой области, размещаются в пуле. При выходе из области восстанавливается предыдущий пул.
+ *
+ * Узел пула можно удалить через delete только в области действия того же пула: иначе operator delete
+ * не узнает память пула и вернет ее в общую кучу. Вне области узлы пула освобождаются вместе с ним
+ * (reset() или деструктор пула); в отладочной сборке нарушение правила останавливает программу assert.
+ */
+class ArenaScope {
+public:
+    /**
+     * @brief Конструктор класса ArenaScope.
+     * @param arena Пул, который становится активным.
+     */
+    explicit ArenaScope(NodeArena& arena) : previous(NodeArena::current()) {
+        NodeArena::current() = &arena;
+    }
+
+    /**
+     * @brief Деструктор класса ArenaScope.
+     *
+     * Восстанавливает пул, активный до создания области.
+     */
+    ~ArenaScope() {
+        NodeArena::current() = previous;
+    }
+
+    ArenaScope(const ArenaScope&) = delete;
+    ArenaScope& operator=(const ArenaScope&) = delete;
+
+private:
+    NodeArena* previous; ///< Пул, активный до создания области.
+};
+
+inline void* ExpressionNode::operator new(size_t size) {
+    ++allocationCount();
+    NodeArena* arena = NodeArena::current();
+    if (arena && size <= arena->slotSize) {
+        return arena->allocate();
+    }
+    return ::operator new(size);
+}
+
+/**
+ * @brief Индекс узла в плоском дереве выражения.
+ */
+using NodeIndex = uint32_t;
+
+/**
+ * @brief Индекс отсутствующего узла (аналог nullptr).
+ */
+const NodeIndex nullNode = 0xFFFFFFFFu;
+
+/**
+ * @brief Класс плоского дерева логического выражения.
+ *
+ * Хранит узлы в непрерывных массивах (структура массивов): тип узла занимает один байт,
+ * поддеревья задаются 32-битными индексами, имена переменных — идентификаторами Symbol.
+ * Узел занимает 13 байт против 24 байт узла ExpressionNode и не требует отдельного выделения памяти,
+ * поэтому обходы не переходят по разбросанным в куче указателям. Узлы, исключенные из дерева
+ * преобразованиями, остаются в массивах до вызова clear().
+ */
+class FlatExpression {
+public:
+    std::vector<uint8_t> types;     ///< Типы узлов (значения TokenType).
+    std::vector<uint32_t> symbols;  ///< Идентификаторы имен переменных.
+    std::vector<NodeIndex> lefts;   ///< Индексы левых поддеревьев.
+    std::vector<NodeIndex> rights;  ///< Индексы правых поддеревьев.
+
+    /**
+     * @brief Добавляет узел.
+     * @param t Тип узла.
+     * @param v Значение переменной.
+     * @param l Индекс левого поддерева.
+     * @param r Индекс правого поддерева.
+     * @return Индекс нового узла.
+     */
+    NodeIndex addNode(TokenType t, Symbol v = Symbol(), NodeIndex l = nullNode, NodeIndex r = nullNode) {
+        types.push_back(static_cast<uint8_t>(t));
+        symbols.push_back(v.id);
+        lefts.push_back(l);
+        rights.push_back(r);
+        return static_cast<NodeIndex>(types.size() - 1);
+    }
+
+    /**
+     * @brief Возвращает тип узла.
+     * @param node Индекс узла.
+     * @return Тип узла.
+     */
+    TokenType type(NodeIndex node) const {
+        return static_cast<TokenType>(types[node]);
+    }
+
+    /**
+     * @brief Возвращает количество узлов в массивах.
+     * @return Количество узлов.
+     */
+    size_t size() const {
+        return types.size();
+    }
+
+    /**
+     * @brief Резервирует память под указанное количество узлов.
+     * @param count Количество узлов.
+     */
+    void reserve(size_t count) {
+        types.reserve(count);
+        symbols.reserve(count);
+        lefts.reserve(count);
+        rights.reserve(count);
+    }
+
+    /**
+     * @brief Удаляет все узлы, сохраняя выделенную память.
+     */
+    void clear() {
+        types.clear();
+        symbols.clear();
+        lefts.clear();
+        rights.clear();
+    }
+};
+
+/**
+ * @brief Класс логического выражения в виде ориентированного ациклического графа с общими подвыражениями.
+ *
+ * Узлы создаются только через makeNode, который по таблице уникальных узлов возвращает уже существующий
+ * узел с теми же типом, значением и поддеревьями. Поэтому одинаковые подвыражения хранятся в одном экземпляре,
+ * а раскрытие эквивалентности, в котором операнды встречаются дважды, добавляет постоянное число узлов.
+ * Узлы неизменяемы: преобразования строят новые узлы, а не меняют существующие.
+ */
+class ExpressionDag {
+public:
+    /**
+     * @brief Возвращает узел с заданными полями, создавая его при отсутствии.
+     * @param t Тип узла.
+     * @param v Значение переменной.
+     * @param l Индекс левого поддерева.
+     * @param r Индекс правого поддерева.
+     * @return Индекс единственного узла с такими полями.
+     */
+    NodeIndex makeNode(TokenType t, Symbol v = Symbol(), NodeIndex l = nullNode, NodeIndex r = nullNode) {
+        NodeKey key = { static_cast<uint8_t>(t), v.id, l, r };
+        auto found = table.find(key);
+        if (found != table.end()) return found->second;
+
+        NodeIndex index = nodes.addNode(t, v, l, r);
+        table.emplace(key, index);
+        return index;
+    }
+
+    /**
+     * @brief Возвращает тип узла.
+     * @param node Индекс узла.
+     * @return Тип узла.
+     */
+    TokenType type(NodeIndex node) const {
+        return nodes.type(node);
+    }
+
+    /**
+     * @brief Возвращает индекс левого поддерева.
+     * @param node Индекс узла.
+     * @return Индекс левого поддерева или nullNode.
+     */
+    NodeIndex left(NodeIndex node) const {
+        return nodes.lefts[node];
+    }
+
+    /**
+     * @brief Возвращает индекс правого поддерева.
+     * @param node Индекс узла.
+     * @return Индекс правого поддерева или nullNode.
+     */
+    NodeIndex right(NodeIndex node) const {
+        return nodes.rights[node];
+    }
+
+    /**
+     * @brief Возвращает значение узла.
+     * @param node Индекс узла.
+     * @return Имя переменной (пустое для операций).
+     */
+    Symbol value(NodeIndex node) const {
+        Symbol result;
+        result.id = nodes.symbols[node];
+        return result;
+    }
+
+    /**
+     * @brief Возвращает массивы узлов для обходов, не изменяющих граф.
+     * @return Плоское представление всех узлов графа.
+     */
+    const FlatExpression& graph() const {
+        return nodes;
+    }
+
+    /**
+     * @brief Возвращает количество уникальных узлов.
+     * @return Количество узлов.
+     */
+    size_t size() const {
+        return nodes.size();
+    }
+
+    /**
+     * @brief Удаляет все узлы, сохраняя выделенную память массивов.
+     */
+    void clear() {
+        nodes.clear();
+        table.clear();
+    }
+
+private:
+    /**
+     * @brief Ключ таблицы уникальных узлов.
+     */
+    struct NodeKey {
+        uint8_t type;     ///< Тип узла.
+        uint32_t symbol;  ///< Идентификатор имени переменной.
+        NodeIndex left;   ///< Индекс левого поддерева.
+        NodeIndex right;  ///< Индекс правого поддерева.
+
+        bool operator==(const NodeKey& other) const {
+            return type == other.type && symbol == other.symbol && left == other.left && right == other.right;
+        }
+    };
+
+    /**
+     * @brief Хеш-функция ключа узла.
+     */
+    struct NodeKeyHash {
+        size_t operator()(const NodeKey& key) const {
+            uint64_t h = (static_cast<uint64_t>(key.left) << 32) ^ key.right;
+            h ^= (static_cast<uint64_t>(key.symbol) << 8 | key.type) * 0x9E3779B97F4A7C15ull;
+            h ^= h >> 29;
+            h *= 0xBF58476D1CE4E5B9ull;
+            h ^= h >> 32;
+            return static_cast<size_t>(h);
+        }
+    };
+
+    FlatExpression nodes;                                        ///< Массивы узлов.
+    std::unordered_map<NodeKey, NodeIndex, NodeKeyHash> table;   ///< Таблица уникальных узлов.
+};
+
+/**
+ * @brief Ребро графа с отрицаниями на ребрах: индекс узла, сдвинутый на один бит, и бит отрицания в младшем разряде.
+ */
+using Edge = uint32_t;
+
+/**
+ * @brief Отсутствующее ребро (аналог nullptr).
+ */
+const Edge nullEdge = 0xFFFFFFFFu;
+
+/**
+ * @brief Класс логического выражения с отрицаниями на ребрах.
+ *
+ * Отрицание не хранится отдельным узлом, как в ExpressionNode, а задается битом в ссылке на поддерево,
+ * как в AIG и BDD. Поэтому двойное отрицание не занимает памяти, законы де Моргана сводятся к инверсии
+ * битов, а отрицательная нормальная форма получается при чтении дерева, без его перестройки.
+ * В массивах хранятся только переменные и бинарные операции.
+ */
+class EdgeExpression {
+public:
+    std::vector<uint8_t> types;     ///< Типы узлов (значения TokenType).
+    std::vector<uint32_t> symbols;  ///< Идентификаторы имен переменных.
+    std::vector<Edge> lefts;        ///< Ребра к левым поддеревьям.
+    std::vector<Edge> rights;       ///< Ребра к правым поддеревьям.
+
+    /**
+     * @brief Добавляет узел.
+     * @param t Тип узла (переменная или бинарная операция).
+     * @param v Значение переменной.
+     * @param l Ребро к левому поддереву.
+     * @param r Ребро к правому поддереву.
+     * @return Ребро без отрицания к новому узлу.
+     */
+    Edge addNode(TokenType t, Symbol v = Symbol(), Edge l = nullEdge, Edge r = nullEdge) {
+        types.push_back(static_cast<uint8_t>(t));
+        symbols.push_back(v.id);
+        lefts.push_back(l);
+        rights.push_back(r);
+        return static_cast<Edge>(types.size() - 1) << 1;
+    }
+
+    /**
+     * @brief Возвращает индекс узла, на который указывает ребро.
+     * @param edge Ребро.
+     * @return Индекс узла.
+     */
+    static NodeIndex node(Edge edge) {
+        return edge >> 1;
+    }
+
+    /**
+     * @brief Проверяет, стоит ли на ребре отрицание.
+     * @param edge Ребро.
+     * @return true, если ребро отрицательное.
+     */
+    static bool negated(Edge edge) {
+        return (edge & 1) != 0;
+    }
+
+    /**
+     * @brief Возвращает отрицание ребра.
+     * @param edge Ребро.
+     * @return Ребро к тому же узлу с противоположным битом отрицания.
+     */
+    static Edge negate(Edge edge) {
+        return edge ^ 1;
+    }
+
+    /**
+     * @brief Возвращает тип узла.
+     * @param node Индекс узла.
+     * @return Тип узла.
+     */
+    TokenType type(NodeIndex node) const {
+        return static_cast<TokenType>(types[node]);
+    }
+
+    /**
+     * @brief Возвращает количество узлов в массивах.
+     * @return Количество узлов.
+     */
+    size_t size() const {
+        return types.size();
+    }
+
+    /**
+     * @brief Резервирует память под указанное количество узлов.
+     * @param count Количество узлов.
+     */
+    void reserve(size_t count) {
+        types.reserve(count);
+        symbols.reserve(count);
+        lefts.reserve(count);
+        rights.reserve(count);
+    }
+
+    /**
+     * @brief Удаляет все узлы, сохраняя выделенную память.
+     */
+    void clear() {
+        types.clear();
+        symbols.clear();
+        lefts.clear();
+        rights.clear();
+    }
+};
+
+/**
+ * @brief Класс графа из конъюнкций с отрицаниями на ребрах (And-Inverter Graph) со структурным хешированием.
+ *
+ * Узел — переменная или конъюнкция двух ребер; ребро устроено так же, как в EdgeExpression. Дизъюнкция,
+ * импликация и эквивалентность выражаются через конъюнкцию и отрицание, операнды конъюнкции упорядочиваются,
+ * а таблица уникальных узлов не дает создать два узла с одинаковыми операндами. Поэтому выражения, которые
+ * отличаются только законами де Моргана, двойными отрицаниями, перестановкой операндов и раскрытием импликации
+ * и эквивалентности, дают одно и то же ребро. Узел 0 — константа «ложь».
+ */
+class AndInverterGraph {
+public:
+    /**
+     * @brief Конструктор: создает узел константы.
+     */
+    AndInverterGraph() {
+        clear();
+    }
+
+    /**
+     * @brief Возвращает ребро к переменной, создавая узлы переменных до нее при первом обращении.
+     * @param index Номер переменной.
+     * @return Ребро без отрицания к узлу переменной.
+     */
+    Edge variable(uint32_t index);
+
+    /**
+     * @brief Возвращает ребро к конъюнкции, создавая узел при отсутствии.
+     * @param a Первый операнд.
+     * @param b Второй операнд.
+     * @return Ребро к единственному узлу с такими операндами или упрощенный результат.
+     */
+    Edge conjunction(Edge a, Edge b);
+
+    /**
+     * @brief Возвращает ребро к дизъюнкции: a | b = !(!a & !b).
+     * @param a Первый операнд.
+     * @param b Второй операнд.
+     * @return Ребро к результату.
+     */
+    Edge disjunction(Edge a, Edge b) {
+        return EdgeExpression::negate(conjunction(EdgeExpression::negate(a), EdgeExpression::negate(b)));
+    }
+
+    /**
+     * @brief Возвращает ребро к импликации: a > b = !(a & !b).
+     * @param a Посылка.
+     * @param b Следствие.
+     * @return Ребро к результату.
+     */
+    Edge implication(Edge a, Edge b) {
+        return EdgeExpression::negate(conjunction(a, EdgeExpression::negate(b)));
+    }
+
+    /**
+     * @brief Возвращает ребро к эквивалентности: a ~ b = (a & b) | (!a & !b).
+     * @param a Первый операнд.
+     * @param b Второй операнд.
+     * @return Ребро к результату.
+     */
+    Edge equivalence(Edge a, Edge b) {
+        return disjunction(conjunction(a, b), conjunction(EdgeExpression::negate(a), EdgeExpression::negate(b)));
+    }
+
+    /**
+     * @brief Возвращает количество узлов, включая константу.
+     * @return Количество узлов.
+     */
+    size_t size() const {
+        return lefts.size();
+    }
+
+    /**
+     * @brief Удаляет все узлы, кроме константы, сохраняя выделенную память.
+     */
+    void clear() {
+        lefts.assign(1, nullEdge);
+        rights.assign(1, nullEdge);
+        variables.clear();
+        table.clear();
+    }
+
+private:
+    std::vector<Edge> lefts;                         ///< Первые операнды конъюнкций (nullEdge у переменных и константы).
+    std::vector<Edge> rights;                        ///< Вторые операнды конъюнкций.
+    std::vector<Edge> variables;                     ///< Ребра к узлам переменных по номерам.
+    std::unordered_map<uint64_t, NodeIndex> table;   ///< Таблица уникальных конъюнкций.
+};
+
+/**
+ * @brief Ссылка на узел диаграммы двоичных решений: индекс узла в массивах BddManager.
+ */
+using BddRef = uint32_t;
+
+/**
+ * @brief Константа «ложь» диаграммы двоичных решений.
+ */
+const BddRef bddFalse = 0;
+
+/**
+ * @brief Константа «истина» диаграммы двоичных решений.
+ */
+const BddRef bddTrue = 1;
+
+/**
+ * @brief Отсутствующая ссылка (конец цепочки таблицы уникальных узлов, пустой список свободных узлов).
+ */
+const BddRef nullBdd = 0xFFFFFFFFu;
+
+/**
+ * @brief Класс менеджера приведенных упорядоченных диаграмм двоичных решений (ROBDD).
+ *
+ * Узел хранит номер переменной и ссылки на ветви low (переменная ложна) и high (переменная истинна).
+ * Для каждой переменной ведется своя хеш-таблица уникальных узлов, поэтому узел с заданными переменной
+ * и ветвями существует в одном экземпляре, а диаграммы равносильных функций совпадают по ссылке:
+ * проверка равносильности и тождественной истинности после построения выполняется за O(1).
+ * Результаты ite запоминаются в кэше прямого отображения.
+ *
+ * Счетчик ссылок узла равен числу родителей и внешних ссылок (ref/deref). Сборка мусора удаляет узлы
+ * с нулевым счетчиком и выполняется только в начале операции верхнего уровня, когда число узлов превысило
+ * порог. Операнды операции защищены на время сборки, а ее результат нужно защитить ref до следующей операции.
+ * Переменные упорядочены по уровням; новая переменная добавляется на нижний уровень.
+ *
+ * Порядок переменных меняется просеиванием (sifting): каждая переменная по очереди проводится через все уровни
+ * обменами соседних уровней и оставляется там, где диаграммы меньше. Обмен переписывает узлы на месте, поэтому
+ * защищенные ссылки остаются действительными. Просеивание запускается автоматически в начале операции, когда
+ * число узлов превысило порог, и на тех же условиях, что и сборка мусора.
+ */
+class BddManager {
+public:
+    /**
+     * @brief Конструктор: создает узлы констант и пустой кэш.
+     */
+    BddManager();
+
+    /**
+     * @brief Возвращает номер переменной с заданным именем, добавляя ее на нижний уровень при отсутствии.
+     * @param name Имя переменной.
+     * @return Номер переменной.
+     */
+    uint32_t variableIndex(Symbol name);
+
+    /**
+     * @brief Возвращает диаграмму функции, равной переменной.
+     * @param name Имя переменной.
+     * @return Ссылка на узел переменной.
+     */
+    BddRef variable(Symbol name) {
+        maybeCollect(nullBdd, nullBdd, nullBdd);
+        return makeNode(variableIndex(name), bddFalse, bddTrue);
+    }
+
+    /**
+     * @brief Возвращает количество переменных.
+     * @return Количество переменных.
+     */
+    size_t variableCount() const {
+        return names.size();
+    }
+
+    /**
+     * @brief Возвращает имя переменной.
+     * @param var Номер переменной.
+     * @return Имя переменной.
+     */
+    Symbol variableName(uint32_t var) const {
+        return names[var];
+    }
+
+    /**
+     * @brief Возвращает уровень переменной в текущем порядке.
+     * @param var Номер переменной.
+     * @return Уровень (0 — корень диаграмм).
+     */
+    uint32_t levelOf(uint32_t var) const {
+        return levels[var];
+    }
+
+    /**
+     * @brief Возвращает переменную, стоящую на уровне.
+     * @param level Уровень.
+     * @return Номер переменной.
+     */
+    uint32_t variableAt(uint32_t level) const {
+        return order[level];
+    }
+
+    /**
+     * @brief Проверяет, является ли узел константой.
+     * @param f Ссылка на узел.
+     * @return true для bddFalse и bddTrue.
+     */
+    static bool isConstant(BddRef f) {
+        return f <= bddTrue;
+    }
+
+    /**
+     * @brief Возвращает номер переменной узла.
+     * @param f Ссылка на узел, не константа.
+     * @return Номер переменной.
+     */
+    uint32_t variableOf(BddRef f) const {
+        return vars[f];
+    }
+
+    /**
+     * @brief Возвращает ветвь узла, в которой переменная ложна.
+     * @param f Ссылка на узел, не константа.
+     * @return Ссылка на ветвь low.
+     */
+    BddRef low(BddRef f) const {
+        return lows[f];
+    }
+
+    /**
+     * @brief Возвращает ветвь узла, в которой переменная истинна.
+     * @param f Ссылка на узел, не константа.
+     * @return Ссылка на ветвь high.
+     */
+    BddRef high(BddRef f) const {
+        return highs[f];
+    }
+
+    /**
+     * @brief Вычисляет функцию «если f, то g, иначе h».
+     * @param f Условие.
+     * @param g Значение при истинном условии.
+     * @param h Значение при ложном условии.
+     * @return Ссылка на узел результата (не защищена от сборки мусора).
+     * @throw Error с типом bddNodeLimit, если число узлов превысило предел setNodeLimit.
+     */
+    BddRef ite(BddRef f, BddRef g, BddRef h) {
+        maybeCollect(f, g, h);
+        return iteStep(f, g, h);
+    }
+
+    /**
+     * @brief Вычисляет отрицание функции.
+     * @param f Операнд.
+     * @return Ссылка на узел результата (не защищена от сборки мусора).
+     */
+    BddRef negate(BddRef f) {
+        return ite(f, bddFalse, bddTrue);
+    }
+
+    /**
+     * @brief Применяет бинарную логическую операцию.
+     * @param type Операция: And, Or, Implication или Equivalence.
+     * @param f Левый операнд.
+     * @param g Правый операнд.
+     * @return Ссылка на узел результата (не защищена от сборки мусора) или nullBdd для прочих типов.
+     * @throw Error с типом bddNodeLimit, если число узлов превысило предел setNodeLimit.
+     */
+    BddRef apply(TokenType type, BddRef f, BddRef g);
+
+    /**
+     * @brief Защищает узел от сборки мусора.
+     * @param f Ссылка на узел.
+     */
+    void ref(BddRef f) {
+        refs[f]++;
+    }
+
+    /**
+     * @brief Снимает защиту, установленную ref.
+     * @param f Ссылка на узел.
+     */
+    void deref(BddRef f) {
+        if (refs[f] > 0) refs[f]--;
+    }
+
+    /**
+     * @brief Проверяет, является ли функция тождественно истинной.
+     * @param f Ссылка на узел.
+     * @return true, если f — константа «истина».
+     */
+    static bool isTautology(BddRef f) {
+        return f == bddTrue;
+    }
+
+    /**
+     * @brief Проверяет, выполнима ли функция.
+     * @param f Ссылка на узел.
+     * @return true, если f не константа «ложь».
+     */
+    static bool isSatisfiable(BddRef f) {
+        return f != bddFalse;
+    }
+
+    /**
+     * @brief Проверяет равносильность функций.
+     * @param f Ссылка на первый узел.
+     * @param g Ссылка на второй узел.
+     * @return true, если функции равносильны (диаграммы канонические, поэтому достаточно сравнить ссылки).
+     */
+    static bool areEquivalent(BddRef f, BddRef g) {
+        return f == g;
+    }
+
+    /**
+     * @brief Возвращает количество живых узлов, не считая констант.
+     * @return Количество узлов.
+     */
+    size_t nodeCount() const {
+        return liveNodes;
+    }
+
+    /**
+     * @brief Возвращает количество узлов диаграммы, не считая констант.
+     * @param f Ссылка на корень.
+     * @return Количество узлов, достижимых из f.
+     */
+    size_t size(BddRef f) const;
+
+    /**
+     * @brief Считает наборы значений всех переменных менеджера, на которых функция истинна.
+     *
+     * Для каждого узла вычисляется доля выполняющих наборов, равная полусумме долей ветвей, поэтому
+     * результат не зависит от порядка переменных. Время линейно по размеру диаграммы.
+     * @param f Ссылка на корень.
+     * @return Количество выполняющих наборов (2 в степени variableCount() для тождественной истины).
+     */
+    double satCount(BddRef f) const;
+
+    /**
+     * @brief Удаляет узлы, на которые нет ссылок, и очищает кэш операций.
+     */
+    void collectGarbage();
+
+    /**
+     * @brief Меняет порядок переменных просеиванием.
+     *
+     * Сначала собирает мусор, затем просеивает переменные в порядке убывания числа их узлов. Переменная идет
+     * сначала к ближнему краю, затем к дальнему; движение в одну сторону прекращается, когда число узлов
+     * превысило лучшее в maxSiftGrowth раз. Незащищенные узлы при этом удаляются.
+     */
+    void reorder();
+
+    /**
+     * @brief Включает или выключает автоматическое просеивание.
+     * @param enabled true, чтобы просеивание запускалось при превышении порога числа узлов.
+     */
+    void setAutoReorder(bool enabled) {
+        autoReorder = enabled;
+    }
+
+    /**
+     * @brief Ограничивает число узлов.
+     *
+     * Операция, после которой узлов стало больше предела, прерывается исключением; созданные до этого узлы
+     * остаются в менеджере и удаляются сборкой мусора, как обычно.
+     * @param limit Наибольшее число живых узлов, не считая констант.
+     */
+    void setNodeLimit(size_t limit) {
+        nodeLimit = limit;
+    }
+
+    /**
+     * @brief Возвращает количество выполненных просеиваний.
+     * @return Количество вызовов reorder, в том числе автоматических.
+     */
+    size_t reorderCount() const {
+        return reorderings;
+    }
+
+private:
+    /**
+     * @brief Элемент кэша операций ite.
+     */
+    struct CacheEntry {
+        BddRef f;       ///< Условие.
+        BddRef g;       ///< Значение при истинном условии.
+        BddRef h;       ///< Значение при ложном условии.
+        BddRef result;  ///< Результат.
+    };
+
+    /**
+     * @brief Таблица уникальных узлов одной переменной.
+     */
+    struct Subtable {
+        std::vector<BddRef> buckets;  ///< Начала цепочек.
+        size_t count = 0;             ///< Количество узлов переменной.
+    };
+
+    static constexpr uint32_t terminalVariable = 0xFFFFFFFFu;  ///< Номер переменной у констант.
+    static constexpr uint32_t freeVariable = 0xFFFFFFFEu;      ///< Номер переменной у свободных узлов.
+    static constexpr uint32_t terminalLevel = 0xFFFFFFFFu;     ///< Уровень констант (ниже всех переменных).
+    static constexpr size_t initialSubtableSize = 16;          ///< Начальное число цепочек таблицы переменной.
+    static constexpr size_t initialCacheSize = 1 << 12;        ///< Начальный размер кэша.
+    static constexpr size_t maxCacheSize = 1 << 22;            ///< Наибольший размер кэша.
+    static constexpr size_t initialCollectThreshold = 1 << 16; ///< Начальный порог сборки мусора.
+    static constexpr size_t initialReorderThreshold = 1 << 14; ///< Начальный порог автоматического просеивания.
+    static constexpr double maxSiftGrowth = 1.2;               ///< Допустимый рост числа узлов при просеивании.
+
+    /**
+     * @brief Возвращает уровень узла.
+     * @param f Ссылка на узел.
+     * @return Уровень переменной узла или terminalLevel для констант.
+     */
+    uint32_t levelOfNode(BddRef f) const {
+        return isConstant(f) ? terminalLevel : levels[vars[f]];
+    }
+
+    /**
+     * @brief Перемешивает ссылки для хеш-таблиц.
+     * @param a Первая ссылка.
+     * @param b Вторая ссылка.
+     * @return Хеш пары.
+     */
+    static size_t hashPair(BddRef a, BddRef b) {
+        uint64_t h = (static_cast<uint64_t>(a) << 32 | b) * 0x9E3779B97F4A7C15ull;
+        return static_cast<size_t>(h ^ (h >> 29));
+    }
+
+    /**
+     * @brief Возвращает узел с заданными переменной и ветвями, создавая его при отсутствии.
+     * @param var Номер переменной.
+     * @param lowBranch Ветвь при ложной переменной.
+     * @param highBranch Ветвь при истинной переменной.
+     * @return Ссылка на единственный такой узел или на ветвь, если ветви совпадают.
+     */
+    BddRef makeNode(uint32_t var, BddRef lowBranch, BddRef highBranch);
+
+    /**
+     * @brief Добавляет узел в таблицу уникальных узлов его переменной.
+     * @param node Ссылка на узел, которого нет в таблице.
+     */
+    void insertNode(BddRef node);
+
+    /**
+     * @brief Удаляет узел из таблицы уникальных узлов его переменной.
+     * @param node Ссылка на узел из таблицы.
+     */
+    void unlinkNode(BddRef node);
+
+    /**
+     * @brief Снимает ссылку родителя и удаляет узлы, на которые не осталось ссылок.
+     * @param node Ссылка на ветвь.
+     */
+    void releaseBranch(BddRef node);
+
+    /**
+     * @brief Меняет местами переменные соседних уровней.
+     *
+     * Узел f = (x, f0, f1), у которого есть ветвь с переменной y следующего уровня, переписывается на месте
+     * в (y, (x, f00, f10), (x, f01, f11)); остальные узлы x только опускаются на уровень. Узлы y, на которые
+     * не осталось ссылок, сразу удаляются, поэтому число живых узлов остается точным.
+     * @param level Верхний из двух уровней.
+     */
+    void swapLevels(uint32_t level);
+
+    /**
+     * @brief Проводит переменную через все уровни и оставляет на уровне с наименьшим числом узлов.
+     * @param var Номер переменной.
+     */
+    void siftVariable(uint32_t var);
+
+    /**
+     * @brief Удваивает число цепочек таблицы переменной.
+     * @param table Таблица уникальных узлов.
+     */
+    void rehash(Subtable& table);
+
+    /**
+     * @brief Вычисляет ite без сборки мусора.
+     *
+     * Глубина рекурсии не превышает числа переменных.
+     * @param f Условие.
+     * @param g Значение при истинном условии.
+     * @param h Значение при ложном условии.
+     * @return Ссылка на узел результата.
+     * @throw Error с типом bddNodeLimit, если число узлов превысило предел setNodeLimit.
+     */
+    BddRef iteStep(BddRef f, BddRef g, BddRef h);
+
+    /**
+     * @brief Возвращает положительный или отрицательный кофактор по переменной уровня.
+     * @param f Ссылка на узел.
+     * @param level Уровень переменной, не ниже уровня f.
+     * @param value Значение переменной.
+     * @return Ветвь f, если f стоит на этом уровне, иначе f.
+     */
+    BddRef cofactor(BddRef f, uint32_t level, bool value) const {
+        if (levelOfNode(f) != level) return f;
+        return value ? highs[f] : lows[f];
+    }
+
+    /**
+     * @brief Собирает мусор или просеивает переменные, если число узлов превысило порог, и увеличивает кэш вслед за числом узлов.
+     * @param f Первый операнд предстоящей операции (или nullBdd).
+     * @param g Второй операнд.
+     * @param h Третий операнд.
+     */
+    void maybeCollect(BddRef f, BddRef g, BddRef h);
+
+    std::vector<uint32_t> vars;                              ///< Номера переменных узлов.
+    std::vector<BddRef> lows;                                ///< Ветви при ложной переменной.
+    std::vector<BddRef> highs;                               ///< Ветви при истинной переменной.
+    std::vector<BddRef> nexts;                               ///< Следующие узлы цепочек (или списка свободных узлов).
+    std::vector<uint32_t> refs;                              ///< Счетчики ссылок.
+    std::vector<Symbol> names;                               ///< Имена переменных.
+    std::vector<uint32_t> levels;                            ///< Уровни переменных.
+    std::vector<uint32_t> order;                             ///< Переменные по уровням.
+    std::unordered_map<uint32_t, uint32_t> indexOfSymbol;    ///< Номера переменных по идентификаторам имен.
+    std::vector<Subtable> subtables;                         ///< Таблицы уникальных узлов по переменным.
+    std::vector<CacheEntry> cache;                           ///< Кэш операций ite.
+    BddRef freeList;                                         ///< Начало списка свободных узлов.
+    size_t liveNodes;                                        ///< Количество живых узлов, не считая констант.
+    size_t collectThreshold;                                 ///< Число узлов, при котором выполняется сборка мусора.
+    size_t reorderThreshold;                                 ///< Число узлов, при котором выполняется просеивание.
+    bool autoReorder;                                        ///< Запускать просеивание автоматически.
+    size_t reorderings;                                      ///< Количество выполненных просеиваний.
+    size_t nodeLimit;                                        ///< Наибольшее число живых узлов (SIZE_MAX — без предела).
+};
+
+/**
+ * @brief Класс нумерации переменных, общей для нескольких программ над битовыми векторами.
+ *
+ * Номера выдаются в порядке первого обращения, поэтому программы исходного и преобразованного выражений,
+ * скомпилированные с одной нумерацией, вычисляются на одних и тех же наборах значений.
+ */
+class BitVariables {
+public:
+    std::vector<Symbol> names; ///< Имена переменных по номерам.
+
+    /**
+     * @brief Возвращает номер переменной, выдавая новый при первом обращении.
+     * @param name Имя переменной.
+     * @return Номер переменной.
+     */
+    uint32_t indexOf(Symbol name) {
+        auto inserted = index.emplace(name.id, static_cast<uint32_t>(names.size()));
+        if (inserted.second) names.push_back(name);
+        return inserted.first->second;
+    }
+
+    /**
+     * @brief Возвращает количество переменных.
+     * @return Количество переменных.
+     */
+    size_t size() const {
+        return names.size();
+    }
+
+    /**
+     * @brief Удаляет все переменные, сохраняя выделенную память.
+     */
+    void clear() {
+        names.clear();
+        index.clear();
+    }
+
+private:
+    std::unordered_map<uint32_t, uint32_t> index; ///< Номера переменных по идентификаторам имен.
+};
+
+/**
+ * @brief Класс программы вычисления выражения над битовыми векторами.
+ *
+ * Команды записаны в постфиксном порядке и выполняются на стеке векторов: переменная кладет в стек вектор
+ * своих значений, операция заменяет операнды на вершине результатом. Бит k каждого вектора относится к k-му
+ * набору значений переменных, поэтому одно машинное слово вычисляет выражение сразу на 64 наборах.
+ * Поддерево, которому нужен более глубокий стек, вычисляется первым (порядок Сети — Ульмана), и глубина стека
+ * растет как логарифм размера дерева, а не как его высота.
+ */
+class BitProgram {
+public:
+    /**
+     * @brief Команда программы.
+     */
+    struct Instruction {
+        uint8_t type;      ///< Тип узла (значение TokenType).
+        uint8_t swapped;   ///< У бинарной операции правый операнд вычислен первым и лежит под левым.
+        uint32_t variable; ///< Номер переменной в BitVariables.
+    };
+
+    std::vector<Instruction> code; ///< Команды в порядке выполнения.
+    size_t stackDepth = 0;         ///< Наибольшее число векторов в стеке при выполнении.
+
+    /**
+     * @brief Удаляет все команды, сохраняя выделенную память.
+     */
+    void clear() {
+        code.clear();
+        stackDepth = 0;
+    }
+};
+
+/**
+ * @brief Класс таблицы истинности выражения.
+ *
+ * Набор значений с номером index задает переменной i значение бита i числа index. Значение выражения
+ * на наборе index хранится в бите index % 64 слова index / 64; в единственном слове таблицы меньше чем
+ * от 6 переменных старшие биты равны нулю.
+ */
+class TruthTable {
+public:
+    static constexpr size_t maxVariables = 32; ///< Наибольшее число переменных (таблица занимает 512 МБ).
+
+    std::vector<Symbol> variables; ///< Переменные в порядке первого появления в выражении.
+    std::vector<uint64_t> words;   ///< Значения выражения на всех наборах.
+    uint64_t models = 0;           ///< Количество наборов, на которых выражение истинно.
+
+    /**
+     * @brief Возвращает количество наборов значений переменных.
+     * @return 2 в степени числа переменных.
+     */
+    uint64_t size() const {
+        return 1ull << variables.size();
+    }
+
+    /**
+     * @brief Возвращает значение выражения на наборе.
+     * @param index Номер набора.
+     * @return Значение выражения.
+     */
+    bool value(uint64_t index) const {
+        return (words[index >> 6] >> (index & 63)) & 1;
+    }
+
+    /**
+     * @brief Удаляет таблицу, сохраняя выделенную память.
+     */
+    void clear() {
+        variables.clear();
+        words.clear();
+        models = 0;
+    }
 };
 
 /**
- * @brief Класс для представления узла бинарного дерева логического выражения.
+ * @brief Класс результата перебора всех наборов значений переменных.
  *
- * Хранит тип узла, значение (для переменных) и указатели на левое и правое поддеревья.
+ * Хранит только итоги перебора: количество выполняющих наборов и первые (с наименьшими номерами) выполняющий
+ * и опровергающий наборы. Нумерация наборов та же, что в TruthTable.
  */
-class ExpressionNode {
+class ModelCount {
 public:
-    TokenType type;             ///< Тип узла (переменная или операция).
-    std::string value;          ///< Значение переменной (для узлов типа Variable).
-    ExpressionNode* left;       ///< Указатель на левое поддерево.
-    ExpressionNode* right;      ///< Указатель на правое поддерево.
+    static constexpr size_t maxVariables = 40;  ///< Наибольшее число переменных.
+    static constexpr uint64_t none = ~0ull;     ///< Номер отсутствующего набора.
+
+    std::vector<Symbol> variables;     ///< Переменные в порядке первого появления в выражении.
+    uint64_t models = 0;               ///< Количество наборов, на которых выражение истинно.
+    uint64_t firstModel = none;        ///< Первый набор, на котором выражение истинно.
+    uint64_t firstCountermodel = none; ///< Первый набор, на котором выражение ложно.
 
     /**
-     * @brief Конструктор для узла с типом и значением.
-     *
-     * Создает узел с указанным типом и значением, поддеревья инициализируются как nullptr.
-     * @param t Тип узла.
-     * @param v Значение переменной (по умолчанию пустая строка).
+     * @brief Возвращает количество наборов значений переменных.
+     * @return 2 в степени числа переменных.
      */
-    ExpressionNode(TokenType t, const std::string& v = "") : type(t), value(v), left(nullptr), right(nullptr) {}
+    uint64_t size() const {
+        return 1ull << variables.size();
+    }
 
     /**
-     * @brief Конструктор для узла с типом и поддеревьями.
-     *
-     * Создает узел с указанным типом и указателями на левое и правое поддеревья.
-     * @param t Тип узла.
-     * @param l Указатель на левое поддерево.
-     * @param r Указатель на правое поддерево.
+     * @brief Проверяет, истинно ли выражение на всех наборах.
+     * @return true, если выражение — тавтология.
      */
-    ExpressionNode(TokenType t, ExpressionNode* l, ExpressionNode* r) : type(t), value(""), left(l), right(r) {}
+    bool isTautology() const {
+        return firstCountermodel == none;
+    }
 
     /**
-     * @brief Конструктор для узла с типом, значением и поддеревьями.
-     *
-     * Создает узел с указанным типом, значением и указателями на поддеревья.
-     * @param t Тип узла.
-     * @param v Значение переменной.
-     * @param l Указатель на левое поддерево.
-     * @param r Указатель на правое поддерево.
+     * @brief Проверяет, истинно ли выражение хотя бы на одном наборе.
+     * @return true, если выражение выполнимо.
      */
-    ExpressionNode(TokenType t, const std::string& v, ExpressionNode* l, ExpressionNode* r) : type(t), value(v), left(l), right(r) {}
+    bool isSatisfiable() const {
+        return firstModel != none;
+    }
 
     /**
-     * @brief Деструктор класса ExpressionNode.
-     *
-     * Рекурсивно освобождает память, занятую поддеревьями.
+     * @brief Удаляет результат, сохраняя выделенную память.
      */
-    ~ExpressionNode() {
-        delete left;
-        delete right;
+    void clear() {
+        variables.clear();
+        models = 0;
+        firstModel = none;
+        firstCountermodel = none;
     }
 };
 
@@ -119,7 +1608,12 @@ public:
         invalidVariableName,  ///< Некорректное имя переменной.
         invalidVariableChar,  ///< Некорректный символ в имени переменной.
         unsupportedOperation, ///< Неподдерживаемая логическая операция.
-        emptyFile             ///< Отсутствует выражение во входном файле.
+        emptyFile,            ///< Отсутствует выражение во входном файле.
+        unbalancedBrackets,   ///< Непарная скобка в инфиксной записи.
+        verificationFailed,   ///< Результат преобразования не равносилен исходному выражению.
+        tooManyVariables,     ///< Слишком много переменных для перебора всех наборов.
+        bddNodeLimit,         ///< Диаграмма двоичных решений превысила предел числа узлов.
+        verificationUnproven  ///< Равносильность результата исходному выражению не удалось доказать в пределах ресурсов.
     };
 
     /**
@@ -140,6 +1634,11 @@ public:
         case invalidVariableChar: return "invalidVariableChar";
         case unsupportedOperation: return "unsupportedOperation";
         case emptyFile:            return "emptyFile";
+        case unbalancedBrackets:   return "unbalancedBrackets";
+        case verificationFailed:   return "verificationFailed";
+        case tooManyVariables:     return "tooManyVariables";
+        case bddNodeLimit:         return "bddNodeLimit";
+        case verificationUnproven: return "verificationUnproven";
         default: return "Неизвестная ошибка";
         }
     }
@@ -154,8 +1653,11 @@ public:
      * Инициализирует ошибку с указанным типом и позицией, формируя соответствующее описание.
      * @param t Тип ошибки.
      * @param pos Позиция ошибки в строке (по умолчанию -1).
+     * @param detail Подробности, включаемые в описание (для verificationFailed — контрпример,
+     *               для tooManyVariables — число переменных и допустимый предел, для bddNodeLimit — предел,
+     *               для verificationUnproven — причина).
      */
-    Error(ErrorType t, int pos = -1) : type(t), position(pos) {
+    Error(ErrorType t, int pos = -1, const std::string& detail = std::string()) : type(t), position(pos) {
         switch (type) {
         case inputFile:
             description = "Неверно указан файл с входными данными. Возможно, файл не существует.";
@@ -184,6 +1686,21 @@ public:
         case emptyFile:
             description = "Отсутствует выражение во входном файле.";
             break;
+        case unbalancedBrackets:
+            description = "Во входной строке указана непарная скобка (позиция " + std::to_string(position) + ").";
+            break;
+        case verificationFailed:
+            description = "Результат преобразования не равносилен исходному выражению (контрпример: " + detail + ").";
+            break;
+        case tooManyVariables:
+            description = "Выражение содержит слишком много переменных для перебора всех наборов (" + detail + ").";
+            break;
+        case bddNodeLimit:
+            description = "Диаграмма двоичных решений превысила предел в " + detail + " узлов.";
+            break;
+        case verificationUnproven:
+            description = "Равносильность результата преобразования исходному выражению не доказана (" + detail + ").";
+            break;
         default:
             description = "Неизвестная ошибка.";
         }
@@ -192,10 +1709,11 @@ public:
     /**
      * @brief Выводит сообщение об ошибке.
      *
-     * Выводит описание ошибки в стандартный поток вывода.
+     * Выводит описание ошибки в стандартный поток вывода или в указанный поток.
+     * @param stream Поток для вывода сообщения.
      */
-    void message() const {
-        std::wcout << description.c_str() << std::endl;
+    void message(std::wostream& stream = std::wcout) const {
+        stream << description.c_str() << std::endl;
     }
 
     /**
@@ -221,4 +1739,564 @@ public:
     bool operator==(const Error& other) const {
         return type == other.type && position == other.position;
     }
+};
+
+/**
+ * @brief Перечисление вариантов выполнения преобразований.
+ *
+ * Определяет представление дерева выражения, на котором выполняются преобразования.
+ */
+enum PipelineEngine {
+    engineTree, ///< Дерево из узлов ExpressionNode, связанных указателями.
+    engineFlat, ///< Плоское дерево FlatExpression с индексами вместо указателей.
+    engineDag,  ///< Граф ExpressionDag с общими подвыражениями.
+    engineEdge  ///< Выражение EdgeExpression с отрицаниями на ребрах.
+};
+
+/**
+ * @brief Перечисление способов переноса отрицаний.
+ *
+ * Определяет, как после раскрытия импликации и эквивалентности выражение приводится к виду,
+ * в котором отрицания стоят только перед переменными.
+ */
+enum RewriteMode {
+    rewriteRounds, ///< Повторные проходы законов де Моргана до отсутствия изменений, затем удаление двойных отрицаний.
+    rewriteNnf,    ///< Один проход сверху вниз с учетом полярности, сразу строящий результат.
+    rewriteFused   ///< Один проход по исходному дереву, раскрывающий также импликацию и эквивалентность.
+};
+
+/**
+ * @brief Перечисление форм записи входных выражений.
+ */
+enum InputSyntax {
+    syntaxPostfix, ///< Постфиксная запись, операнды и операции разделены пробелами.
+    syntaxInfix    ///< Инфиксная запись со скобками и приоритетами операций, как при выводе результата.
+};
+
+/**
+ * @brief Класс для хранения параметров запуска программы.
+ *
+ * Хранит пути к входному и выходному файлам и режим обработки, заданные аргументами командной строки.
+ */
+class ProgramOptions {
+public:
+    std::string inputFile;  ///< Путь к входному файлу ("-" — стандартный ввод).
+    std::string outputFile; ///< Путь к выходному файлу ("-" — стандартный вывод).
+    bool batch;             ///< Пакетный режим: обрабатывается каждая строка входного файла.
+    PipelineEngine engine;  ///< Представление дерева, на котором выполняются преобразования.
+    RewriteMode rewrite;    ///< Способ переноса отрицаний.
+    unsigned threads;       ///< Количество потоков пакетной обработки.
+    InputSyntax syntax;     ///< Форма записи входных выражений.
+    bool verify;            ///< Проверять равносильность результата исходному выражению.
+    bool truthTable;        ///< Выводить таблицу истинности вместо преобразованного выражения.
+    bool countModels;       ///< Выводить количество выполняющих наборов вместо преобразованного выражения.
+
+    /**
+     * @brief Конструктор класса ProgramOptions.
+     *
+     * Инициализирует параметры значениями по умолчанию (обработка одного выражения).
+     */
+    ProgramOptions() : batch(false), engine(engineTree), rewrite(rewriteRounds), threads(1), syntax(syntaxPostfix), verify(false), truthTable(false), countModels(false) {}
+};
+
+/**
+ * @brief Класс для отображения входного файла в память.
+ *
+ * Отображает файл в адресное пространство процесса только для чтения, чтобы выражения
+ * разбирались прямо из отображенной области без копирования. Отображение освобождается в деструкторе.
+ */
+class MappedFile {
+public:
+    /**
+     * @brief Конструктор класса MappedFile.
+     *
+     * Открывает файл и отображает его содержимое в память.
+     * @param filePath Путь к файлу.
+     * @throw Error с типом inputFile, если файл не удалось открыть или отобразить.
+     */
+    explicit MappedFile(const std::string& filePath);
+
+    /**
+     * @brief Деструктор класса MappedFile.
+     *
+     * Освобождает отображение и закрывает файл.
+     */
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    /**
+     * @brief Возвращает содержимое файла.
+     * @return Представление отображенной области (пустое для пустого файла).
+     */
+    std::string_view view() const { return std::string_view(data, size); }
+
+private:
+    const char* data;     ///< Начало отображенной области.
+    size_t size;          ///< Размер файла в байтах.
+#ifdef _WIN32
+    void* fileHandle;     ///< Дескриптор файла.
+    void* mappingHandle;  ///< Дескриптор отображения.
+#endif
+};
+
+/**
+ * @brief Класс пула рабочих потоков.
+ *
+ * Выполняет задачи из общей очереди в фиксированном наборе потоков. Результат задачи
+ * ожидается через std::future, возвращаемый при ее добавлении. Деструктор дожидается
+ * выполнения всех добавленных задач.
+ */
+class ThreadPool {
+public:
+    /**
+     * @brief Конструктор класса ThreadPool.
+     * @param count Количество рабочих потоков.
+     */
+    explicit ThreadPool(unsigned count) : stopping(false) {
+        for (unsigned i = 0; i < count; ++i) {
+            workers.emplace_back([this]() { run(); });
+        }
+    }
+
+    /**
+     * @brief Деструктор класса ThreadPool.
+     *
+     * Дожидается выполнения очереди и завершает рабочие потоки.
+     */
+    ~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        available.notify_all();
+        for (auto& worker : workers) {
+            worker.join();
+        }
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    /**
+     * @brief Добавляет задачу в очередь.
+     * @param task Задача.
+     * @return Объект ожидания завершения задачи; исключение задачи передается через него.
+     */
+    std::future<void> submit(std::function<void()> task) {
+        auto packaged = std::make_shared<std::packaged_task<void()>>(std::move(task));
+        std::future<void> result = packaged->get_future();
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            tasks.emplace_back([packaged]() { (*packaged)(); });
+        }
+        available.notify_one();
+        return result;
+    }
+
+private:
+    /**
+     * @brief Цикл рабочего потока: извлекает и выполняет задачи до остановки пула.
+     */
+    void run() {
+        while (true) {
+            std::function<void()> task;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                available.wait(lock, [this]() { return stopping || !tasks.empty(); });
+                if (tasks.empty()) return;
+
+                task = std::move(tasks.front());
+                tasks.pop_front();
+            }
+            task();
+        }
+    }
+
+    std::vector<std::thread> workers;          ///< Рабочие потоки.
+    std::deque<std::function<void()>> tasks;   ///< Очередь задач.
+    std::mutex mutex;                          ///< Защита очереди.
+    std::condition_variable available;         ///< Сигнал о появлении задачи или остановке.
+    bool stopping;                             ///< Пул останавливается.
+};
+
+/**
+ * @brief Класс пула потоков с перехватом задач для вычислений по схеме fork-join.
+ *
+ * У каждого потока своя двусторонняя очередь задач: поток добавляет и забирает задачи с конца своей
+ * очереди, а простаивающие потоки перехватывают самые ранние (самые крупные) задачи с начала чужих очередей.
+ * Поток, ожидающий завершения задачи, выполняет другие задачи, а при их отсутствии засыпает до завершения своей. Поток, вызвавший invoke
+ * вне пула, участвует в вычислениях как еще один рабочий поток, поэтому пул из count потоков создает
+ * count - 1 рабочих потоков. Одновременно пулом может пользоваться только один внешний поток.
+ */
+class ForkJoinPool {
+public:
+    /**
+     * @brief Конструктор класса ForkJoinPool.
+     * @param count Общее количество потоков вычислений, включая вызывающий.
+     */
+    explicit ForkJoinPool(unsigned count) : queues(count < 1 ? 1 : count), queued(0), stopping(false) {
+        for (unsigned i = 1; i < queues.size(); ++i) {
+            workers.emplace_back([this, i]() { run(i); });
+        }
+    }
+
+    /**
+     * @brief Деструктор класса ForkJoinPool.
+     *
+     * Завершает рабочие потоки. К этому моменту все задачи уже выполнены, так как invoke дожидается своих задач.
+     */
+    ~ForkJoinPool() {
+        {
+            std::lock_guard<std::mutex> lock(sleepMutex);
+            stopping = true;
+        }
+        wakeUp.notify_all();
+        for (auto& worker : workers) {
+            worker.join();
+        }
+    }
+
+    ForkJoinPool(const ForkJoinPool&) = delete;
+    ForkJoinPool& operator=(const ForkJoinPool&) = delete;
+
+    /**
+     * @brief Возвращает общее количество потоков вычислений.
+     * @return Количество потоков, включая вызывающий.
+     */
+    unsigned size() const {
+        return static_cast<unsigned>(queues.size());
+    }
+
+    /**
+     * @brief Возвращает количество задач, ожидающих выполнения во всех очередях.
+     *
+     * Пока очереди не пусты, простаивающим потокам есть что перехватить, и новые задачи создавать не нужно.
+     * @return Количество задач (значение может устареть к моменту использования).
+     */
+    size_t pendingTasks() const {
+        return queued.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Выполняет две задачи параллельно и дожидается обеих.
+     *
+     * Первая задача становится доступной для перехвата, вторая выполняется в текущем потоке. Если первую
+     * задачу никто не перехватил, она выполняется в текущем потоке вслед за второй. Исключение любой
+     * из задач передается вызывающему после завершения обеих.
+     * @param first Задача, доступная для перехвата.
+     * @param second Задача, выполняемая в текущем потоке.
+     */
+    void invoke(const std::function<void()>& first, const std::function<void()>& second) {
+        if (queues.size() == 1) {
+            first();
+            second();
+            return;
+        }
+
+        Task task(first);
+        unsigned self = currentIndex();
+        push(self, &task);
+
+        std::exception_ptr error;
+        try {
+            second();
+        }
+        catch (...) {
+            error = std::current_exception();
+        }
+
+        // Ожидание первой задачи с выполнением других задач
+        while (!task.done.load(std::memory_order_acquire)) {
+            Task* next = take(self);
+            if (next) {
+                execute(next);
+                continue;
+            }
+
+            // Задачу выполняет другой поток, а свободных задач нет
+            std::unique_lock<std::mutex> lock(sleepMutex);
+            wakeUp.wait(lock, [this, &task]() { return task.done.load(std::memory_order_acquire) || queued > 0; });
+        }
+
+        if (error) std::rethrow_exception(error);
+        if (task.error) std::rethrow_exception(task.error);
+    }
+
+private:
+    /**
+     * @brief Задача, доступная для перехвата.
+     */
+    struct Task {
+        explicit Task(const std::function<void()>& work) : work(work), done(false) {}
+
+        const std::function<void()>& work; ///< Выполняемая функция.
+        std::exception_ptr error;          ///< Исключение, выброшенное функцией.
+        std::atomic<bool> done;            ///< Задача выполнена.
+    };
+
+    /**
+     * @brief Очередь задач одного потока.
+     */
+    struct Queue {
+        std::deque<Task*> tasks; ///< Задачи в порядке добавления.
+        std::mutex mutex;        ///< Защита очереди.
+    };
+
+    /**
+     * @brief Возвращает номер очереди текущего потока.
+     * @return Номер очереди рабочего потока этого пула или 0 для внешнего потока.
+     */
+    unsigned currentIndex() const {
+        return current().first == this ? current().second : 0;
+    }
+
+    /**
+     * @brief Возвращает пул и номер очереди, к которым относится текущий поток.
+     * @return Ссылка на пару (пул, номер очереди).
+     */
+    static std::pair<const ForkJoinPool*, unsigned>& current() {
+        thread_local std::pair<const ForkJoinPool*, unsigned> worker(nullptr, 0);
+        return worker;
+    }
+
+    /**
+     * @brief Добавляет задачу в конец очереди потока и будит простаивающий поток.
+     * @param index Номер очереди.
+     * @param task Задача.
+     */
+    void push(unsigned index, Task* task) {
+        {
+            std::lock_guard<std::mutex> lock(queues[index].mutex);
+            queues[index].tasks.push_back(task);
+        }
+        {
+            std::lock_guard<std::mutex> lock(sleepMutex);
+            queued++;
+        }
+        wakeUp.notify_one();
+    }
+
+    /**
+     * @brief Забирает задачу: последнюю из своей очереди или первую из чужой.
+     * @param index Номер очереди текущего потока.
+     * @return Задача или nullptr, если все очереди пусты.
+     */
+    Task* take(unsigned index) {
+        size_t count = queues.size();
+        for (size_t i = 0; i < count; ++i) {
+            Queue& queue = queues[(index + i) % count];
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            if (queue.tasks.empty()) continue;
+
+            Task* task;
+            if (i == 0) {
+                task = queue.tasks.back();
+                queue.tasks.pop_back();
+            }
+            else {
+                task = queue.tasks.front();
+                queue.tasks.pop_front();
+            }
+            queued--;
+            return task;
+        }
+        return nullptr;
+    }
+
+    /**
+     * @brief Выполняет задачу, отмечает ее завершение и будит ожидающие потоки.
+     * @param task Задача.
+     */
+    void execute(Task* task) {
+        try {
+            task->work();
+        }
+        catch (...) {
+            task->error = std::current_exception();
+        }
+        {
+            std::lock_guard<std::mutex> lock(sleepMutex);
+            task->done.store(true, std::memory_order_release);
+        }
+        wakeUp.notify_all();
+    }
+
+    /**
+     * @brief Цикл рабочего потока: выполняет и перехватывает задачи до остановки пула.
+     * @param index Номер очереди потока.
+     */
+    void run(unsigned index) {
+        current() = std::make_pair(this, index);
+
+        while (true) {
+            Task* task = take(index);
+            if (task) {
+                execute(task);
+                continue;
+            }
+
+            std::unique_lock<std::mutex> lock(sleepMutex);
+            wakeUp.wait(lock, [this]() { return stopping || queued > 0; });
+            if (stopping) return;
+        }
+    }
+
+    std::vector<Queue> queues;           ///< Очереди задач потоков (0 — очередь внешнего потока).
+    std::vector<std::thread> workers;    ///< Рабочие потоки.
+    std::atomic<size_t> queued;          ///< Количество задач во всех очередях.
+    std::mutex sleepMutex;               ///< Защита ожидания простаивающих потоков.
+    std::condition_variable wakeUp;      ///< Сигнал о появлении задачи или остановке.
+    bool stopping;                       ///< Пул останавливается.
+};
+
+/**
+ * @brief Класс построчного чтения входного потока.
+ *
+ * Используется, когда вход нельзя отобразить в память (стандартный ввод, канал). Читает поток
+ * блоками по chunkSize байт и выдает строки как представления внутреннего буфера без копирования.
+ * Строка длиннее буфера увеличивает его. Чтение не ждет заполнения всего блока, поэтому строки
+ * из канала обрабатываются по мере поступления.
+ */
+class LineReader {
+public:
+    static const size_t chunkSize = 1 << 16; ///< Начальный размер буфера в байтах.
+
+    /**
+     * @brief Конструктор класса LineReader.
+     * @param fileDescriptor Дескриптор открытого для чтения файла.
+     */
+    explicit LineReader(int fileDescriptor) : descriptor(fileDescriptor), buffer(chunkSize), begin(0), end(0), finished(false) {}
+
+    /**
+     * @brief Возвращает очередную строку без завершающего перевода строки.
+     *
+     * Представление действительно до следующего вызова next().
+     * @param [out] line Очередная строка.
+     * @return true, если строка прочитана, false в конце потока.
+     * @throw Error с типом inputFile, если чтение не удалось.
+     */
+    bool next(std::string_view& line);
+
+    /**
+     * @brief Проверяет, потребуется ли чтение из потока для получения следующей строки.
+     * @return true, если в буфере нет полной строки и поток не закончился.
+     */
+    bool needsRead() const {
+        return !finished && std::memchr(buffer.data() + begin, '\n', end - begin) == nullptr;
+    }
+
+private:
+    int descriptor;           ///< Дескриптор файла.
+    std::vector<char> buffer; ///< Прочитанные данные.
+    size_t begin;             ///< Начало непрочитанной части буфера.
+    size_t end;               ///< Конец прочитанных данных.
+    bool finished;            ///< Достигнут конец потока.
+};
+
+/**
+ * @brief Класс буферизованной записи в выходной файл.
+ *
+ * Накапливает данные в буфере размером bufferSize и передает их в файл крупными блоками,
+ * поэтому результат можно выводить прямо при обходе дерева, не собирая его в одну строку.
+ * Фрагменты длиннее буфера записываются напрямую. Файл открывается в текстовом режиме,
+ * как и прежде при записи через std::ofstream.
+ */
+class OutputWriter {
+public:
+    static const size_t bufferSize = 1 << 20; ///< Размер буфера в байтах.
+
+    /**
+     * @brief Конструктор класса OutputWriter.
+     *
+     * Открывает (создает или очищает) файл для записи. При отложенном открытии файл открывается
+     * при первой записи в него, поэтому не создается, если ничего не было выведено.
+     * Путь "-" означает стандартный вывод; он не закрывается при закрытии объекта.
+     * @param filePath Путь к файлу.
+     * @param openNow Открыть файл сразу.
+     * @throw Error с типом outputFile, если файл не удалось открыть.
+     */
+    explicit OutputWriter(const std::string& filePath, bool openNow = true) : path(filePath), file(nullptr) {
+        buffer.reserve(bufferSize);
+        if (openNow) ensureOpen();
+    }
+
+    /**
+     * @brief Деструктор класса OutputWriter.
+     *
+     * Записывает остаток буфера и закрывает файл. Ошибки записи в деструкторе не сообщаются,
+     * для их обнаружения следует вызывать close().
+     */
+    ~OutputWriter();
+
+    OutputWriter(const OutputWriter&) = delete;
+    OutputWriter& operator=(const OutputWriter&) = delete;
+
+    /**
+     * @brief Записывает содержимое буфера в файл.
+     * @throw Error с типом outputFile, если запись не удалась.
+     */
+    void flush();
+
+    /**
+     * @brief Записывает остаток буфера и закрывает файл.
+     * @throw Error с типом outputFile, если запись не удалась.
+     */
+    void close();
+
+    /**
+     * @brief Дописывает фрагмент текста.
+     * @param text Фрагмент.
+     * @return Ссылка на объект записи.
+     */
+    OutputWriter& operator+=(std::string_view text) {
+        if (text.size() > bufferSize - buffer.size()) {
+            flush();
+            if (text.size() >= bufferSize) {
+                writeDirect(text);
+                return *this;
+            }
+        }
+        buffer.append(text.data(), text.size());
+        return *this;
+    }
+
+    /**
+     * @brief Дописывает строку с завершающим нулем.
+     * @param text Строка.
+     * @return Ссылка на объект записи.
+     */
+    OutputWriter& operator+=(const char* text) {
+        return *this += std::string_view(text);
+    }
+
+    /**
+     * @brief Дописывает символ.
+     * @param c Символ.
+     * @return Ссылка на объект записи.
+     */
+    OutputWriter& operator+=(char c) {
+        if (buffer.size() == bufferSize) flush();
+        buffer.push_back(c);
+        return *this;
+    }
+
+private:
+    /**
+     * @brief Открывает файл, если он еще не открыт.
+     * @throw Error с типом outputFile, если файл не удалось открыть.
+     */
+    void ensureOpen();
+
+    /**
+     * @brief Записывает фрагмент в файл, минуя буфер.
+     * @param text Фрагмент.
+     * @throw Error с типом outputFile, если запись не удалась.
+     */
+    void writeDirect(std::string_view text);
+
+    std::string path;   ///< Путь к файлу.
+    std::FILE* file;    ///< Открытый файл.
+    std::string buffer; ///< Накопленные данные.
 };
\ No newline at end of file
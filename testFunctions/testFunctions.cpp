@@ -86,6 +86,31 @@ bool compareErrorSets(const std::set<Error>& expected, const std::set<Error>& ac
     return false;
 }
 
+/**
+ * @brief Сравнивает два вектора токенов и выводит первое различие
+ * @param [in] expected Ожидаемый вектор токенов
+ * @param [in] actual Фактический вектор токенов
+ * @return true если векторы идентичны, false в противном случае
+ */
+bool compareTokenVectors(const std::vector<Token>& expected, const std::vector<Token>& actual)
+{
+    if (expected.size() != actual.size()) {
+        Logger::WriteMessage((L"Количество токенов не совпадает: ожидалось " + std::to_wstring(expected.size()) +
+            L", получено " + std::to_wstring(actual.size())).c_str());
+        return false;
+    }
+
+    for (size_t i = 0; i < expected.size(); i++) {
+        if (expected[i].type != actual[i].type || expected[i].value != actual[i].value || expected[i].position != actual[i].position) {
+            Logger::WriteMessage((L"Токен " + std::to_wstring(i) + L" не совпадает: '" +
+                std::wstring(actual[i].value.begin(), actual[i].value.end()) + L"' на позиции " + std::to_wstring(actual[i].position)).c_str());
+            return false;
+        }
+    }
+
+    return true;
+}
+
 /**
  * @brief Рекурсивно проверяет соответствие двух узлов и выводит путь при несоответствии
  * @param [in] original Оригинальный узел
@@ -26,6 +26,14 @@ bool compareExpressionTrees(const ExpressionNode* expected, const ExpressionNode
  */
 bool compareErrorSets(const std::set<Error>& expected, const std::set<Error>& actual);
 
+/**
+ * @brief Сравнивает два вектора токенов и выводит первое различие
+ * @param [in] expected Ожидаемый вектор токенов
+ * @param [in] actual Фактический вектор токенов
+ * @return true если векторы идентичны, false в противном случае
+ */
+bool compareTokenVectors(const std::vector<Token>& expected, const std::vector<Token>& actual);
+
 /**
  * @brief Рекурсивно проверяет соответствие двух узлов и выводит путь при несоответствии
  * @param [in] original Оригинальный узел
@@ -0,0 +1,188 @@
+/**
+ * @file test_bdd.cpp
+ * @brief Юнит-тесты для диаграмм двоичных решений: канонической формы, сборки мусора и обратного преобразования.
+ */
+
+#include "pch.h"
+#include "CppUnitTest.h"
+#include "../simpleLogicExpression/functions.h"
+#include "../simpleLogicExpression/objects.h"
+#include "testFunctions.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace testBdd
+{
+    /**
+     * @brief Строит диаграмму выражения в постфиксной записи.
+     * @param manager Менеджер диаграмм.
+     * @param expression Выражение в постфиксной записи.
+     * @return Ссылка на корень диаграммы.
+     */
+    static BddRef build(BddManager& manager, const std::string& expression) {
+        std::set<Error> errors;
+        ExpressionNode* tree = parsePostfixExpression(expression, errors);
+        Assert::IsTrue(errors.empty());
+        BddRef result = buildBdd(manager, tree);
+        delete tree;
+        return result;
+    }
+
+    TEST_CLASS(testBdd)
+    {
+    public:
+        /**
+         * @brief Тест 1: Каноническая форма.
+         * @details Проверяет, что равносильные выражения строят одну и ту же диаграмму, а неравносильные — разные.
+         */
+        TEST_METHOD(Test1_EquivalentExpressionsShareRoot)
+        {
+            BddManager manager;
+            BddRef implication = build(manager, "a b >");
+            manager.ref(implication);
+            BddRef disjunction = build(manager, "a ! b |");
+            manager.ref(disjunction);
+            BddRef equivalence = build(manager, "a b ~");
+            manager.ref(equivalence);
+            BddRef expanded = build(manager, "a b & a ! b ! & |");
+
+            Assert::IsTrue(BddManager::areEquivalent(implication, disjunction));
+            Assert::IsTrue(BddManager::areEquivalent(equivalence, expanded));
+            Assert::IsFalse(BddManager::areEquivalent(implication, equivalence));
+            Assert::AreEqual(static_cast<size_t>(3), manager.size(equivalence));
+        }
+
+        /**
+         * @brief Тест 2: Тождественная истинность и выполнимость.
+         * @details Проверяет, что тавтология сводится к константе «истина», а противоречие — к константе «ложь».
+         */
+        TEST_METHOD(Test2_TautologyAndContradiction)
+        {
+            BddManager manager;
+            BddRef tautology = build(manager, "a b > a & b >");
+            Assert::IsTrue(BddManager::isTautology(tautology));
+
+            BddRef contradiction = build(manager, "a b & a ! &");
+            Assert::AreEqual(bddFalse, contradiction);
+            Assert::IsFalse(BddManager::isSatisfiable(contradiction));
+
+            BddRef variable = build(manager, "a");
+            Assert::IsFalse(BddManager::isTautology(variable));
+            Assert::IsTrue(BddManager::isSatisfiable(variable));
+        }
+
+        /**
+         * @brief Тест 3: Количество выполняющих наборов.
+         * @details Проверяет подсчет по всем переменным менеджера, включая переменные, от которых функция не зависит.
+         */
+        TEST_METHOD(Test3_SatCount)
+        {
+            BddManager manager;
+            BddRef function = build(manager, "a b & c |");
+            Assert::AreEqual(5.0, manager.satCount(function));
+            Assert::AreEqual(8.0, manager.satCount(bddTrue));
+            Assert::AreEqual(0.0, manager.satCount(bddFalse));
+
+            BddRef equivalence = build(manager, "a b ~");
+            Assert::AreEqual(4.0, manager.satCount(equivalence));
+        }
+
+        /**
+         * @brief Тест 4: Сборка мусора.
+         * @details Проверяет, что сборка удаляет только незащищенные узлы, а освобожденные узлы используются повторно.
+         */
+        TEST_METHOD(Test4_GarbageCollection)
+        {
+            BddManager manager;
+            BddRef kept = build(manager, "a b & c &");
+            manager.ref(kept);
+            build(manager, "a b ~ c ~ d ~");
+            size_t before = manager.nodeCount();
+
+            manager.collectGarbage();
+            Assert::AreEqual(manager.size(kept), manager.nodeCount());
+            Assert::IsTrue(manager.nodeCount() < before);
+
+            // Повторное построение дает ту же каноническую форму в освобожденных узлах
+            BddRef rebuilt = build(manager, "c b a & &");
+            Assert::AreEqual(kept, rebuilt);
+            BddRef parity = build(manager, "a b ~ c ~ d ~");
+            Assert::AreEqual(static_cast<size_t>(7), manager.size(parity));
+            Assert::AreEqual(8.0, manager.satCount(parity));
+
+            manager.deref(kept);
+            manager.collectGarbage();
+            Assert::AreEqual(static_cast<size_t>(0), manager.nodeCount());
+        }
+
+        /**
+         * @brief Тест 5: Обратное преобразование в дерево.
+         * @details Проверяет вид дерева по разложению Шеннона и то, что по нему строится та же диаграмма.
+         */
+        TEST_METHOD(Test5_BddToExpression)
+        {
+            BddManager manager;
+            BddRef function = build(manager, "a b > c &");
+            manager.ref(function);
+
+            ExpressionNode* tree = bddToExpression(manager, function);
+            Assert::AreEqual(std::string("a & b & c || !a & c"), expressionTreeToInfix(tree));
+            Assert::AreEqual(function, buildBdd(manager, tree));
+            delete tree;
+
+            ExpressionNode* falseTree = bddToExpression(manager, bddFalse);
+            Assert::AreEqual(std::string("a & !a"), expressionTreeToInfix(falseTree));
+            delete falseTree;
+
+            BddManager empty;
+            Assert::IsTrue(bddToExpression(empty, bddTrue) == nullptr);
+        }
+
+        /**
+         * @brief Тест 6: Порядок переменных.
+         * @details Проверяет, что переменные получают уровни в порядке первого вхождения в выражение.
+         */
+        TEST_METHOD(Test6_VariableOrder)
+        {
+            BddManager manager;
+            BddRef function = build(manager, "y x & z |");
+
+            Assert::AreEqual(static_cast<size_t>(3), manager.variableCount());
+            Assert::IsTrue(manager.variableName(manager.variableAt(0)) == Symbol("y"));
+            Assert::IsTrue(manager.variableName(manager.variableAt(2)) == Symbol("z"));
+            Assert::IsTrue(manager.variableName(manager.variableOf(function)) == Symbol("y"));
+        }
+
+        /**
+         * @brief Тест 7: Предел числа узлов.
+         * @details Проверяет, что операция, превысившая предел, выбрасывает ошибку bddNodeLimit,
+         *          а менеджер остается пригодным для операций в пределах предела.
+         */
+        TEST_METHOD(Test7_NodeLimit)
+        {
+            BddManager manager;
+            manager.setNodeLimit(4);
+            BddRef a = manager.variable(Symbol("a"));
+            manager.ref(a);
+            BddRef b = manager.variable(Symbol("b"));
+            manager.ref(b);
+
+            BddRef conjunction = manager.apply(TokenType::And, a, b);
+            Assert::AreEqual(static_cast<size_t>(3), manager.nodeCount());
+            manager.ref(conjunction);
+
+            bool thrown = false;
+            try {
+                manager.apply(TokenType::Equivalence, conjunction, manager.variable(Symbol("c")));
+            }
+            catch (const Error& e) {
+                thrown = e.type == Error::bddNodeLimit;
+            }
+            Assert::IsTrue(thrown);
+
+            manager.setNodeLimit(SIZE_MAX);
+            BddRef same = manager.apply(TokenType::And, b, a);
+            Assert::IsTrue(BddManager::areEquivalent(conjunction, same));
+        }
+    };
+}
\ No newline at end of file
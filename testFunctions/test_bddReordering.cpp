@@ -0,0 +1,147 @@
+/**
+ * @file test_bddReordering.cpp
+ * @brief Юнит-тесты для порядка переменных диаграмм двоичных решений: просеивания и статической эвристики.
+ */
+
+#include "pch.h"
+#include "CppUnitTest.h"
+#include "../simpleLogicExpression/functions.h"
+#include "../simpleLogicExpression/objects.h"
+#include "testFunctions.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace testBddReordering
+{
+    /**
+     * @brief Создает выражение (a0 ~ b0) & (a1 ~ b1) & ... в постфиксной записи.
+     * @param count Количество пар переменных.
+     * @return Выражение в постфиксной записи.
+     */
+    static std::string makeComparator(int count) {
+        std::string expression;
+        for (int i = 0; i < count; i++) {
+            expression += "a" + std::to_string(i) + " b" + std::to_string(i) + " ~ ";
+            if (i > 0) expression += "& ";
+        }
+        return expression;
+    }
+
+    /**
+     * @brief Добавляет в менеджер переменные a0..a(count-1), затем b0..b(count-1).
+     * @param manager Менеджер диаграмм.
+     * @param count Количество пар переменных.
+     */
+    static void declareSeparated(BddManager& manager, int count) {
+        for (int i = 0; i < count; i++) manager.variableIndex("a" + std::to_string(i));
+        for (int i = 0; i < count; i++) manager.variableIndex("b" + std::to_string(i));
+    }
+
+    /**
+     * @brief Строит диаграмму выражения в постфиксной записи.
+     * @param manager Менеджер диаграмм.
+     * @param expression Выражение в постфиксной записи.
+     * @return Ссылка на корень диаграммы.
+     */
+    static BddRef build(BddManager& manager, const std::string& expression) {
+        std::set<Error> errors;
+        ExpressionNode* tree = parsePostfixExpression(expression, errors);
+        Assert::IsTrue(errors.empty());
+        BddRef result = buildBdd(manager, tree);
+        delete tree;
+        return result;
+    }
+
+    TEST_CLASS(testBddReordering)
+    {
+    public:
+        /**
+         * @brief Тест 1: Просеивание сравнения двух чисел.
+         * @details Проверяет, что при раздельном порядке диаграмма экспоненциальна, а после просеивания — линейна.
+         */
+        TEST_METHOD(Test1_SiftingShrinksComparator)
+        {
+            BddManager manager;
+            manager.setAutoReorder(false);
+            declareSeparated(manager, 6);
+            BddRef function = build(manager, makeComparator(6));
+            manager.ref(function);
+            Assert::AreEqual(static_cast<size_t>(189), manager.size(function));
+
+            manager.reorder();
+            Assert::AreEqual(static_cast<size_t>(18), manager.size(function));
+            Assert::AreEqual(static_cast<size_t>(18), manager.nodeCount());
+            Assert::AreEqual(64.0, manager.satCount(function));
+        }
+
+        /**
+         * @brief Тест 2: Ссылки после просеивания.
+         * @details Проверяет, что защищенная ссылка после просеивания задает ту же функцию и совпадает с новым построением.
+         */
+        TEST_METHOD(Test2_ReferencesSurviveReordering)
+        {
+            BddManager manager;
+            manager.setAutoReorder(false);
+            declareSeparated(manager, 3);
+            BddRef function = build(manager, makeComparator(3) + "a0 b2 | &");
+            manager.ref(function);
+            double models = manager.satCount(function);
+
+            manager.reorder();
+            Assert::AreEqual(models, manager.satCount(function));
+            Assert::AreEqual(function, build(manager, "a0 b2 | " + makeComparator(3) + "&"));
+
+            ExpressionNode* tree = bddToExpression(manager, function);
+            Assert::AreEqual(function, buildBdd(manager, tree));
+            delete tree;
+        }
+
+        /**
+         * @brief Тест 3: Автоматическое просеивание.
+         * @details Проверяет, что при превышении порога числа узлов просеивание запускается само и диаграмма остается верной.
+         */
+        TEST_METHOD(Test3_AutomaticReordering)
+        {
+            BddManager manager;
+            declareSeparated(manager, 14);
+            BddRef function = build(manager, makeComparator(14));
+
+            Assert::IsTrue(manager.reorderCount() > 0);
+            Assert::IsTrue(manager.size(function) < 1000);
+            Assert::AreEqual(16384.0, manager.satCount(function));
+        }
+
+        /**
+         * @brief Тест 4: Статический порядок переменных.
+         * @details Проверяет, что эвристика сводит вместе переменные одной операции, разнесенные порядком первого вхождения.
+         */
+        TEST_METHOD(Test4_StaticOrderInterleavesPairs)
+        {
+            std::set<Error> errors;
+            std::string expression = "a0 a1 | a2 | a3 | a4 | " + makeComparator(5) + "&";
+            ExpressionNode* tree = parsePostfixExpression(expression, errors);
+            Assert::IsTrue(errors.empty());
+
+            std::vector<Symbol> order = staticVariableOrder(tree);
+            Assert::AreEqual(static_cast<size_t>(10), order.size());
+            for (size_t i = 0; i < order.size(); i += 2) {
+                std::string first = order[i].name();
+                std::string second = order[i + 1].name();
+                Assert::AreEqual(first.substr(1), second.substr(1));
+            }
+
+            BddManager firstAppearance;
+            firstAppearance.setAutoReorder(false);
+            BddRef unordered = buildBdd(firstAppearance, tree);
+
+            BddManager heuristic;
+            heuristic.setAutoReorder(false);
+            for (const Symbol& name : order) heuristic.variableIndex(name);
+            BddRef ordered = buildBdd(heuristic, tree);
+
+            Assert::IsTrue(heuristic.size(ordered) < firstAppearance.size(unordered));
+            Assert::AreEqual(firstAppearance.satCount(unordered), heuristic.satCount(ordered));
+            delete tree;
+        }
+    };
+}
\ No newline at end of file
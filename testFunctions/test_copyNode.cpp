@@ -551,5 +551,26 @@ namespace testcopyNode
             delete node;
             delete copiedNode;
         }
+
+        /**
+         * @brief Тест 31: Копирование глубокой цепочки.
+         * @details Проверяет копирование и удаление дерева глубиной 1000000 без переполнения стека вызовов.
+         */
+        TEST_METHOD(Test31_DeepChainCopy)
+        {
+            const int depth = 1000000;
+            ExpressionNode* node = new ExpressionNode(TokenType::Variable, "a");
+            for (int i = 0; i < depth; ++i) {
+                node = new ExpressionNode(TokenType::And, node, new ExpressionNode(TokenType::Variable, "b"));
+            }
+
+            ExpressionNode* copiedNode = copyNode(node);
+
+            Assert::IsTrue(copiedNode != node);
+            Assert::AreEqual(expressionTreeToInfix(node), expressionTreeToInfix(copiedNode));
+
+            delete node;
+            delete copiedNode;
+        }
     };
 }
\ No newline at end of file
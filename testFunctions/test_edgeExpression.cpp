@@ -0,0 +1,74 @@
+/**
+ * @file test_edgeExpression.cpp
+ * @brief Юнит-тесты для выражения с отрицаниями на ребрах.
+ */
+
+#include "pch.h"
+#include "CppUnitTest.h"
+#include "../simpleLogicExpression/functions.h"
+#include "../simpleLogicExpression/objects.h"
+#include "testFunctions.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace testEdgeExpression
+{
+    TEST_CLASS(testEdgeExpression)
+    {
+    public:
+        /**
+         * @brief Тест 1: Отрицания не создают узлов.
+         * @details Проверяет, что отрицание инвертирует бит ребра, а двойное отрицание возвращает исходное ребро.
+         */
+        TEST_METHOD(Test1_NegationIsEdgeBit)
+        {
+            std::set<Error> errors;
+            EdgeExpression single, triple;
+
+            Edge negated = buildExpressionTree(tokenize("a !", errors), errors, single);
+            Edge tripleNegated = buildExpressionTree(tokenize("a ! ! !", errors), errors, triple);
+
+            Assert::IsTrue(errors.empty());
+            Assert::AreEqual(static_cast<size_t>(1), single.size());
+            Assert::AreEqual(static_cast<size_t>(1), triple.size());
+            Assert::IsTrue(EdgeExpression::negated(negated));
+            Assert::AreEqual(negated, tripleNegated);
+            Assert::AreEqual(EdgeExpression::negate(negated), static_cast<Edge>(0));
+        }
+
+        /**
+         * @brief Тест 2: Законы де Моргана при выводе.
+         * @details Проверяет, что отрицание операции выводится двойственной операцией над отрицаниями операндов.
+         */
+        TEST_METHOD(Test2_DeMorganOnOutput)
+        {
+            std::set<Error> errors;
+            EdgeExpression graph;
+
+            Edge root = buildExpressionTree(tokenize("a b & ! c ! ! | !", errors), errors, graph);
+            transformImplicationAndEquivalence(graph);
+
+            Assert::IsTrue(errors.empty());
+            Assert::AreEqual(static_cast<size_t>(5), graph.size());
+            Assert::AreEqual(std::string("a & b & !c"), expressionTreeToInfix(graph, root));
+        }
+
+        /**
+         * @brief Тест 3: Раскрытие импликации и эквивалентности.
+         * @details Проверяет, что импликация не добавляет узлов, а эквивалентность добавляет два узла без копирования операндов.
+         */
+        TEST_METHOD(Test3_TransformAddsNoNegationNodes)
+        {
+            std::set<Error> errors;
+            EdgeExpression graph;
+
+            Edge root = buildExpressionTree(tokenize("a b & c d | ~ e >", errors), errors, graph);
+            size_t before = graph.size();
+            transformImplicationAndEquivalence(graph);
+
+            Assert::IsTrue(errors.empty());
+            Assert::AreEqual(static_cast<size_t>(2), graph.size() - before);
+            Assert::AreEqual(std::string("(!a || !b || !c & !d) & (a & b || c || d) || e"), expressionTreeToInfix(graph, root));
+        }
+    };
+}
\ No newline at end of file
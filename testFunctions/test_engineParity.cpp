@@ -0,0 +1,95 @@
+/**
+ * @file test_engineParity.cpp
+ * @brief Юнит-тесты совпадения результатов всех представлений выражения.
+ */
+
+#include "pch.h"
+#include "CppUnitTest.h"
+#include "../simpleLogicExpression/functions.h"
+#include "../simpleLogicExpression/objects.h"
+#include "testFunctions.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace testEngineParity
+{
+    /// Представления, сравниваемые с деревом из узлов ExpressionNode.
+    static const PipelineEngine engines[] = { engineFlat, engineDag, engineEdge };
+
+    /**
+     * @brief Сравнивает обработку выражения на дереве из узлов и на заданном представлении.
+     * @param expression Выражение в постфиксной записи.
+     * @param engine Проверяемое представление.
+     */
+    static void assertPipelinesAgree(const char* expression, PipelineEngine engine) {
+        std::string expectedInput, expectedResult, actualInput, actualResult;
+        std::set<Error> expectedErrors, actualErrors;
+        ProgramOptions options;
+        options.engine = engine;
+
+        bool expectedOk = processExpression(expression, expectedInput, expectedResult, expectedErrors);
+        bool actualOk = processExpression(expression, actualInput, actualResult, actualErrors, options);
+
+        Assert::AreEqual(expectedOk, actualOk);
+        Assert::AreEqual(expectedInput, actualInput);
+        Assert::AreEqual(expectedResult, actualResult);
+        Assert::IsTrue(compareErrorSets(expectedErrors, actualErrors));
+    }
+
+    TEST_CLASS(testEngineParity)
+    {
+    public:
+        /**
+         * @brief Тест 1: Совпадение результатов всех представлений.
+         * @details Проверяет, что плоское дерево, граф и выражение с отрицаниями на ребрах дают тот же результат, что и дерево из узлов.
+         */
+        TEST_METHOD(Test1_PipelinesAgree)
+        {
+            const char* expressions[] = {
+                "a b > !",
+                "a ! !",
+                "a b ~ c &",
+                "a a & a a & |",
+                "a b ~ c ~ d ~ !",
+                "a b c | & ! d ~",
+                "a ! ! ! b ! ! > c d ~ |",
+                "a b > c > d e ~ ~ !",
+                "a b & c & d ! | ! !"
+            };
+
+            for (PipelineEngine engine : engines) {
+                for (const char* expression : expressions) {
+                    assertPipelinesAgree(expression, engine);
+                }
+            }
+        }
+
+        /**
+         * @brief Тест 2: Совпадение ошибок построения всех представлений.
+         * @details Проверяет, что ошибки построения каждого представления совпадают с ошибками построения дерева из узлов.
+         */
+        TEST_METHOD(Test2_BuildErrorsAgree)
+        {
+            const char* expressions[] = {
+                "a | b",
+                "& a b",
+                "! a b",
+                "a b",
+                "a b & |"
+            };
+
+            for (PipelineEngine engine : engines) {
+                for (const char* expression : expressions) {
+                    std::string input, result;
+                    std::set<Error> errors;
+                    ProgramOptions options;
+                    options.engine = engine;
+                    Assert::IsFalse(processExpression(expression, input, result, errors, options));
+                    Assert::IsFalse(errors.empty());
+
+                    assertPipelinesAgree(expression, engine);
+                }
+            }
+        }
+    };
+}
\ No newline at end of file
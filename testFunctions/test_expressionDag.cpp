@@ -0,0 +1,84 @@
+/**
+ * @file test_expressionDag.cpp
+ * @brief Юнит-тесты для графа выражения с общими подвыражениями.
+ */
+
+#include "pch.h"
+#include "CppUnitTest.h"
+#include "../simpleLogicExpression/functions.h"
+#include "../simpleLogicExpression/objects.h"
+#include "testFunctions.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace testExpressionDag
+{
+    TEST_CLASS(testExpressionDag)
+    {
+    public:
+        /**
+         * @brief Тест 1: Повторное создание узла.
+         * @details Проверяет, что узлы с одинаковыми полями имеют один индекс, а с разными — разные.
+         */
+        TEST_METHOD(Test1_IdenticalNodesAreShared)
+        {
+            ExpressionDag dag;
+            NodeIndex a = dag.makeNode(TokenType::Variable, "a");
+            NodeIndex b = dag.makeNode(TokenType::Variable, "b");
+            NodeIndex andNode = dag.makeNode(TokenType::And, Symbol(), a, b);
+
+            Assert::AreEqual(a, dag.makeNode(TokenType::Variable, "a"));
+            Assert::AreEqual(andNode, dag.makeNode(TokenType::And, Symbol(), a, b));
+            Assert::AreNotEqual(andNode, dag.makeNode(TokenType::And, Symbol(), b, a));
+            Assert::AreNotEqual(andNode, dag.makeNode(TokenType::Or, Symbol(), a, b));
+            Assert::AreEqual(static_cast<size_t>(5), dag.size());
+        }
+
+        /**
+         * @brief Тест 2: Раскрытие эквивалентности.
+         * @details Проверяет, что раскрытие A ~ B с составными операндами добавляет постоянное число узлов.
+         */
+        TEST_METHOD(Test2_EquivalenceAddsConstantNodes)
+        {
+            std::set<Error> errors;
+            std::vector<Token> tokens = tokenize("a b & c d | ~", errors);
+            ExpressionDag dag;
+
+            NodeIndex root = buildExpressionTree(tokens, errors, dag);
+            size_t before = dag.size();
+            root = transformImplicationAndEquivalence(dag, root);
+
+            Assert::IsTrue(errors.empty());
+            Assert::AreEqual(static_cast<size_t>(5), dag.size() - before);
+            Assert::AreEqual(std::string("a & b & (c || d) || !(a & b) & !(c || d)"), expressionTreeToInfix(dag.graph(), root));
+        }
+
+        /**
+         * @brief Тест 3: Цепочка эквивалентностей.
+         * @details Проверяет, что после всех преобразований цепочки из 30 эквивалентностей число узлов растет линейно.
+         */
+        TEST_METHOD(Test3_EquivalenceChainStaysLinear)
+        {
+            std::string expression = "v0";
+            for (int i = 1; i <= 30; ++i) {
+                expression += " v" + std::to_string(i) + " ~";
+            }
+            std::set<Error> errors;
+            std::vector<Token> tokens = tokenize(expression, errors);
+            ExpressionDag dag;
+
+            NodeIndex root = buildExpressionTree(tokens, errors, dag);
+            root = transformImplicationAndEquivalence(dag, root);
+            bool changed;
+            do {
+                changed = false;
+                root = simplifyExpression(dag, root, changed);
+            } while (changed);
+            root = removeDoubleNot(dag, root);
+
+            Assert::IsTrue(errors.empty());
+            Assert::IsTrue(root != nullNode);
+            Assert::IsTrue(dag.size() < 1000);
+        }
+    };
+}
\ No newline at end of file
@@ -431,5 +431,45 @@ namespace testExpressionTreeToInfix
 
             delete input;
         }
+
+        /**
+         * @brief Тест 20: Правоассоциативная цепочка импликаций.
+         * @details Проверяет, что правый операнд импликации с тем же приоритетом берется в скобки, а левый — нет.
+         */
+        TEST_METHOD(Test20_ImplicationChainParens)
+        {
+            ExpressionNode* input = new ExpressionNode(TokenType::Implication,
+                new ExpressionNode(TokenType::Implication,
+                    new ExpressionNode(TokenType::Variable, "a"),
+                    new ExpressionNode(TokenType::Variable, "b")),
+                new ExpressionNode(TokenType::Implication,
+                    new ExpressionNode(TokenType::Variable, "c"),
+                    new ExpressionNode(TokenType::Variable, "d")));
+
+            Assert::AreEqual(std::string("a -> b -> (c -> d)"), expressionTreeToInfix(input));
+
+            delete input;
+        }
+
+        /**
+         * @brief Тест 21: Глубокое несбалансированное дерево.
+         * @details Проверяет вывод дерева глубиной 100000 без переполнения стека вызовов.
+         */
+        TEST_METHOD(Test21_DeepSkewedTree)
+        {
+            const int depth = 100000;
+            NodeArena arena;
+            ArenaScope scope(arena);
+
+            ExpressionNode* input = new ExpressionNode(TokenType::Variable, "a");
+            for (int i = 0; i < depth; ++i) {
+                input = new ExpressionNode(TokenType::Or, input, new ExpressionNode(TokenType::Not, nullptr, new ExpressionNode(TokenType::Variable, "b")));
+            }
+
+            std::string result = expressionTreeToInfix(input);
+
+            Assert::AreEqual(static_cast<size_t>(1 + depth * 6), result.size());
+            Assert::AreEqual(std::string("a || !b || !b"), result.substr(0, 13));
+        }
     };
 }
\ No newline at end of file
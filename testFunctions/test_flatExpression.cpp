@@ -0,0 +1,113 @@
+/**
+ * @file test_flatExpression.cpp
+ * @brief Юнит-тесты для плоского представления дерева выражения.
+ */
+
+#include "pch.h"
+#include "CppUnitTest.h"
+#include "../simpleLogicExpression/functions.h"
+#include "../simpleLogicExpression/objects.h"
+#include "testFunctions.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace testFlatExpression
+{
+    TEST_CLASS(testFlatExpression)
+    {
+    public:
+        /**
+         * @brief Тест 1: Построение плоского дерева из токенов.
+         * @details Проверяет расположение узлов для выражения a b & !.
+         */
+        TEST_METHOD(Test1_BuildFromTokens)
+        {
+            std::vector<Token> tokens = {
+                Token(TokenType::Variable, "a", 0),
+                Token(TokenType::Variable, "b", 2),
+                Token(TokenType::And, "&", 4),
+                Token(TokenType::Not, "!", 6)
+            };
+            std::set<Error> errors;
+            FlatExpression tree;
+
+            NodeIndex root = buildExpressionTree(tokens, errors, tree);
+
+            Assert::IsTrue(errors.empty());
+            Assert::AreEqual(static_cast<size_t>(4), tree.size());
+            Assert::IsTrue(tree.type(root) == TokenType::Not);
+            NodeIndex andNode = tree.rights[root];
+            Assert::IsTrue(tree.type(andNode) == TokenType::And);
+            Assert::IsTrue(tree.type(tree.lefts[andNode]) == TokenType::Variable);
+            Assert::AreEqual(Symbol("a").id, tree.symbols[tree.lefts[andNode]]);
+            Assert::AreEqual(Symbol("b").id, tree.symbols[tree.rights[andNode]]);
+        }
+
+        /**
+         * @brief Тест 2: Преобразование в плоское дерево и обратно.
+         * @details Проверяет, что дерево после двух преобразований совпадает с исходным.
+         */
+        TEST_METHOD(Test2_RoundTrip)
+        {
+            ExpressionNode* expected = new ExpressionNode(TokenType::Equivalence,
+                new ExpressionNode(TokenType::Not, nullptr, new ExpressionNode(TokenType::Variable, "a")),
+                new ExpressionNode(TokenType::Implication,
+                    new ExpressionNode(TokenType::Variable, "b"),
+                    new ExpressionNode(TokenType::Variable, "c")));
+            FlatExpression tree;
+
+            NodeIndex root = toFlatExpression(expected, tree);
+            ExpressionNode* actual = fromFlatExpression(tree, root);
+
+            Assert::AreEqual(static_cast<size_t>(6), tree.size());
+            Assert::IsTrue(compareExpressionTrees(expected, actual));
+
+            delete expected;
+            delete actual;
+        }
+
+        /**
+         * @brief Тест 3: Независимость копии поддерева.
+         * @details Проверяет, что изменение копии не затрагивает исходное поддерево.
+         */
+        TEST_METHOD(Test3_CopyIsIndependent)
+        {
+            ExpressionNode* source = new ExpressionNode(TokenType::And,
+                new ExpressionNode(TokenType::Variable, "a"),
+                new ExpressionNode(TokenType::Variable, "b"));
+            FlatExpression tree;
+            NodeIndex root = toFlatExpression(source, tree);
+
+            NodeIndex copy = copyNode(tree, root);
+            tree.types[copy] = TokenType::Or;
+            tree.symbols[tree.lefts[copy]] = Symbol("c").id;
+
+            Assert::AreEqual(std::string("a & b"), expressionTreeToInfix(tree, root));
+            Assert::AreEqual(std::string("c || b"), expressionTreeToInfix(tree, copy));
+
+            delete source;
+        }
+
+        /**
+         * @brief Тест 4: Глубокое дерево.
+         * @details Проверяет, что проходы по цепочке из 100000 отрицаний не переполняют стек вызовов.
+         */
+        TEST_METHOD(Test4_DeepChain)
+        {
+            const int depth = 100000;
+            FlatExpression tree;
+            NodeIndex root = tree.addNode(TokenType::Variable, "a");
+            for (int i = 0; i < depth; ++i) {
+                root = tree.addNode(TokenType::Not, Symbol(), nullNode, root);
+            }
+
+            transformImplicationAndEquivalence(tree, root);
+            bool changed = false;
+            simplifyExpression(tree, root, changed);
+            removeDoubleNot(tree, root);
+
+            Assert::IsFalse(changed);
+            Assert::AreEqual(std::string("a"), expressionTreeToInfix(tree, root));
+        }
+    };
+}
\ No newline at end of file
@@ -0,0 +1,197 @@
+/**
+ * @file test_forkJoin.cpp
+ * @brief Юнит-тесты для параллельной обработки одного дерева по схеме fork-join.
+ */
+
+#include "pch.h"
+#include "CppUnitTest.h"
+#include "../simpleLogicExpression/functions.h"
+#include "../simpleLogicExpression/objects.h"
+#include "testFunctions.h"
+#include <stdexcept>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace testForkJoin
+{
+    /**
+     * @brief Суммирует числа диапазона, рекурсивно деля его пополам задачами пула.
+     * @param pool Пул потоков.
+     * @param from Начало диапазона.
+     * @param to Конец диапазона (не включается).
+     * @return Сумма чисел диапазона.
+     */
+    static long long parallelSum(ForkJoinPool& pool, long long from, long long to)
+    {
+        if (to - from <= 1000) {
+            long long sum = 0;
+            for (long long i = from; i < to; i++) sum += i;
+            return sum;
+        }
+
+        long long middle = (from + to) / 2;
+        long long left = 0, right = 0;
+        pool.invoke([&]() { left = parallelSum(pool, from, middle); }, [&]() { right = parallelSum(pool, middle, to); });
+        return left + right;
+    }
+
+    /**
+     * @brief Строит выражение в постфиксной записи: полное бинарное дерево заданной глубины.
+     * @param depth Глубина дерева.
+     * @param seed Начальное значение генератора операций.
+     * @return Выражение в постфиксной записи.
+     */
+    static std::string balancedExpression(int depth, unsigned seed)
+    {
+        std::string expression;
+        unsigned state = seed;
+        std::vector<std::pair<int, bool>> stack = { { depth, false } };
+
+        while (!stack.empty()) {
+            auto& top = stack.back();
+            if (top.first == 0) {
+                state = state * 1103515245u + 12345u;
+                expression += "v" + std::to_string((state >> 16) % 20) + " ";
+                stack.pop_back();
+                continue;
+            }
+            if (!top.second) {
+                top.second = true;
+                int childDepth = top.first - 1;
+                stack.push_back({ childDepth, false });
+                stack.push_back({ childDepth, false });
+                continue;
+            }
+
+            state = state * 1103515245u + 12345u;
+            const char* operations[] = { "& ", "| ", "> ", "& ! ", "| ! ", "~ " };
+            expression += operations[(state >> 16) % (top.first <= 2 ? 6 : 5)];
+            stack.pop_back();
+        }
+        return expression;
+    }
+
+    /**
+     * @brief Выполняет поэтапные преобразования дерева и возвращает результат в инфиксной форме.
+     * @param expression Выражение в постфиксной записи.
+     * @param pool Пул потоков или nullptr для последовательной обработки.
+     * @return Преобразованное выражение в инфиксной форме.
+     */
+    static std::string transformAll(const std::string& expression, ForkJoinPool* pool)
+    {
+        std::set<Error> errors;
+        ExpressionNode* tree = buildExpressionTree(tokenize(expression, errors), errors);
+        Assert::IsTrue(errors.empty());
+
+        bool changed;
+        if (pool) {
+            transformImplicationAndEquivalence(tree, *pool);
+            do {
+                changed = false;
+                simplifyExpression(tree, changed, *pool);
+            } while (changed);
+        }
+        else {
+            transformImplicationAndEquivalence(tree);
+            do {
+                changed = false;
+                simplifyExpression(tree, changed);
+            } while (changed);
+        }
+        removeDoubleNot(tree);
+
+        std::string result = expressionTreeToInfix(tree);
+        releaseExpressionTree(tree);
+        return result;
+    }
+
+    TEST_CLASS(testForkJoin)
+    {
+    public:
+        /**
+         * @brief Тест 1: Вложенные задачи.
+         * @details Проверяет, что рекурсивно порождаемые задачи выполняются ровно по одному разу.
+         */
+        TEST_METHOD(Test1_NestedInvoke)
+        {
+            ForkJoinPool pool(4);
+            long long n = 1000000;
+            Assert::AreEqual(n * (n - 1) / 2, parallelSum(pool, 0, n));
+            Assert::AreEqual(static_cast<size_t>(0), pool.pendingTasks());
+        }
+
+        /**
+         * @brief Тест 2: Исключение в задаче.
+         * @details Проверяет, что исключение перехватываемой задачи передается вызывающему после завершения обеих задач.
+         */
+        TEST_METHOD(Test2_ExceptionPropagates)
+        {
+            ForkJoinPool pool(3);
+            bool secondDone = false;
+            bool thrown = false;
+            try {
+                pool.invoke([]() { throw std::runtime_error("task"); }, [&]() { secondDone = true; });
+            }
+            catch (const std::runtime_error&) {
+                thrown = true;
+            }
+
+            Assert::IsTrue(thrown);
+            Assert::IsTrue(secondDone);
+        }
+
+        /**
+         * @brief Тест 3: Параллельное копирование.
+         * @details Проверяет, что копия большого дерева совпадает с исходным деревом.
+         */
+        TEST_METHOD(Test3_CopyMatchesSource)
+        {
+            std::set<Error> errors;
+            ExpressionNode* tree = buildExpressionTree(tokenize(balancedExpression(16, 1), errors), errors);
+            Assert::IsTrue(errors.empty());
+
+            ForkJoinPool pool(4);
+            ExpressionNode* copy = copyNode(tree, pool);
+
+            Assert::IsTrue(copy != tree);
+            Assert::AreEqual(expressionTreeToInfix(tree), expressionTreeToInfix(copy));
+
+            releaseExpressionTree(copy);
+            releaseExpressionTree(tree);
+        }
+
+        /**
+         * @brief Тест 4: Совпадение с последовательными проходами.
+         * @details Проверяет, что параллельные преобразования большого дерева дают тот же результат,
+         * что и последовательные, при разном количестве потоков.
+         */
+        TEST_METHOD(Test4_MatchesSequentialPasses)
+        {
+            std::string expression = balancedExpression(15, 7);
+            std::string expected = transformAll(expression, nullptr);
+
+            for (unsigned threads : { 1u, 2u, 4u }) {
+                ForkJoinPool pool(threads);
+                Assert::AreEqual(expected, transformAll(expression, &pool));
+            }
+        }
+
+        /**
+         * @brief Тест 5: Активный пул узлов.
+         * @details Проверяет, что при активном пуле узлов проходы выполняются последовательно и дают тот же результат.
+         */
+        TEST_METHOD(Test5_ArenaFallsBackToSequential)
+        {
+            std::string expression = balancedExpression(14, 3);
+            std::string expected = transformAll(expression, nullptr);
+
+            NodeArena arena;
+            ForkJoinPool pool(4);
+            {
+                ArenaScope scope(arena);
+                Assert::AreEqual(expected, transformAll(expression, &pool));
+            }
+            Assert::IsTrue(arena.blockCount() > 0);
+        }
+    };
+}
\ No newline at end of file
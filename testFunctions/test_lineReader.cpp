@@ -0,0 +1,102 @@
+/**
+ * @file test_lineReader.cpp
+ * @brief Юнит-тесты для построчного чтения входного потока.
+ */
+
+#include "pch.h"
+#include "CppUnitTest.h"
+#include "../simpleLogicExpression/functions.h"
+#include "../simpleLogicExpression/objects.h"
+#include "testFunctions.h"
+#include <cstdio>
+#include <fstream>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace testLineReader
+{
+    /**
+     * @brief Читает все строки файла через LineReader.
+     * @param content Содержимое, записываемое во временный файл.
+     * @return Прочитанные строки.
+     */
+    static std::vector<std::string> readLines(const std::string& content)
+    {
+        const char* path = "test_lineReader.txt";
+        {
+            std::ofstream file(path, std::ios::binary);
+            file << content;
+        }
+
+        std::vector<std::string> lines;
+        std::FILE* file = std::fopen(path, "rb");
+#ifdef _WIN32
+        LineReader reader(_fileno(file));
+#else
+        LineReader reader(fileno(file));
+#endif
+        std::string_view line;
+        while (reader.next(line)) {
+            lines.emplace_back(line);
+        }
+
+        std::fclose(file);
+        std::remove(path);
+        return lines;
+    }
+
+    TEST_CLASS(testLineReader)
+    {
+    public:
+        /**
+         * @brief Тест 1: Разбиение на строки.
+         * @details Проверяет выделение строк, включая пустые, без символов перевода строки.
+         */
+        TEST_METHOD(Test1_SplitsLines)
+        {
+            std::vector<std::string> lines = readLines("a b &\n\nc !\n");
+
+            Assert::AreEqual(static_cast<size_t>(3), lines.size());
+            Assert::AreEqual(std::string("a b &"), lines[0]);
+            Assert::AreEqual(std::string(""), lines[1]);
+            Assert::AreEqual(std::string("c !"), lines[2]);
+        }
+
+        /**
+         * @brief Тест 2: Последняя строка без перевода строки.
+         * @details Проверяет, что последняя строка возвращается и без завершающего перевода строки.
+         */
+        TEST_METHOD(Test2_LastLineWithoutNewline)
+        {
+            std::vector<std::string> lines = readLines("a\nb");
+
+            Assert::AreEqual(static_cast<size_t>(2), lines.size());
+            Assert::AreEqual(std::string("b"), lines[1]);
+        }
+
+        /**
+         * @brief Тест 3: Пустой поток.
+         * @details Проверяет, что из пустого потока не читается ни одной строки.
+         */
+        TEST_METHOD(Test3_EmptyStream)
+        {
+            Assert::IsTrue(readLines("").empty());
+        }
+
+        /**
+         * @brief Тест 4: Строки на границе блоков и длиннее буфера.
+         * @details Проверяет строки, пересекающие границу блока чтения, и строку длиннее начального буфера.
+         */
+        TEST_METHOD(Test4_LinesAcrossChunks)
+        {
+            std::string shortLine(LineReader::chunkSize - 3, 'a');
+            std::string longLine(LineReader::chunkSize * 3 + 5, 'b');
+            std::vector<std::string> lines = readLines(shortLine + "\n" + longLine + "\nc d |\n");
+
+            Assert::AreEqual(static_cast<size_t>(3), lines.size());
+            Assert::AreEqual(shortLine, lines[0]);
+            Assert::AreEqual(longLine, lines[1]);
+            Assert::AreEqual(std::string("c d |"), lines[2]);
+        }
+    };
+}
\ No newline at end of file
@@ -0,0 +1,130 @@
+/**
+ * @file test_modelCount.cpp
+ * @brief Юнит-тесты для подсчета выполняющих наборов перебором без хранения таблицы истинности.
+ */
+
+#include "pch.h"
+#include "CppUnitTest.h"
+#include "../simpleLogicExpression/functions.h"
+#include "../simpleLogicExpression/objects.h"
+#include "testFunctions.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace testModelCount
+{
+    /**
+     * @brief Создает выражение в постфиксной записи над x0..x(count-1) с неравномерно распределенными выполняющими наборами.
+     * @param count Количество переменных.
+     * @return Выражение в постфиксной записи.
+     */
+    static std::string makeExpression(int count) {
+        std::string expression = "x0";
+        for (int i = 1; i < count; i++) {
+            expression += " x" + std::to_string(i) + (i % 4 == 0 ? " >" : i % 4 == 1 ? " &" : " ~");
+        }
+        return expression + " x" + std::to_string(count - 1) + " x" + std::to_string(count - 2) + " | &";
+    }
+
+    TEST_CLASS(testModelCount)
+    {
+    public:
+        /**
+         * @brief Тест 1: Итоги для двух переменных.
+         * @details Проверяет количество и первые наборы для a & b, тавтологии и противоречия.
+         */
+        TEST_METHOD(Test1_SmallExpressions)
+        {
+            ModelCount result;
+            std::set<Error> errors;
+            Assert::IsTrue(processModelCount("a b &", result, errors));
+            Assert::AreEqual(static_cast<uint64_t>(1), result.models);
+            Assert::AreEqual(static_cast<uint64_t>(3), result.firstModel);
+            Assert::AreEqual(static_cast<uint64_t>(0), result.firstCountermodel);
+
+            Assert::IsTrue(processModelCount("a a ! |", result, errors));
+            Assert::IsTrue(result.isTautology());
+            Assert::AreEqual(static_cast<uint64_t>(2), result.models);
+
+            Assert::IsTrue(processModelCount("a a ! &", result, errors));
+            Assert::IsFalse(result.isSatisfiable());
+            Assert::AreEqual(static_cast<uint64_t>(0), result.firstCountermodel);
+        }
+
+        /**
+         * @brief Тест 2: Совпадение с таблицей истинности.
+         * @details Проверяет, что количество и первые наборы для 22 переменных совпадают с найденными по таблице.
+         */
+        TEST_METHOD(Test2_MatchesTruthTable)
+        {
+            std::string expression = makeExpression(22);
+            TruthTable table;
+            ModelCount result;
+            std::set<Error> errors;
+            Assert::IsTrue(processTruthTable(expression, table, errors));
+            Assert::IsTrue(processModelCount(expression, result, errors));
+
+            uint64_t firstModel = ModelCount::none, firstCountermodel = ModelCount::none;
+            for (uint64_t index = 0; index < table.size(); index++) {
+                if (table.value(index) && firstModel == ModelCount::none) firstModel = index;
+                if (!table.value(index) && firstCountermodel == ModelCount::none) firstCountermodel = index;
+            }
+
+            Assert::AreEqual(table.models, result.models);
+            Assert::AreEqual(firstModel, result.firstModel);
+            Assert::AreEqual(firstCountermodel, result.firstCountermodel);
+        }
+
+        /**
+         * @brief Тест 3: Перебор в нескольких потоках.
+         * @details Проверяет, что итоги перебора блоков в пуле из 4 потоков совпадают с однопоточными.
+         */
+        TEST_METHOD(Test3_ParallelBlocks)
+        {
+            std::string expression = makeExpression(26);
+            ModelCount sequential, parallel;
+            std::set<Error> errors;
+            Assert::IsTrue(processModelCount(expression, sequential, errors));
+
+            ForkJoinPool pool(4);
+            Assert::IsTrue(processModelCount(expression, parallel, errors, syntaxPostfix, &pool));
+
+            Assert::AreEqual(sequential.models, parallel.models);
+            Assert::AreEqual(sequential.firstModel, parallel.firstModel);
+            Assert::AreEqual(sequential.firstCountermodel, parallel.firstCountermodel);
+        }
+
+        /**
+         * @brief Тест 4: Тавтология от многих переменных.
+         * @details Проверяет, что для тавтологии опровергающий набор отсутствует, а выполняющих наборов 2^n.
+         */
+        TEST_METHOD(Test4_WideTautology)
+        {
+            std::string expression = makeExpression(24) + " x3 x3 ! | |";
+            ModelCount result;
+            std::set<Error> errors;
+            ForkJoinPool pool(2);
+            Assert::IsTrue(processModelCount(expression, result, errors, syntaxPostfix, &pool));
+
+            Assert::IsTrue(result.isTautology());
+            Assert::AreEqual(result.size(), result.models);
+            Assert::AreEqual(static_cast<uint64_t>(0), result.firstModel);
+        }
+
+        /**
+         * @brief Тест 5: Слишком много переменных.
+         * @details Проверяет, что для 41 переменной перебор не выполняется и добавляется ошибка tooManyVariables.
+         */
+        TEST_METHOD(Test5_TooManyVariables)
+        {
+            std::string expression = "x0";
+            for (int i = 1; i < 41; i++) expression += " x" + std::to_string(i) + " |";
+
+            ModelCount result;
+            std::set<Error> errors;
+            Assert::IsFalse(processModelCount(expression, result, errors));
+            Assert::IsTrue(errors.begin()->type == Error::tooManyVariables);
+            Assert::AreEqual(static_cast<size_t>(41), result.variables.size());
+        }
+    };
+}
\ No newline at end of file
@@ -0,0 +1,192 @@
+/**
+ * @file test_negationNormalForm.cpp
+ * @brief Юнит-тесты для построения отрицательной нормальной формы и однопроходного преобразования выражения.
+ */
+
+#include "pch.h"
+#include "CppUnitTest.h"
+#include "../simpleLogicExpression/functions.h"
+#include "../simpleLogicExpression/objects.h"
+#include "testFunctions.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace testNegationNormalForm
+{
+    TEST_CLASS(testNegationNormalForm)
+    {
+    public:
+        /**
+         * @brief Тест 1: Отрицание конъюнкции.
+         * @details Проверяет преобразование !(a & b) в !a | !b.
+         */
+        TEST_METHOD(Test1_NegatedAnd)
+        {
+            ExpressionNode* input = new ExpressionNode(TokenType::Not, nullptr,
+                new ExpressionNode(TokenType::And,
+                    new ExpressionNode(TokenType::Variable, "a"),
+                    new ExpressionNode(TokenType::Variable, "b")));
+            ExpressionNode* expected = new ExpressionNode(TokenType::Or,
+                new ExpressionNode(TokenType::Not, nullptr, new ExpressionNode(TokenType::Variable, "a")),
+                new ExpressionNode(TokenType::Not, nullptr, new ExpressionNode(TokenType::Variable, "b")));
+
+            ExpressionNode* actual = negationNormalForm(input);
+
+            Assert::IsTrue(compareExpressionTrees(expected, actual));
+
+            delete input;
+            delete expected;
+            delete actual;
+        }
+
+        /**
+         * @brief Тест 2: Цепочка отрицаний.
+         * @details Проверяет, что нечетное число отрицаний дает одно отрицание, а четное — ни одного.
+         */
+        TEST_METHOD(Test2_NegationChains)
+        {
+            ExpressionNode* odd = new ExpressionNode(TokenType::Not, nullptr,
+                new ExpressionNode(TokenType::Not, nullptr,
+                    new ExpressionNode(TokenType::Not, nullptr, new ExpressionNode(TokenType::Variable, "a"))));
+            ExpressionNode* even = new ExpressionNode(TokenType::Not, nullptr, copyNode(odd));
+
+            ExpressionNode* oddResult = negationNormalForm(odd);
+            ExpressionNode* evenResult = negationNormalForm(even);
+
+            Assert::AreEqual(std::string("!a"), expressionTreeToInfix(oddResult));
+            Assert::AreEqual(std::string("a"), expressionTreeToInfix(evenResult));
+
+            delete odd;
+            delete even;
+            delete oddResult;
+            delete evenResult;
+        }
+
+        /**
+         * @brief Тест 3: Вложенные отрицания.
+         * @details Проверяет перенос отрицания через несколько уровней: !(a | !(b & !c)) → !a & b & !c.
+         */
+        TEST_METHOD(Test3_NestedNegations)
+        {
+            ExpressionNode* input = new ExpressionNode(TokenType::Not, nullptr,
+                new ExpressionNode(TokenType::Or,
+                    new ExpressionNode(TokenType::Variable, "a"),
+                    new ExpressionNode(TokenType::Not, nullptr,
+                        new ExpressionNode(TokenType::And,
+                            new ExpressionNode(TokenType::Variable, "b"),
+                            new ExpressionNode(TokenType::Not, nullptr, new ExpressionNode(TokenType::Variable, "c"))))));
+
+            ExpressionNode* actual = negationNormalForm(input);
+
+            Assert::AreEqual(std::string("!a & b & !c"), expressionTreeToInfix(actual));
+
+            delete input;
+            delete actual;
+        }
+
+        /**
+         * @brief Тест 4: Совпадение с повторными проходами.
+         * @details Проверяет, что оба способа переноса отрицаний дают одинаковый результат на обоих представлениях дерева.
+         */
+        TEST_METHOD(Test4_MatchesRounds)
+        {
+            const char* expressions[] = {
+                "a b > !",
+                "a b ~ c & !",
+                "a b c | & ! d ~ ! !",
+                "a ! ! ! b ! ! > c d ~ | !",
+                "a b > c > d e ~ ~ !",
+                "a b & c & d ! | ! !"
+            };
+            PipelineEngine engines[] = { engineTree, engineFlat };
+
+            for (const char* expression : expressions) {
+                for (PipelineEngine engine : engines) {
+                    std::string expectedInput, expectedResult, actualInput, actualResult;
+                    std::set<Error> expectedErrors, actualErrors;
+                    ProgramOptions expectedOptions, actualOptions;
+                    expectedOptions.engine = actualOptions.engine = engine;
+                    actualOptions.rewrite = rewriteNnf;
+
+                    Assert::IsTrue(processExpression(expression, expectedInput, expectedResult, expectedErrors, expectedOptions));
+                    Assert::IsTrue(processExpression(expression, actualInput, actualResult, actualErrors, actualOptions));
+
+                    Assert::AreEqual(expectedInput, actualInput);
+                    Assert::AreEqual(expectedResult, actualResult);
+                }
+            }
+        }
+
+        /**
+         * @brief Тест 5: Глубокая цепочка отрицаний в плоском дереве.
+         * @details Проверяет, что 100001 отрицание над конъюнкцией обрабатывается без переполнения стека вызовов.
+         */
+        TEST_METHOD(Test5_DeepFlatChain)
+        {
+            FlatExpression tree;
+            NodeIndex root = tree.addNode(TokenType::And, Symbol(),
+                tree.addNode(TokenType::Variable, "a"),
+                tree.addNode(TokenType::Variable, "b"));
+            for (int i = 0; i < 100001; ++i) {
+                root = tree.addNode(TokenType::Not, Symbol(), nullNode, root);
+            }
+
+            root = negationNormalForm(tree, root);
+
+            Assert::AreEqual(std::string("!a || !b"), expressionTreeToInfix(tree, root));
+        }
+
+        /**
+         * @brief Тест 6: Раскрытие эквивалентности под отрицанием за один проход.
+         * @details Проверяет преобразование !(a ~ b) в (!a || !b) & (a || b).
+         */
+        TEST_METHOD(Test6_FusedNegatedEquivalence)
+        {
+            ExpressionNode* input = new ExpressionNode(TokenType::Not, nullptr,
+                new ExpressionNode(TokenType::Equivalence,
+                    new ExpressionNode(TokenType::Variable, "a"),
+                    new ExpressionNode(TokenType::Variable, "b")));
+
+            ExpressionNode* actual = fusedNormalForm(input);
+
+            Assert::AreEqual(std::string("(!a || !b) & (a || b)"), expressionTreeToInfix(actual));
+
+            delete input;
+            delete actual;
+        }
+
+        /**
+         * @brief Тест 7: Совпадение однопроходного преобразования с повторными проходами.
+         * @details Проверяет, что оба способа дают одинаковый результат на обоих представлениях дерева.
+         */
+        TEST_METHOD(Test7_FusedMatchesRounds)
+        {
+            const char* expressions[] = {
+                "a b > !",
+                "a b ~ !",
+                "a b ~ c & !",
+                "a b c | & ! d ~ ! !",
+                "a ! ! ! b ! ! > c d ~ | !",
+                "a b > c > d e ~ ~ !",
+                "a b ~ c ~ d > ! e ~"
+            };
+            PipelineEngine engines[] = { engineTree, engineFlat };
+
+            for (const char* expression : expressions) {
+                for (PipelineEngine engine : engines) {
+                    std::string expectedInput, expectedResult, actualInput, actualResult;
+                    std::set<Error> expectedErrors, actualErrors;
+                    ProgramOptions expectedOptions, actualOptions;
+                    expectedOptions.engine = actualOptions.engine = engine;
+                    actualOptions.rewrite = rewriteFused;
+
+                    Assert::IsTrue(processExpression(expression, expectedInput, expectedResult, expectedErrors, expectedOptions));
+                    Assert::IsTrue(processExpression(expression, actualInput, actualResult, actualErrors, actualOptions));
+
+                    Assert::AreEqual(expectedInput, actualInput);
+                    Assert::AreEqual(expectedResult, actualResult);
+                }
+            }
+        }
+    };
+}
\ No newline at end of file
@@ -0,0 +1,156 @@
+/**
+ * @file test_nodeArena.cpp
+ * @brief Юнит-тесты для пула узлов дерева выражения.
+ */
+
+#include "pch.h"
+#include "CppUnitTest.h"
+#include "../simpleLogicExpression/functions.h"
+#include "../simpleLogicExpression/objects.h"
+#include "testFunctions.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace testNodeArena
+{
+    TEST_CLASS(testNodeArena)
+    {
+    public:
+        /**
+         * @brief Тест 1: Размещение узлов в активном пуле.
+         * @details Проверяет, что узлы, созданные в области действия пула, принадлежат пулу.
+         */
+        TEST_METHOD(Test1_NodesAllocatedInScope)
+        {
+            NodeArena arena;
+            ExpressionNode* node = nullptr;
+            {
+                ArenaScope scope(arena);
+                node = new ExpressionNode(TokenType::Variable, "a");
+            }
+
+            Assert::IsTrue(arena.owns(node));
+            Assert::AreEqual(static_cast<size_t>(1), arena.blockCount());
+        }
+
+        /**
+         * @brief Тест 2: Размещение узлов вне пула.
+         * @details Проверяет, что без активного пула узлы размещаются в общей куче.
+         */
+        TEST_METHOD(Test2_NodesOutsideScope)
+        {
+            NodeArena arena;
+            {
+                ArenaScope scope(arena);
+            }
+            ExpressionNode* node = new ExpressionNode(TokenType::Variable, "a");
+
+            Assert::IsFalse(arena.owns(node));
+            Assert::IsTrue(NodeArena::current() == nullptr);
+
+            delete node;
+        }
+
+        /**
+         * @brief Тест 3: Повторное использование удаленного узла.
+         * @details Проверяет, что память удаленного узла выдается следующему созданному узлу.
+         */
+        TEST_METHOD(Test3_DeletedNodeIsReused)
+        {
+            NodeArena arena;
+            ArenaScope scope(arena);
+
+            ExpressionNode* first = new ExpressionNode(TokenType::Variable, "a");
+            delete first;
+            ExpressionNode* second = new ExpressionNode(TokenType::Variable, "b");
+
+            Assert::IsTrue(static_cast<void*>(first) == static_cast<void*>(second));
+        }
+
+        /**
+         * @brief Тест 4: Сброс пула.
+         * @details Проверяет, что после сброса память выдается заново с начала без получения новых блоков.
+         */
+        TEST_METHOD(Test4_ResetReusesBlocks)
+        {
+            NodeArena arena;
+            ArenaScope scope(arena);
+
+            ExpressionNode* first = nullptr;
+            for (int i = 0; i < 5000; i++) {
+                ExpressionNode* node = new ExpressionNode(TokenType::Variable, "a");
+                if (i == 0) first = node;
+            }
+            size_t blocks = arena.blockCount();
+
+            arena.reset();
+            ExpressionNode* again = nullptr;
+            for (int i = 0; i < 5000; i++) {
+                ExpressionNode* node = new ExpressionNode(TokenType::Variable, "a");
+                if (i == 0) again = node;
+            }
+
+            Assert::IsTrue(static_cast<void*>(first) == static_cast<void*>(again));
+            Assert::AreEqual(blocks, arena.blockCount());
+        }
+
+        /**
+         * @brief Тест 5: Вложенные области действия.
+         * @details Проверяет, что при выходе из вложенной области восстанавливается внешний пул.
+         */
+        TEST_METHOD(Test5_NestedScopes)
+        {
+            NodeArena outer;
+            NodeArena inner;
+            ArenaScope outerScope(outer);
+            {
+                ArenaScope innerScope(inner);
+                Assert::IsTrue(NodeArena::current() == &inner);
+            }
+
+            Assert::IsTrue(NodeArena::current() == &outer);
+        }
+
+        /**
+         * @brief Тест 6: Освобождение дерева из пула.
+         * @details Проверяет, что releaseExpressionTree не удаляет узлы пула по одному.
+         */
+        TEST_METHOD(Test6_ReleaseTreeInArena)
+        {
+            NodeArena arena;
+            ArenaScope scope(arena);
+
+            ExpressionNode* tree = new ExpressionNode(TokenType::And, new ExpressionNode(TokenType::Variable, "a"), new ExpressionNode(TokenType::Variable, "b"));
+            ExpressionNode* left = tree->left;
+            releaseExpressionTree(tree);
+
+            // Узлы не возвращены в список свободных: новый узел получает новую ячейку
+            ExpressionNode* next = new ExpressionNode(TokenType::Variable, "c");
+            Assert::IsTrue(static_cast<void*>(next) != static_cast<void*>(tree));
+            Assert::IsTrue(static_cast<void*>(next) != static_cast<void*>(left));
+        }
+
+        /**
+         * @brief Тест 7: Полное преобразование выражения в пуле.
+         * @details Проверяет, что результат преобразования в пуле совпадает с ожидаемым.
+         */
+        TEST_METHOD(Test7_PipelineInArena)
+        {
+            NodeArena arena;
+            ArenaScope scope(arena);
+
+            std::set<Error> errorList;
+            std::string inputStr;
+            std::string result;
+
+            for (int i = 0; i < 3; i++) {
+                bool processed = processExpression("a b ~ c > !", inputStr, result, errorList);
+                arena.reset();
+
+                Assert::IsTrue(processed);
+                Assert::AreEqual(std::string("!((a ~ b) -> c)"), inputStr);
+                Assert::AreEqual(std::string("(a & b || !a & !b) & !c"), result);
+            }
+        }
+    };
+}
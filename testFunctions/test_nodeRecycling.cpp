@@ -0,0 +1,190 @@
+/**
+ * @file test_nodeRecycling.cpp
+ * @brief Юнит-тесты для повторного использования узлов при законах де Моргана и удалении двойных отрицаний.
+ */
+
+#include "pch.h"
+#include "CppUnitTest.h"
+#include "../simpleLogicExpression/functions.h"
+#include "../simpleLogicExpression/objects.h"
+#include "testFunctions.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace testNodeRecycling
+{
+    /**
+     * @brief Создает дерево !(a & b).
+     * @return Указатель на корень дерева.
+     */
+    static ExpressionNode* makeNegatedAnd() {
+        return new ExpressionNode(TokenType::Not, nullptr,
+            new ExpressionNode(TokenType::And,
+                new ExpressionNode(TokenType::Variable, "a"),
+                new ExpressionNode(TokenType::Variable, "b")));
+    }
+
+    /**
+     * @brief Создает дерево !!a.
+     * @return Указатель на корень дерева.
+     */
+    static ExpressionNode* makeDoubleNot() {
+        return new ExpressionNode(TokenType::Not, nullptr,
+            new ExpressionNode(TokenType::Not, nullptr,
+                new ExpressionNode(TokenType::Variable, "a")));
+    }
+
+    TEST_CLASS(testNodeRecycling)
+    {
+    public:
+        /**
+         * @brief Тест 1: Закон де Моргана без запаса узлов.
+         * @details Проверяет, что узел конъюнкции становится отрицанием, а выделяется только один новый узел.
+         */
+        TEST_METHOD(Test1_DeMorganReusesOperationNode)
+        {
+            releaseSpareNodes();
+            ExpressionNode* input = makeNegatedAnd();
+            ExpressionNode* operation = input->right;
+
+            size_t allocations = ExpressionNode::allocationCount();
+            size_t releases = ExpressionNode::releaseCount();
+            bool changed = false;
+            simplifyExpression(input, changed);
+
+            Assert::IsTrue(changed);
+            Assert::AreEqual(static_cast<size_t>(1), ExpressionNode::allocationCount() - allocations);
+            Assert::AreEqual(static_cast<size_t>(0), ExpressionNode::releaseCount() - releases);
+            Assert::IsTrue(input->left == operation);
+
+            ExpressionNode* expected = new ExpressionNode(TokenType::Or,
+                new ExpressionNode(TokenType::Not, nullptr, new ExpressionNode(TokenType::Variable, "a")),
+                new ExpressionNode(TokenType::Not, nullptr, new ExpressionNode(TokenType::Variable, "b")));
+            Assert::IsTrue(compareExpressionTrees(expected, input));
+
+            delete input;
+            delete expected;
+        }
+
+        /**
+         * @brief Тест 2: Удаление двойного отрицания без обращений к памяти.
+         * @details Проверяет, что удаленные отрицания не освобождаются, а попадают в запас потока.
+         */
+        TEST_METHOD(Test2_RemoveDoubleNotKeepsNodes)
+        {
+            releaseSpareNodes();
+            ExpressionNode* input = makeDoubleNot();
+
+            size_t allocations = ExpressionNode::allocationCount();
+            size_t releases = ExpressionNode::releaseCount();
+            removeDoubleNot(input);
+
+            Assert::AreEqual(static_cast<size_t>(0), ExpressionNode::allocationCount() - allocations);
+            Assert::AreEqual(static_cast<size_t>(0), ExpressionNode::releaseCount() - releases);
+            Assert::AreEqual(static_cast<size_t>(2), spareNodeCount());
+
+            ExpressionNode* expected = new ExpressionNode(TokenType::Variable, "a");
+            Assert::IsTrue(compareExpressionTrees(expected, input));
+
+            delete input;
+            delete expected;
+            releaseSpareNodes();
+        }
+
+        /**
+         * @brief Тест 3: Закон де Моргана с запасом узлов.
+         * @details Проверяет, что узлы, удаленные из двойного отрицания, используются без выделения памяти.
+         */
+        TEST_METHOD(Test3_DeMorganUsesSpareNodes)
+        {
+            releaseSpareNodes();
+            ExpressionNode* doubleNot = makeDoubleNot();
+            removeDoubleNot(doubleNot);
+            ExpressionNode* input = makeNegatedAnd();
+
+            size_t allocations = ExpressionNode::allocationCount();
+            size_t releases = ExpressionNode::releaseCount();
+            bool changed = false;
+            simplifyExpression(input, changed);
+
+            Assert::AreEqual(static_cast<size_t>(0), ExpressionNode::allocationCount() - allocations);
+            Assert::AreEqual(static_cast<size_t>(0), ExpressionNode::releaseCount() - releases);
+            Assert::AreEqual(static_cast<size_t>(1), spareNodeCount());
+
+            ExpressionNode* expected = new ExpressionNode(TokenType::Or,
+                new ExpressionNode(TokenType::Not, nullptr, new ExpressionNode(TokenType::Variable, "a")),
+                new ExpressionNode(TokenType::Not, nullptr, new ExpressionNode(TokenType::Variable, "b")));
+            Assert::IsTrue(compareExpressionTrees(expected, input));
+
+            delete doubleNot;
+            delete input;
+            delete expected;
+            releaseSpareNodes();
+        }
+
+        /**
+         * @brief Тест 4: Полное упрощение без выделения памяти.
+         * @details Проверяет, что упрощение !(!(a & b) & c) до (a & b) | !c использует только узлы исходного дерева и запаса.
+         */
+        TEST_METHOD(Test4_RewritePhaseWithoutAllocations)
+        {
+            releaseSpareNodes();
+            for (int i = 0; i < 2; i++) {
+                ExpressionNode* doubleNot = makeDoubleNot();
+                removeDoubleNot(doubleNot);
+                delete doubleNot;
+            }
+            ExpressionNode* input = new ExpressionNode(TokenType::Not, nullptr,
+                new ExpressionNode(TokenType::And,
+                    makeNegatedAnd(),
+                    new ExpressionNode(TokenType::Variable, "c")));
+
+            size_t allocations = ExpressionNode::allocationCount();
+            size_t releases = ExpressionNode::releaseCount();
+            bool changed = true;
+            while (changed) {
+                changed = false;
+                simplifyExpression(input, changed);
+            }
+            removeDoubleNot(input);
+
+            Assert::AreEqual(static_cast<size_t>(0), ExpressionNode::allocationCount() - allocations);
+            Assert::AreEqual(static_cast<size_t>(0), ExpressionNode::releaseCount() - releases);
+
+            ExpressionNode* expected = new ExpressionNode(TokenType::Or,
+                new ExpressionNode(TokenType::And,
+                    new ExpressionNode(TokenType::Variable, "a"),
+                    new ExpressionNode(TokenType::Variable, "b")),
+                new ExpressionNode(TokenType::Not, nullptr, new ExpressionNode(TokenType::Variable, "c")));
+            Assert::IsTrue(compareExpressionTrees(expected, input));
+
+            delete input;
+            delete expected;
+            releaseSpareNodes();
+        }
+
+        /**
+         * @brief Тест 5: Удаление двойного отрицания в пуле.
+         * @details Проверяет, что при активном пуле удаленные узлы возвращаются в пул, а не в запас потока.
+         */
+        TEST_METHOD(Test5_ArenaNodesReturnToArena)
+        {
+            releaseSpareNodes();
+            NodeArena arena;
+            {
+                ArenaScope scope(arena);
+                ExpressionNode* input = makeDoubleNot();
+                removeDoubleNot(input);
+
+                Assert::AreEqual(static_cast<size_t>(0), spareNodeCount());
+
+                // Освобожденные ячейки пула используются повторно
+                ExpressionNode* reused = makeNegatedAnd();
+                Assert::AreEqual(static_cast<size_t>(1), arena.blockCount());
+
+                releaseExpressionTree(input);
+                releaseExpressionTree(reused);
+            }
+        }
+    };
+}
\ No newline at end of file
@@ -0,0 +1,134 @@
+/**
+ * @file test_outputWriter.cpp
+ * @brief Юнит-тесты для буферизованной записи результатов в файл.
+ */
+
+#include "pch.h"
+#include "CppUnitTest.h"
+#include "../simpleLogicExpression/functions.h"
+#include "../simpleLogicExpression/objects.h"
+#include "testFunctions.h"
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace testOutputWriter
+{
+    /**
+     * @brief Читает содержимое файла целиком.
+     * @param filePath Путь к файлу.
+     * @return Содержимое файла.
+     */
+    static std::string readAll(const std::string& filePath)
+    {
+        std::ifstream file(filePath);
+        std::stringstream buffer;
+        buffer << file.rdbuf();
+        return buffer.str();
+    }
+
+    TEST_CLASS(testOutputWriter)
+    {
+    public:
+        /**
+         * @brief Тест 1: Запись коротких фрагментов.
+         * @details Проверяет, что фрагменты разных типов попадают в файл в порядке записи после close().
+         */
+        TEST_METHOD(Test1_SmallFragments)
+        {
+            const std::string path = "test_outputWriter_1.txt";
+            {
+                OutputWriter output(path);
+                output += "a & ";
+                output += std::string_view("b");
+                output += '\n';
+                output += std::string("c");
+                output.close();
+            }
+
+            Assert::AreEqual(std::string("a & b\nc"), readAll(path));
+            std::remove(path.c_str());
+        }
+
+        /**
+         * @brief Тест 2: Запись фрагментов длиннее буфера.
+         * @details Проверяет, что данные длиннее буфера записываются без потерь и в правильном порядке.
+         */
+        TEST_METHOD(Test2_FragmentsLargerThanBuffer)
+        {
+            const std::string path = "test_outputWriter_2.txt";
+            std::string large(OutputWriter::bufferSize + 17, 'x');
+            {
+                OutputWriter output(path);
+                output += "begin";
+                output += large;
+                output += "end";
+            }
+
+            Assert::AreEqual(std::string("begin") + large + "end", readAll(path));
+            std::remove(path.c_str());
+        }
+
+        /**
+         * @brief Тест 3: Отложенное открытие файла.
+         * @details Проверяет, что файл с отложенным открытием не создается, если в него ничего не выведено.
+         */
+        TEST_METHOD(Test3_DeferredOpenWithoutOutput)
+        {
+            const std::string path = "test_outputWriter_3.txt";
+            std::remove(path.c_str());
+            {
+                OutputWriter output(path, false);
+            }
+
+            std::ifstream file(path);
+            Assert::IsFalse(file.is_open());
+        }
+
+        /**
+         * @brief Тест 4: Ошибка открытия файла.
+         * @details Проверяет, что при невозможности открыть файл выбрасывается ошибка outputFile.
+         */
+        TEST_METHOD(Test4_OpenFailureThrows)
+        {
+            bool thrown = false;
+            try {
+                OutputWriter output("nonexistent_directory/output.txt");
+            }
+            catch (const Error& e) {
+                thrown = e.type == Error::outputFile;
+            }
+
+            Assert::IsTrue(thrown);
+        }
+
+        /**
+         * @brief Тест 5: Потоковый вывод результата обработки.
+         * @details Проверяет, что вывод в файл совпадает со строковыми результатами processExpression.
+         */
+        TEST_METHOD(Test5_StreamingMatchesStrings)
+        {
+            const std::string path = "test_outputWriter_5.txt";
+            const char* expression = "a b ~ c > !";
+            std::string inputStr, result;
+            std::set<Error> errors;
+            Assert::IsTrue(processExpression(expression, inputStr, result, errors));
+
+            {
+                ProgramOptions options;
+                options.engine = engineFlat;
+                options.rewrite = rewriteFused;
+                OutputWriter output(path);
+                Assert::IsTrue(processExpression(expression, output, true, errors));
+                output += '\n';
+                Assert::IsTrue(processExpression(expression, output, false, errors, options));
+                output.close();
+            }
+
+            Assert::AreEqual(inputStr + '\n' + result + '\n' + result, readAll(path));
+            std::remove(path.c_str());
+        }
+    };
+}
\ No newline at end of file
@@ -0,0 +1,121 @@
+/**
+ * @file test_parallelBatch.cpp
+ * @brief Юнит-тесты для многопоточной пакетной обработки.
+ */
+
+#include "pch.h"
+#include "CppUnitTest.h"
+#include "../simpleLogicExpression/functions.h"
+#include "../simpleLogicExpression/objects.h"
+#include "testFunctions.h"
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace testParallelBatch
+{
+    /**
+     * @brief Обрабатывает содержимое в пакетном режиме с заданным количеством потоков.
+     * @param content Содержимое входного файла.
+     * @param threads Количество потоков.
+     * @param success Результат processBatch.
+     * @return Содержимое выходного файла.
+     */
+    static std::string runBatch(const std::string& content, unsigned threads, bool& success)
+    {
+        const char* inputPath = "test_parallelBatch_in.txt";
+        const char* outputPath = "test_parallelBatch_out.txt";
+        {
+            std::ofstream file(inputPath, std::ios::binary);
+            file << content;
+        }
+
+        ProgramOptions options;
+        options.inputFile = inputPath;
+        options.outputFile = outputPath;
+        options.batch = true;
+        options.threads = threads;
+        success = processBatch(options);
+
+        std::ifstream file(outputPath, std::ios::binary);
+        std::stringstream result;
+        result << file.rdbuf();
+        file.close();
+
+        std::remove(inputPath);
+        std::remove(outputPath);
+        return result.str();
+    }
+
+    TEST_CLASS(testParallelBatch)
+    {
+    public:
+        /**
+         * @brief Тест 1: Порядок результатов.
+         * @details Проверяет, что при обработке в нескольких потоках строки результата идут в порядке
+         * входных строк и совпадают с однопоточной обработкой.
+         */
+        TEST_METHOD(Test1_KeepsLineOrder)
+        {
+            std::string content;
+            for (int i = 0; i < 5000; i++) {
+                content += "x" + std::to_string(i % 97) + " y" + std::to_string(i) + " >";
+                content += (i % 3 == 0) ? " !\n" : "\n";
+            }
+
+            bool sequentialSuccess = false, parallelSuccess = false;
+            std::string sequential = runBatch(content, 1, sequentialSuccess);
+            std::string parallel = runBatch(content, 4, parallelSuccess);
+
+            Assert::IsTrue(sequentialSuccess);
+            Assert::IsTrue(parallelSuccess);
+            Assert::AreEqual(sequential, parallel);
+        }
+
+        /**
+         * @brief Тест 2: Ошибки в отдельных строках.
+         * @details Проверяет, что ошибочные строки и пустые строки остаются на своих местах.
+         */
+        TEST_METHOD(Test2_ErrorsStayInPlace)
+        {
+            std::string content;
+            for (int i = 0; i < 3000; i++) {
+                content += (i % 500 == 7) ? "a &\n" : (i % 700 == 3) ? "\n" : "a b | !\n";
+            }
+
+            bool sequentialSuccess = true, parallelSuccess = true;
+            std::string sequential = runBatch(content, 1, sequentialSuccess);
+            std::string parallel = runBatch(content, 3, parallelSuccess);
+
+            Assert::IsFalse(sequentialSuccess);
+            Assert::IsFalse(parallelSuccess);
+            Assert::AreEqual(sequential, parallel);
+        }
+
+        /**
+         * @brief Тест 3: Общая таблица имен.
+         * @details Проверяет, что одновременное добавление имен из нескольких потоков дает каждому
+         * имени единственный идентификатор.
+         */
+        TEST_METHOD(Test3_ConcurrentInterning)
+        {
+            std::vector<std::vector<uint32_t>> ids(4);
+            std::vector<std::thread> workers;
+            for (size_t t = 0; t < ids.size(); t++) {
+                workers.emplace_back([t, &ids]() {
+                    for (int i = 0; i < 2000; i++) {
+                        ids[t].push_back(SymbolTable::instance().intern("parallelName" + std::to_string(i)));
+                    }
+                });
+            }
+            for (auto& worker : workers) worker.join();
+
+            for (size_t t = 1; t < ids.size(); t++) {
+                Assert::IsTrue(ids[0] == ids[t]);
+            }
+            Assert::AreEqual(std::string("parallelName5"), SymbolTable::instance().name(ids[0][5]));
+        }
+    };
+}
\ No newline at end of file
@@ -0,0 +1,225 @@
+/**
+ * @file test_parseInfixExpression.cpp
+ * @brief Юнит-тесты для разбора выражений в инфиксной записи.
+ */
+
+#include "pch.h"
+#include "CppUnitTest.h"
+#include "../simpleLogicExpression/functions.h"
+#include "../simpleLogicExpression/objects.h"
+#include "testFunctions.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace testParseInfixExpression
+{
+    TEST_CLASS(testParseInfixExpression)
+    {
+    public:
+        /**
+         * @brief Тест 1: Приоритеты операций.
+         * @details Проверяет, что конъюнкция связывает сильнее дизъюнкции, а отрицание — сильнее конъюнкции.
+         */
+        TEST_METHOD(Test1_Priorities)
+        {
+            std::set<Error> errors;
+            ExpressionNode* actual = parseInfixExpression("a || !b & c", errors);
+
+            ExpressionNode* expected = new ExpressionNode(TokenType::Or,
+                new ExpressionNode(TokenType::Variable, "a"),
+                new ExpressionNode(TokenType::And,
+                    new ExpressionNode(TokenType::Not, nullptr, new ExpressionNode(TokenType::Variable, "b")),
+                    new ExpressionNode(TokenType::Variable, "c")));
+
+            Assert::IsTrue(errors.empty());
+            Assert::IsTrue(compareExpressionTrees(expected, actual));
+
+            delete actual;
+            delete expected;
+        }
+
+        /**
+         * @brief Тест 2: Левая ассоциативность и скобки.
+         * @details Проверяет, что a -> b -> c разбирается как (a -> b) -> c, а скобки меняют порядок.
+         */
+        TEST_METHOD(Test2_LeftAssociativityAndBrackets)
+        {
+            std::set<Error> errors;
+            ExpressionNode* chain = parseInfixExpression("a -> b -> c", errors);
+            ExpressionNode* grouped = parseInfixExpression("a -> (b -> c)", errors);
+
+            ExpressionNode* expectedChain = new ExpressionNode(TokenType::Implication,
+                new ExpressionNode(TokenType::Implication,
+                    new ExpressionNode(TokenType::Variable, "a"),
+                    new ExpressionNode(TokenType::Variable, "b")),
+                new ExpressionNode(TokenType::Variable, "c"));
+            ExpressionNode* expectedGrouped = new ExpressionNode(TokenType::Implication,
+                new ExpressionNode(TokenType::Variable, "a"),
+                new ExpressionNode(TokenType::Implication,
+                    new ExpressionNode(TokenType::Variable, "b"),
+                    new ExpressionNode(TokenType::Variable, "c")));
+
+            Assert::IsTrue(errors.empty());
+            Assert::IsTrue(compareExpressionTrees(expectedChain, chain));
+            Assert::IsTrue(compareExpressionTrees(expectedGrouped, grouped));
+
+            delete chain;
+            delete grouped;
+            delete expectedChain;
+            delete expectedGrouped;
+        }
+
+        /**
+         * @brief Тест 3: Обозначения операций.
+         * @details Проверяет, что "|" и ">" равносильны "||" и "->", а пробелы вокруг операций и скобок не обязательны.
+         */
+        TEST_METHOD(Test3_OperatorSpellings)
+        {
+            std::set<Error> errors;
+            ExpressionNode* spaced = parseInfixExpression("!(a || b) -> c ~ d", errors);
+            ExpressionNode* compact = parseInfixExpression("!(a|b)>c~d", errors);
+
+            Assert::IsTrue(errors.empty());
+            Assert::IsTrue(compareExpressionTrees(spaced, compact));
+            Assert::AreEqual(std::string("!(a || b) -> c ~ d"), expressionTreeToInfix(compact));
+
+            delete spaced;
+            delete compact;
+        }
+
+        /**
+         * @brief Тест 4: Разбор результата вывода.
+         * @details Проверяет, что инфиксная запись, выведенная для постфиксного выражения, разбирается в выражение с той же записью.
+         */
+        TEST_METHOD(Test4_RoundTripOfPrintedInput)
+        {
+            const char* expressions[] = {
+                "a b > !",
+                "a ! ! ! b ! ! > c d ~ |",
+                "a b > c > d e ~ ~ !",
+                "a b c > > d & !",
+                "a b & c & d ! | ! !"
+            };
+
+            for (const char* expression : expressions) {
+                std::string printed, result;
+                std::set<Error> errors;
+                Assert::IsTrue(processExpression(expression, printed, result, errors));
+
+                ExpressionNode* parsed = parseInfixExpression(printed, errors);
+                Assert::IsTrue(errors.empty());
+                Assert::AreEqual(printed, expressionTreeToInfix(parsed));
+                delete parsed;
+            }
+        }
+
+        /**
+         * @brief Тест 5: Совпадение результатов представлений.
+         * @details Проверяет, что обработка инфиксной записи дает одинаковый результат для всех представлений дерева.
+         */
+        TEST_METHOD(Test5_EnginesAgree)
+        {
+            const char* expressions[] = {
+                "!(a -> b)",
+                "!!a & (b ~ !c)",
+                "!(a & (b || c -> d)) ~ e"
+            };
+            PipelineEngine engines[] = { engineFlat, engineDag, engineEdge };
+            ProgramOptions options;
+            options.syntax = syntaxInfix;
+
+            for (const char* expression : expressions) {
+                std::string expectedInput, expectedResult;
+                std::set<Error> expectedErrors;
+                options.engine = engineTree;
+                Assert::IsTrue(processExpression(expression, expectedInput, expectedResult, expectedErrors, options));
+
+                for (PipelineEngine engine : engines) {
+                    std::string actualInput, actualResult;
+                    std::set<Error> actualErrors;
+                    options.engine = engine;
+                    Assert::IsTrue(processExpression(expression, actualInput, actualResult, actualErrors, options));
+                    Assert::AreEqual(expectedInput, actualInput);
+                    Assert::AreEqual(expectedResult, actualResult);
+                }
+            }
+        }
+
+        /**
+         * @brief Тест 6: Ошибки структуры выражения.
+         * @details Проверяет тип и позицию ошибки для пропущенных операндов и операций и непарных скобок.
+         */
+        TEST_METHOD(Test6_StructureErrors)
+        {
+            struct Case {
+                const char* expression;
+                Error::ErrorType type;
+                int position;
+            };
+            Case cases[] = {
+                { "a b", Error::ErrorType::missingOperation, 2 },
+                { "a & !", Error::ErrorType::insufficientOperands, 3 },
+                { "& a", Error::ErrorType::insufficientOperands, 1 },
+                { "(a & b", Error::ErrorType::unbalancedBrackets, 1 },
+                { "a & b)", Error::ErrorType::unbalancedBrackets, 4 },
+                { "a (b)", Error::ErrorType::missingOperation, 2 }
+            };
+
+            for (const Case& test : cases) {
+                std::set<Error> errors;
+                ExpressionNode* tree = parseInfixExpression(test.expression, errors);
+
+                std::set<Error> expected = { Error(test.type, test.position) };
+                Assert::IsTrue(tree == nullptr);
+                Assert::IsTrue(compareErrorSets(expected, errors));
+            }
+        }
+
+        /**
+         * @brief Тест 7: Ошибки в лексемах.
+         * @details Проверяет, что ошибки в именах и операциях совпадают с ошибками tokenize и сообщаются вместо ошибок структуры.
+         */
+        TEST_METHOD(Test7_LexemeErrors)
+        {
+            std::set<Error> errors;
+            ExpressionNode* tree = parseInfixExpression("1a & b$ ( $", errors);
+
+            std::set<Error> expected = {
+                Error(Error::ErrorType::invalidVariableName, 1),
+                Error(Error::ErrorType::invalidVariableChar, 3),
+                Error(Error::ErrorType::unsupportedOperation, 5)
+            };
+            Assert::IsTrue(tree == nullptr);
+            Assert::IsTrue(compareErrorSets(expected, errors));
+
+            std::set<Error> emptyErrors;
+            Assert::IsTrue(parseInfixExpression("  \t ", emptyErrors) == nullptr);
+            Assert::IsTrue(compareErrorSets({ Error(Error::ErrorType::emptyFile) }, emptyErrors));
+        }
+
+        /**
+         * @brief Тест 8: Глубокая вложенность скобок и отрицаний.
+         * @details Проверяет, что разбор не рекурсивен и выдерживает 100000 уровней вложенности.
+         */
+        TEST_METHOD(Test8_DeepNesting)
+        {
+            const size_t depth = 100000;
+            std::string expression = std::string(depth, '(') + std::string(depth, '!') + "a" + std::string(depth, ')');
+            std::set<Error> errors;
+
+            ExpressionNode* tree = parseInfixExpression(expression, errors);
+
+            Assert::IsTrue(errors.empty());
+            size_t negations = 0;
+            const ExpressionNode* current = tree;
+            while (current->type == TokenType::Not) {
+                negations++;
+                current = current->right;
+            }
+            Assert::AreEqual(depth, negations);
+            Assert::AreEqual(std::string("a"), std::string(current->value.name()));
+
+            delete tree;
+        }
+    };
+}
\ No newline at end of file
@@ -0,0 +1,141 @@
+/**
+ * @file test_parsePostfixExpression.cpp
+ * @brief Юнит-тесты для построения дерева из постфиксной записи без вектора токенов.
+ */
+
+#include "pch.h"
+#include "CppUnitTest.h"
+#include "../simpleLogicExpression/functions.h"
+#include "../simpleLogicExpression/objects.h"
+#include "testFunctions.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace testParsePostfixExpression
+{
+    TEST_CLASS(testParsePostfixExpression)
+    {
+    public:
+        /**
+         * @brief Тест 1: Совпадение дерева с построенным из токенов.
+         * @details Проверяет, что дерево совпадает с результатом tokenize и buildExpressionTree.
+         */
+        TEST_METHOD(Test1_SameTreeAsTokenPath)
+        {
+            const char* expressions[] = {
+                "a",
+                "a ! !",
+                "a b & c |",
+                "a b > c d ~ | !",
+                "x1 y2 z3 & ! >\t w ~"
+            };
+
+            for (const char* expression : expressions) {
+                std::set<Error> expectedErrors, errors;
+                ExpressionNode* expected = buildExpressionTree(tokenize(expression, expectedErrors), expectedErrors);
+                ExpressionNode* actual = parsePostfixExpression(expression, errors);
+
+                Assert::IsTrue(errors.empty());
+                Assert::IsTrue(compareExpressionTrees(expected, actual));
+
+                delete expected;
+                delete actual;
+            }
+        }
+
+        /**
+         * @brief Тест 2: Совпадение ошибок с построением из токенов.
+         * @details Проверяет, что типы и позиции ошибок совпадают с ошибками tokenize и buildExpressionTree.
+         */
+        TEST_METHOD(Test2_SameErrorsAsTokenPath)
+        {
+            const char* expressions[] = {
+                "&",
+                "a &",
+                "! a b",
+                "a b",
+                "a b c & ! & & |",
+                "1a b &",
+                "a b$ & $",
+                "a && b"
+            };
+
+            for (const char* expression : expressions) {
+                std::set<Error> expectedErrors, errors;
+                std::vector<Token> tokens = tokenize(expression, expectedErrors);
+                if (expectedErrors.empty()) {
+                    delete buildExpressionTree(tokens, expectedErrors);
+                }
+
+                ExpressionNode* actual = parsePostfixExpression(expression, errors);
+
+                Assert::IsTrue(actual == nullptr);
+                Assert::IsFalse(errors.empty());
+                Assert::IsTrue(compareErrorSets(expectedErrors, errors));
+            }
+        }
+
+        /**
+         * @brief Тест 3: Пустая строка.
+         * @details Проверяет, что для строки из разделителей сообщается ошибка emptyFile.
+         */
+        TEST_METHOD(Test3_EmptyExpression)
+        {
+            std::set<Error> errors;
+            ExpressionNode* actual = parsePostfixExpression(" \t \r\n", errors);
+
+            Assert::IsTrue(actual == nullptr);
+            Assert::IsTrue(compareErrorSets({ Error(Error::ErrorType::emptyFile) }, errors));
+        }
+
+        /**
+         * @brief Тест 4: Построение других представлений.
+         * @details Проверяет, что плоское дерево, граф и выражение с отрицаниями на ребрах строятся так же, как из токенов.
+         */
+        TEST_METHOD(Test4_OtherRepresentations)
+        {
+            const char* expression = "a b > ! c d ~ ! | ! !";
+            std::set<Error> errors;
+            std::vector<Token> tokens = tokenize(expression, errors);
+
+            FlatExpression expectedTree, tree;
+            NodeIndex expectedRoot = buildExpressionTree(tokens, errors, expectedTree);
+            NodeIndex root = parsePostfixExpression(expression, errors, tree);
+            Assert::AreEqual(expressionTreeToInfix(expectedTree, expectedRoot), expressionTreeToInfix(tree, root));
+
+            ExpressionDag expectedDag, dag;
+            NodeIndex expectedDagRoot = buildExpressionTree(tokens, errors, expectedDag);
+            NodeIndex dagRoot = parsePostfixExpression(expression, errors, dag);
+            Assert::AreEqual(expressionTreeToInfix(expectedDag.graph(), expectedDagRoot), expressionTreeToInfix(dag.graph(), dagRoot));
+
+            EdgeExpression expectedGraph, graph;
+            Edge expectedEdge = buildExpressionTree(tokens, errors, expectedGraph);
+            Edge edge = parsePostfixExpression(expression, errors, graph);
+            Assert::AreEqual(expectedEdge, edge);
+            Assert::AreEqual(expectedGraph.size(), graph.size());
+
+            Assert::IsTrue(errors.empty());
+        }
+
+        /**
+         * @brief Тест 5: Выражение, пересекающее блоки по 64 байта.
+         * @details Проверяет построение длинного выражения с токенами на границах блоков.
+         */
+        TEST_METHOD(Test5_LongExpression)
+        {
+            std::string expression = "variable0";
+            for (int i = 1; i < 200; i++) {
+                expression += " variable" + std::to_string(i) + (i % 2 ? " &" : " ! |");
+            }
+            std::set<Error> expectedErrors, errors;
+            ExpressionNode* expected = buildExpressionTree(tokenize(expression, expectedErrors), expectedErrors);
+            ExpressionNode* actual = parsePostfixExpression(expression, errors);
+
+            Assert::IsTrue(errors.empty());
+            Assert::IsTrue(compareExpressionTrees(expected, actual));
+
+            delete expected;
+            delete actual;
+        }
+    };
+}
\ No newline at end of file
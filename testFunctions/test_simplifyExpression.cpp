@@ -403,5 +403,36 @@ namespace testSimplifyExpression
             delete input;
             delete expected;
         }
+
+        /**
+         * @brief Тест 15: Глубокая цепочка отрицаний конъюнкций
+         * (...(a ∧ ¬(b ∧ c)) ∧ ¬(b ∧ c)...) глубиной 200000 без переполнения стека вызовов
+         */
+        TEST_METHOD(Test15_DeepChain)
+        {
+            const int depth = 200000;
+            ExpressionNode* input = new ExpressionNode(Variable, "a");
+            for (int i = 0; i < depth; ++i) {
+                ExpressionNode* negated = new ExpressionNode(Not, nullptr,
+                    new ExpressionNode(And, new ExpressionNode(Variable, "b"), new ExpressionNode(Variable, "c")));
+                input = new ExpressionNode(And, input, negated);
+            }
+
+            bool changed = false;
+            simplifyExpression(input, changed);
+            Assert::IsTrue(changed, L"Ожидалось изменение выражения");
+
+            // Каждое отрицание конъюнкции заменено дизъюнкцией отрицаний
+            int count = 0;
+            const ExpressionNode* node = input;
+            while (node->type == And) {
+                Assert::IsTrue(node->right->type == Or && node->right->left->type == Not && node->right->right->type == Not);
+                node = node->left;
+                count++;
+            }
+            Assert::AreEqual(depth, count);
+
+            delete input;
+        }
     };
 }
\ No newline at end of file
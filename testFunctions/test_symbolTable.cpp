@@ -0,0 +1,113 @@
+/**
+ * @file test_symbolTable.cpp
+ * @brief Юнит-тесты для интернирования имен переменных.
+ */
+
+#include "pch.h"
+#include "CppUnitTest.h"
+#include "../simpleLogicExpression/functions.h"
+#include "../simpleLogicExpression/objects.h"
+#include "testFunctions.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace testSymbolTable
+{
+    TEST_CLASS(testSymbolTable)
+    {
+    public:
+        /**
+         * @brief Тест 1: Пустое имя.
+         * @details Проверяет, что имя по умолчанию пустое и имеет идентификатор 0.
+         */
+        TEST_METHOD(Test1_EmptySymbol)
+        {
+            Symbol symbol;
+
+            Assert::IsTrue(symbol.empty());
+            Assert::AreEqual(0u, symbol.id);
+            Assert::AreEqual(std::string(""), symbol.name());
+            Assert::IsTrue(symbol == Symbol(""));
+        }
+
+        /**
+         * @brief Тест 2: Повторное интернирование.
+         * @details Проверяет, что одно и то же имя из разных источников получает один идентификатор.
+         */
+        TEST_METHOD(Test2_SameNameSameId)
+        {
+            std::string name = "variable1";
+            Symbol fromLiteral("variable1");
+            Symbol fromString(name);
+            Symbol fromView(std::string_view("xvariable1x").substr(1, 9));
+
+            Assert::IsTrue(fromLiteral == fromString);
+            Assert::IsTrue(fromLiteral == fromView);
+        }
+
+        /**
+         * @brief Тест 3: Разные имена.
+         * @details Проверяет, что разные имена получают разные идентификаторы и восстанавливаются без искажений.
+         */
+        TEST_METHOD(Test3_DifferentNamesDifferentIds)
+        {
+            Symbol a("a");
+            Symbol b("b");
+            Symbol ab("ab");
+
+            Assert::IsTrue(a != b);
+            Assert::IsTrue(a != ab);
+            Assert::AreEqual(std::string("a"), a.name());
+            Assert::AreEqual(std::string("b"), b.name());
+            Assert::AreEqual(std::string("ab"), ab.name());
+        }
+
+        /**
+         * @brief Тест 4: Размер таблицы.
+         * @details Проверяет, что повторное интернирование не добавляет новых имен.
+         */
+        TEST_METHOD(Test4_TableDoesNotGrowOnRepeat)
+        {
+            Symbol first("repeatedName");
+            size_t size = SymbolTable::instance().size();
+
+            for (int i = 0; i < 100; i++) {
+                Symbol repeated("repeatedName");
+                Assert::IsTrue(repeated == first);
+            }
+
+            Assert::AreEqual(size, SymbolTable::instance().size());
+        }
+
+        /**
+         * @brief Тест 5: Копирование узла.
+         * @details Проверяет, что копия узла переменной хранит тот же идентификатор имени.
+         */
+        TEST_METHOD(Test5_CopyNodeKeepsSymbol)
+        {
+            ExpressionNode* original = new ExpressionNode(TokenType::Variable, "x1");
+            ExpressionNode* copy = copyNode(original);
+
+            Assert::IsTrue(original->value == copy->value);
+            Assert::AreEqual(std::string("x1"), copy->value.name());
+
+            delete original;
+            delete copy;
+        }
+
+        /**
+         * @brief Тест 6: Вывод имени в инфиксной записи.
+         * @details Проверяет, что имена переменных восстанавливаются при формировании инфиксной строки.
+         */
+        TEST_METHOD(Test6_NamesResolvedInInfix)
+        {
+            std::set<Error> errorList;
+            std::vector<Token> tokens = tokenize("first second &", errorList);
+            ExpressionNode* tree = buildExpressionTree(tokens, errorList);
+
+            Assert::AreEqual(std::string("first & second"), expressionTreeToInfix(tree));
+
+            delete tree;
+        }
+    };
+}
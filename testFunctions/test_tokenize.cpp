@@ -0,0 +1,322 @@
+/**
+ * @file test_tokenize.cpp
+ * @brief Юнит-тесты для разбиения строки на токены.
+ */
+
+#include "pch.h"
+#include "CppUnitTest.h"
+#include "../simpleLogicExpression/functions.h"
+#include "../simpleLogicExpression/objects.h"
+#include "testFunctions.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace testTokenize
+{
+    TEST_CLASS(testTokenize)
+    {
+    public:
+        /**
+         * @brief Тест 1: Пустая строка.
+         * @details Проверяет, что пустая строка приводит к ошибке отсутствия выражения.
+         */
+        TEST_METHOD(Test1_EmptyString)
+        {
+            std::set<Error> errorList;
+            std::vector<Token> result = tokenize("", errorList);
+
+            std::set<Error> expectedErrors = { Error(Error::emptyFile) };
+
+            Assert::IsTrue(result.empty());
+            Assert::IsTrue(compareErrorSets(expectedErrors, errorList));
+        }
+
+        /**
+         * @brief Тест 2: Строка из одних разделителей.
+         * @details Проверяет, что пробелы, табуляции и переводы строк не образуют токенов.
+         */
+        TEST_METHOD(Test2_OnlySeparators)
+        {
+            std::set<Error> errorList;
+            std::vector<Token> result = tokenize(" \t\r\n  ", errorList);
+
+            std::set<Error> expectedErrors = { Error(Error::emptyFile) };
+
+            Assert::IsTrue(result.empty());
+            Assert::IsTrue(compareErrorSets(expectedErrors, errorList));
+        }
+
+        /**
+         * @brief Тест 3: Одна переменная.
+         * @details Проверяет разбор имени переменной из букв и цифр.
+         */
+        TEST_METHOD(Test3_SingleVariable)
+        {
+            std::set<Error> errorList;
+            std::vector<Token> result = tokenize("abc12", errorList);
+
+            std::vector<Token> expected = { Token(TokenType::Variable, "abc12", 1) };
+
+            Assert::IsTrue(compareTokenVectors(expected, result));
+            Assert::IsTrue(errorList.empty());
+        }
+
+        /**
+         * @brief Тест 4: Все операции.
+         * @details Проверяет распознавание всех поддерживаемых операций и нумерацию позиций токенов.
+         */
+        TEST_METHOD(Test4_AllOperations)
+        {
+            std::set<Error> errorList;
+            std::vector<Token> result = tokenize("a ! & | > ~", errorList);
+
+            std::vector<Token> expected = {
+                Token(TokenType::Variable, "a", 1),
+                Token(TokenType::Not, "!", 2),
+                Token(TokenType::And, "&", 3),
+                Token(TokenType::Or, "|", 4),
+                Token(TokenType::Implication, ">", 5),
+                Token(TokenType::Equivalence, "~", 6)
+            };
+
+            Assert::IsTrue(compareTokenVectors(expected, result));
+            Assert::IsTrue(errorList.empty());
+        }
+
+        /**
+         * @brief Тест 5: Несколько разделителей подряд.
+         * @details Проверяет, что последовательности разделителей не влияют на позиции токенов.
+         */
+        TEST_METHOD(Test5_MultipleSeparators)
+        {
+            std::set<Error> errorList;
+            std::vector<Token> result = tokenize("  a \t\t b\r\n&  ", errorList);
+
+            std::vector<Token> expected = {
+                Token(TokenType::Variable, "a", 1),
+                Token(TokenType::Variable, "b", 2),
+                Token(TokenType::And, "&", 3)
+            };
+
+            Assert::IsTrue(compareTokenVectors(expected, result));
+            Assert::IsTrue(errorList.empty());
+        }
+
+        /**
+         * @brief Тест 6: Имя переменной начинается с цифры.
+         * @details Проверяет ошибку invalidVariableName с позицией токена.
+         */
+        TEST_METHOD(Test6_VariableStartsWithDigit)
+        {
+            std::set<Error> errorList;
+            std::vector<Token> result = tokenize("a 1b &", errorList);
+
+            std::set<Error> expectedErrors = { Error(Error::invalidVariableName, 2) };
+
+            Assert::IsTrue(compareErrorSets(expectedErrors, errorList));
+        }
+
+        /**
+         * @brief Тест 7: Недопустимый символ в имени переменной.
+         * @details Проверяет ошибку invalidVariableChar для имени с символом подчеркивания.
+         */
+        TEST_METHOD(Test7_InvalidVariableChar)
+        {
+            std::set<Error> errorList;
+            std::vector<Token> result = tokenize("a_b c &", errorList);
+
+            std::set<Error> expectedErrors = { Error(Error::invalidVariableChar, 1) };
+
+            Assert::IsTrue(compareErrorSets(expectedErrors, errorList));
+        }
+
+        /**
+         * @brief Тест 8: Операция, слитная с операндом.
+         * @details Проверяет, что токены разделяются только пробельными символами.
+         */
+        TEST_METHOD(Test8_OperationJoinedWithOperand)
+        {
+            std::set<Error> errorList;
+            std::vector<Token> result = tokenize("a b&", errorList);
+
+            std::vector<Token> expected = { Token(TokenType::Variable, "a", 1) };
+            std::set<Error> expectedErrors = { Error(Error::invalidVariableChar, 2) };
+
+            Assert::IsTrue(compareTokenVectors(expected, result));
+            Assert::IsTrue(compareErrorSets(expectedErrors, errorList));
+        }
+
+        /**
+         * @brief Тест 9: Неподдерживаемые операции.
+         * @details Проверяет ошибку unsupportedOperation для неизвестного символа и для повторенной операции.
+         */
+        TEST_METHOD(Test9_UnsupportedOperation)
+        {
+            std::set<Error> errorList;
+            std::vector<Token> result = tokenize("a b + !! &", errorList);
+
+            std::set<Error> expectedErrors = {
+                Error(Error::unsupportedOperation, 3),
+                Error(Error::unsupportedOperation, 4)
+            };
+
+            Assert::IsTrue(compareErrorSets(expectedErrors, errorList));
+        }
+
+        /**
+         * @brief Тест 10: Символы вне ASCII.
+         * @details Проверяет, что кириллические буквы не считаются буквами имени переменной.
+         */
+        TEST_METHOD(Test10_NonAsciiCharacters)
+        {
+            std::set<Error> errorList;
+            std::vector<Token> result = tokenize("\xD0\xB0 a\xD0\xB1", errorList);
+
+            std::set<Error> expectedErrors = {
+                Error(Error::unsupportedOperation, 1),
+                Error(Error::invalidVariableChar, 2)
+            };
+
+            Assert::IsTrue(compareErrorSets(expectedErrors, errorList));
+        }
+
+        /**
+         * @brief Тест 11: Несколько ошибок в одной строке.
+         * @details Проверяет, что все ошибки собираются за один проход с верными позициями.
+         */
+        TEST_METHOD(Test11_MultipleErrors)
+        {
+            std::set<Error> errorList;
+            std::vector<Token> result = tokenize("9a b c$ & ?", errorList);
+
+            std::vector<Token> expected = {
+                Token(TokenType::Variable, "b", 2),
+                Token(TokenType::And, "&", 4)
+            };
+            std::set<Error> expectedErrors = {
+                Error(Error::invalidVariableName, 1),
+                Error(Error::invalidVariableChar, 3),
+                Error(Error::unsupportedOperation, 5)
+            };
+
+            Assert::IsTrue(compareTokenVectors(expected, result));
+            Assert::IsTrue(compareErrorSets(expectedErrors, errorList));
+        }
+
+        /**
+         * @brief Тест 12: Интернирование имен переменных.
+         * @details Проверяет, что одинаковые имена получают один идентификатор, а разные — разные.
+         */
+        TEST_METHOD(Test12_VariablesAreInterned)
+        {
+            std::set<Error> errorList;
+            std::vector<Token> result = tokenize("alpha beta | alpha &", errorList);
+
+            Assert::AreEqual(static_cast<size_t>(5), result.size());
+            Assert::IsTrue(result[0].value.id == result[3].value.id);
+            Assert::IsTrue(result[0].value.id != result[1].value.id);
+            Assert::AreEqual(std::string("alpha"), result[3].value.name());
+            Assert::AreEqual(std::string("beta"), result[1].value.name());
+        }
+
+        /**
+         * @brief Тест 13: Токен на границе блоков.
+         * @details Проверяет токен, пересекающий границу 64-байтовых блоков, для каждого поддерживаемого ядра.
+         */
+        TEST_METHOD(Test13_TokenAcrossBlockBoundary)
+        {
+            ScanKernel saved = activeScanKernel();
+            std::string expression = std::string(60, ' ') + "abcdefghij " + std::string(57, ' ') + "k &";
+
+            for (ScanKernel kernel : { scanScalar, scanSse2, scanAvx2 }) {
+                if (!selectScanKernel(kernel)) continue;
+
+                std::set<Error> errorList;
+                std::vector<Token> result = tokenize(expression, errorList);
+
+                std::vector<Token> expected = {
+                    Token(TokenType::Variable, "abcdefghij", 1),
+                    Token(TokenType::Variable, "k", 2),
+                    Token(TokenType::And, "&", 3)
+                };
+
+                Assert::IsTrue(compareTokenVectors(expected, result));
+                Assert::IsTrue(errorList.empty());
+            }
+
+            selectScanKernel(saved);
+        }
+
+        /**
+         * @brief Тест 14: Недопустимый символ во втором блоке длинного имени.
+         * @details Проверяет, что проверка символов имени переменной учитывает все блоки токена.
+         */
+        TEST_METHOD(Test14_InvalidCharInSecondBlock)
+        {
+            ScanKernel saved = activeScanKernel();
+            std::string expression = std::string(100, 'a') + "_" + std::string(40, 'b');
+
+            for (ScanKernel kernel : { scanScalar, scanSse2, scanAvx2 }) {
+                if (!selectScanKernel(kernel)) continue;
+
+                std::set<Error> errorList;
+                std::vector<Token> result = tokenize(expression, errorList);
+
+                std::set<Error> expectedErrors = { Error(Error::invalidVariableChar, 1) };
+
+                Assert::IsTrue(result.empty());
+                Assert::IsTrue(compareErrorSets(expectedErrors, errorList));
+            }
+
+            selectScanKernel(saved);
+        }
+
+        /**
+         * @brief Тест 15: Совпадение результатов всех ядер.
+         * @details Проверяет, что векторные ядра дают те же токены и ошибки, что и побайтовое ядро, на длинной строке.
+         */
+        TEST_METHOD(Test15_AllKernelsAgree)
+        {
+            ScanKernel saved = activeScanKernel();
+            const char alphabet[] = "ab9Z! &|>~\t\n\r_x  ";
+            std::string expression;
+            unsigned state = 12345;
+            for (int i = 0; i < 5000; i++) {
+                state = state * 1103515245 + 12345;
+                expression += alphabet[(state >> 16) % (sizeof(alphabet) - 1)];
+            }
+
+            selectScanKernel(scanScalar);
+            std::set<Error> expectedErrors;
+            std::vector<Token> expected = tokenize(expression, expectedErrors);
+
+            for (ScanKernel kernel : { scanSse2, scanAvx2 }) {
+                if (!selectScanKernel(kernel)) continue;
+
+                std::set<Error> errorList;
+                std::vector<Token> result = tokenize(expression, errorList);
+
+                Assert::IsTrue(compareTokenVectors(expected, result));
+                Assert::IsTrue(compareErrorSets(expectedErrors, errorList));
+            }
+
+            selectScanKernel(saved);
+        }
+
+        /**
+         * @brief Тест 16: Токен в конце полного блока.
+         * @details Проверяет строку длиной ровно 64 байта, последний токен которой заканчивается концом строки.
+         */
+        TEST_METHOD(Test16_TokenEndsAtBlockEnd)
+        {
+            std::string expression = std::string(62, ' ') + "ab";
+            std::set<Error> errorList;
+            std::vector<Token> result = tokenize(expression, errorList);
+
+            std::vector<Token> expected = { Token(TokenType::Variable, "ab", 1) };
+
+            Assert::IsTrue(compareTokenVectors(expected, result));
+            Assert::IsTrue(errorList.empty());
+        }
+    };
+}
\ No newline at end of file
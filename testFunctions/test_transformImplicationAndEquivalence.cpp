@@ -671,5 +671,32 @@ namespace testTransformImplicationAndEquivalence
             delete expected;
         }
 
+        /**
+         * @brief Тест 20: Глубокая цепочка импликаций.
+         * @details Проверяет преобразование цепочки a > (a > (a > ...)) глубиной 200000 без переполнения стека вызовов.
+         */
+        TEST_METHOD(Test20_DeepImplicationChain)
+        {
+            const int depth = 200000;
+            ExpressionNode* input = new ExpressionNode(Variable, "b");
+            for (int i = 0; i < depth; ++i) {
+                input = new ExpressionNode(Implication, new ExpressionNode(Variable, "a"), input);
+            }
+
+            transformImplicationAndEquivalence(input);
+
+            // Каждая импликация заменена на !a | ...
+            int count = 0;
+            const ExpressionNode* node = input;
+            while (node->type == Or) {
+                Assert::IsTrue(node->left->type == Not && node->left->right->type == Variable);
+                node = node->right;
+                count++;
+            }
+            Assert::AreEqual(depth, count);
+            Assert::IsTrue(node->type == Variable);
+
+            delete input;
+        }
     };
 }
\ No newline at end of file
@@ -0,0 +1,143 @@
+/**
+ * @file test_truthTable.cpp
+ * @brief Юнит-тесты для построения таблиц истинности операциями над битовыми векторами.
+ */
+
+#include "pch.h"
+#include "CppUnitTest.h"
+#include "../simpleLogicExpression/functions.h"
+#include "../simpleLogicExpression/objects.h"
+#include "testFunctions.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace testTruthTable
+{
+    /**
+     * @brief Создает выражение в постфиксной записи: цепочку эквивалентностей и импликаций над x0..x(count-1),
+     * соединенную конъюнкцией с отрицанием дизъюнкции первых переменных.
+     * @param count Количество переменных.
+     * @return Выражение в постфиксной записи.
+     */
+    static std::string makeExpression(int count) {
+        std::string expression = "x0";
+        for (int i = 1; i < count; i++) {
+            expression += " x" + std::to_string(i) + (i % 3 == 0 ? " >" : " ~");
+        }
+        return expression + " x0 x1 | ! |";
+    }
+
+    /**
+     * @brief Вычисляет выражение makeExpression на наборе значений.
+     * @param count Количество переменных.
+     * @param index Номер набора: значение переменной xi — бит i.
+     * @return Значение выражения.
+     */
+    static bool evaluateExpression(int count, uint64_t index) {
+        bool value = index & 1;
+        for (int i = 1; i < count; i++) {
+            bool x = (index >> i) & 1;
+            value = i % 3 == 0 ? (!value || x) : (value == x);
+        }
+        return value || !((index & 1) || ((index >> 1) & 1));
+    }
+
+    TEST_CLASS(testTruthTable)
+    {
+    public:
+        /**
+         * @brief Тест 1: Таблица истинности трех переменных.
+         * @details Проверяет значения и количество выполняющих наборов выражения a & b || c.
+         */
+        TEST_METHOD(Test1_SmallTable)
+        {
+            TruthTable table;
+            std::set<Error> errors;
+            Assert::IsTrue(processTruthTable("a b & c |", table, errors));
+
+            Assert::AreEqual(static_cast<size_t>(3), table.variables.size());
+            Assert::AreEqual(std::string("a"), table.variables[0].name());
+            Assert::AreEqual(static_cast<uint64_t>(0xF8), table.words[0]);
+            Assert::AreEqual(static_cast<uint64_t>(5), table.models);
+            Assert::IsTrue(table.value(7));
+            Assert::IsFalse(table.value(2));
+        }
+
+        /**
+         * @brief Тест 2: Лишние биты единственного слова.
+         * @details Проверяет, что у таблицы меньше чем от 6 переменных биты после последнего набора равны нулю.
+         */
+        TEST_METHOD(Test2_ShortTableIsMasked)
+        {
+            TruthTable table;
+            std::set<Error> errors;
+            Assert::IsTrue(processTruthTable("a || !a & b", table, errors, syntaxInfix));
+
+            Assert::AreEqual(static_cast<uint64_t>(0xE), table.words[0]);
+            Assert::AreEqual(static_cast<uint64_t>(3), table.models);
+        }
+
+        /**
+         * @brief Тест 3: Таблица из нескольких фрагментов.
+         * @details Проверяет все наборы таблицы 22 переменных, которая вычисляется несколькими фрагментами.
+         */
+        TEST_METHOD(Test3_ChunkedTable)
+        {
+            const int count = 22;
+            TruthTable table;
+            std::set<Error> errors;
+            Assert::IsTrue(processTruthTable(makeExpression(count), table, errors));
+            Assert::AreEqual(static_cast<size_t>(1) << (count - 6), table.words.size());
+
+            uint64_t models = 0;
+            for (uint64_t index = 0; index < table.size(); index++) {
+                bool expected = evaluateExpression(count, index);
+                if (table.value(index) != expected) {
+                    Assert::Fail(L"Значение таблицы не совпадает с вычисленным");
+                }
+                models += expected;
+            }
+            Assert::AreEqual(models, table.models);
+        }
+
+        /**
+         * @brief Тест 4: Совпадение ядер.
+         * @details Проверяет, что операции AVX2 (если поддерживаются) дают ту же таблицу, что и 64-битные слова.
+         */
+        TEST_METHOD(Test4_KernelsAgree)
+        {
+            ScanKernel saved = activeScanKernel();
+            std::string expression = makeExpression(20) + " x5 x17 & x3 ! ~ &";
+            std::set<Error> errors;
+
+            Assert::IsTrue(selectScanKernel(scanScalar));
+            TruthTable scalar;
+            Assert::IsTrue(processTruthTable(expression, scalar, errors));
+
+            if (selectScanKernel(scanAvx2)) {
+                TruthTable vector;
+                Assert::IsTrue(processTruthTable(expression, vector, errors));
+                Assert::IsTrue(scalar.words == vector.words);
+                Assert::AreEqual(scalar.models, vector.models);
+            }
+            selectScanKernel(saved);
+        }
+
+        /**
+         * @brief Тест 5: Слишком много переменных.
+         * @details Проверяет, что для 33 переменных таблица не строится и добавляется ошибка tooManyVariables.
+         */
+        TEST_METHOD(Test5_TooManyVariables)
+        {
+            std::string expression = "x0";
+            for (int i = 1; i < 33; i++) expression += " x" + std::to_string(i) + " &";
+
+            TruthTable table;
+            std::set<Error> errors;
+            Assert::IsFalse(processTruthTable(expression, table, errors));
+            Assert::AreEqual(static_cast<size_t>(1), errors.size());
+            Assert::IsTrue(errors.begin()->type == Error::tooManyVariables);
+            Assert::IsTrue(table.words.empty());
+        }
+    };
+}
\ No newline at end of file
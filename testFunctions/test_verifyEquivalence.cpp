@@ -0,0 +1,173 @@
+/**
+ * @file test_verifyEquivalence.cpp
+ * @brief Юнит-тесты для проверки равносильности исходного и преобразованного выражений.
+ */
+
+#include "pch.h"
+#include "CppUnitTest.h"
+#include "../simpleLogicExpression/functions.h"
+#include "../simpleLogicExpression/objects.h"
+#include "testFunctions.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace testVerifyEquivalence
+{
+    /**
+     * @brief Разбирает выражение в инфиксной записи.
+     * @param expression Выражение.
+     * @return Указатель на корень дерева.
+     */
+    static ExpressionNode* parse(const std::string& expression) {
+        std::set<Error> errors;
+        ExpressionNode* tree = parseInfixExpression(expression, errors);
+        Assert::IsTrue(errors.empty());
+        return tree;
+    }
+
+    /**
+     * @brief Вычисляет значение дерева на наборе значений переменных.
+     * @param node Указатель на корень дерева.
+     * @param values Значения переменных.
+     * @return Значение выражения.
+     */
+    static bool evaluate(const ExpressionNode* node, const std::vector<std::pair<Symbol, bool>>& values) {
+        switch (node->type) {
+        case TokenType::Variable:
+            for (const auto& value : values) {
+                if (value.first == node->value) return value.second;
+            }
+            return false;
+        case TokenType::Not: return !evaluate(node->right, values);
+        case TokenType::And: return evaluate(node->left, values) && evaluate(node->right, values);
+        case TokenType::Or: return evaluate(node->left, values) || evaluate(node->right, values);
+        case TokenType::Implication: return !evaluate(node->left, values) || evaluate(node->right, values);
+        default: return evaluate(node->left, values) == evaluate(node->right, values);
+        }
+    }
+
+    /**
+     * @brief Проверяет пару выражений и освобождает деревья.
+     * @param first Первое выражение в инфиксной записи.
+     * @param second Второе выражение в инфиксной записи.
+     * @param counterexample Контрпример при различии.
+     * @return true, если выражения равносильны.
+     */
+    static bool verify(const std::string& first, const std::string& second, std::vector<std::pair<Symbol, bool>>& counterexample) {
+        ExpressionNode* firstTree = parse(first);
+        ExpressionNode* secondTree = parse(second);
+        bool equivalent = verifyEquivalence(firstTree, secondTree, counterexample);
+        if (!equivalent) {
+            Assert::AreNotEqual(evaluate(firstTree, counterexample), evaluate(secondTree, counterexample));
+        }
+        delete firstTree;
+        delete secondTree;
+        return equivalent;
+    }
+
+    /**
+     * @brief Создает конъюнкцию переменных x0..x(count-1), вложенную вправо.
+     * @param count Количество переменных.
+     * @return Выражение в инфиксной записи.
+     */
+    static std::string makeConjunction(int count) {
+        std::string expression = "x0";
+        for (int i = 1; i < count; i++) expression += " & (x" + std::to_string(i);
+        expression += std::string(count - 1, ')');
+        return expression;
+    }
+
+    TEST_CLASS(testVerifyEquivalence)
+    {
+    public:
+        /**
+         * @brief Тест 1: Равносильность после преобразований.
+         * @details Проверяет, что раскрытие импликации и эквивалентности и законы де Моргана признаются равносильными.
+         */
+        TEST_METHOD(Test1_RewritesAreEquivalent)
+        {
+            std::vector<std::pair<Symbol, bool>> counterexample;
+            Assert::IsTrue(verify("!(a -> b)", "a & !b", counterexample));
+            Assert::IsTrue(verify("!(a ~ b)", "(!a || !b) & (a || b)", counterexample));
+            Assert::IsTrue(verify("!!(c & d)", "d & c", counterexample));
+            Assert::IsTrue(counterexample.empty());
+        }
+
+        /**
+         * @brief Тест 2: Равносильность, не сводящаяся к перестановкам.
+         * @details Проверяет дистрибутивность и поглощение, доказываемые полной таблицей истинности.
+         */
+        TEST_METHOD(Test2_TruthTableProof)
+        {
+            std::vector<std::pair<Symbol, bool>> counterexample;
+            Assert::IsTrue(verify("a & (b || c)", "a & b || a & c", counterexample));
+            Assert::IsTrue(verify("p || p & q", "p", counterexample));
+            Assert::IsTrue(verify("v0 ~ v1 ~ v2 ~ v3 ~ v4 ~ v5 ~ v6 ~ v7", "v7 ~ (v6 ~ (v5 ~ (v4 ~ (v3 ~ (v2 ~ (v1 ~ v0))))))", counterexample));
+        }
+
+        /**
+         * @brief Тест 3: Контрпример.
+         * @details Проверяет, что для неравносильных выражений возвращается набор, на котором они различаются.
+         */
+        TEST_METHOD(Test3_Counterexample)
+        {
+            std::vector<std::pair<Symbol, bool>> counterexample;
+            Assert::IsFalse(verify("a & b", "a || b", counterexample));
+            Assert::AreEqual(static_cast<size_t>(2), counterexample.size());
+
+            Assert::IsFalse(verify("a -> b", "b -> a", counterexample));
+        }
+
+        /**
+         * @brief Тест 4: Различие на единственном наборе среди 2^30.
+         * @details Проверяет, что различие, которое случайные наборы не находят, обнаруживается диаграммами.
+         */
+        TEST_METHOD(Test4_ManyVariables)
+        {
+            std::string conjunction = makeConjunction(30);
+            std::vector<std::pair<Symbol, bool>> counterexample;
+            Assert::IsFalse(verify(conjunction, "x0 & !x0", counterexample));
+            Assert::AreEqual(static_cast<size_t>(30), counterexample.size());
+            for (const auto& value : counterexample) Assert::IsTrue(value.second);
+
+            Assert::IsTrue(verify(conjunction + " & (x0 || y)", conjunction, counterexample));
+        }
+
+        /**
+         * @brief Тест 5: Глубина стека программы.
+         * @details Проверяет, что для цепочки, вложенной вправо, стек программы не растет с длиной цепочки.
+         */
+        TEST_METHOD(Test5_ProgramStackDepth)
+        {
+            ExpressionNode* tree = parse(makeConjunction(1000));
+            BitVariables variables;
+            BitProgram program;
+            compileBitProgram(tree, variables, program);
+
+            Assert::AreEqual(static_cast<size_t>(1999), program.code.size());
+            Assert::AreEqual(static_cast<size_t>(2), program.stackDepth);
+            Assert::AreEqual(static_cast<size_t>(1000), variables.size());
+            delete tree;
+        }
+
+        /**
+         * @brief Тест 6: Обработка выражения с проверкой.
+         * @details Проверяет, что проверка не меняет результат ни в одном представлении дерева.
+         */
+        TEST_METHOD(Test6_ProcessExpressionWithVerify)
+        {
+            PipelineEngine engines[] = { engineTree, engineFlat, engineDag, engineEdge };
+            ProgramOptions options;
+            options.verify = true;
+            for (PipelineEngine engine : engines) {
+                std::set<Error> errors;
+                std::string input, result;
+                options.engine = engine;
+                Assert::IsTrue(processExpression("a b ~ c > !", input, result, errors, options));
+                Assert::IsTrue(errors.empty());
+                Assert::AreEqual(std::string("!((a ~ b) -> c)"), input);
+                Assert::AreEqual(std::string("(a & b || !a & !b) & !c"), result);
+            }
+        }
+    };
+}
\ No newline at end of file